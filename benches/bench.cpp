@@ -10,10 +10,34 @@
 #define _CRT_SECURE_NO_WARNINGS // [LM] Say the line!
 #endif
 
+#include "krbitset.h"
+#include "krcpu.h"
+#include "krcrc.h"
+#include "krcurve.h"
+#include "krdist.h"
+#include "krhash.h"
+#include "krintern.h"
+#include "krmap.h"
+#include "krpool.h"
+#include "krrand.h"
+#include "krrank.h"
+#include "krring.h"
+#include "krserial.h"
+#include "krsimd.h"
 #include "krstr.h"
+#include "krstrbuf.h"
+#include "krvec.h"
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 //------------------------------------------------------------------------------
 
 static void Bench_strcpy(benchmark::State &state)
@@ -112,4 +136,1709 @@ static void Bench_kr_strnlen(benchmark::State &state)
 
 BENCHMARK(Bench_kr_strnlen);
 
+//------------------------------------------------------------------------------
+
+// String of state.range(0) bytes followed by a null terminator.
+static std::vector<char> MakeString(benchmark::State &state)
+{
+    std::vector<char> buffer(static_cast<size_t>(state.range(0)) + 1, 'x');
+    buffer.back() = '\0';
+    return buffer;
+}
+
+static void Bench_strlen_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = strlen(buffer.data());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_strlen_N)->RangeMultiplier(4)->Range(1, 64 << 10);
+
+static void Bench_kr_strlen_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = kr_strlen(buffer.data());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_strlen_N)->RangeMultiplier(4)->Range(1, 64 << 10);
+
+static void Bench_kr_strlen_swar_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = kr_strlen_swar(buffer.data());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_strlen_swar_N)->RangeMultiplier(4)->Range(1, 64 << 10);
+
+static void Bench_kr_strnlen_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = kr_strnlen(buffer.data(), buffer.size());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_strnlen_N)->RangeMultiplier(4)->Range(1, 64 << 10);
+
+static void Bench_kr_strnlen_swar_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = kr_strnlen_swar(buffer.data(), buffer.size());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_strnlen_swar_N)->RangeMultiplier(4)->Range(1, 64 << 10);
+
+static void Bench_kr_simd_strlen_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = kr_simd_strlen(buffer.data());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_simd_strlen_N)->RangeMultiplier(4)->Range(1, 64 << 10)->Arg(1 << 20);
+
+//------------------------------------------------------------------------------
+
+static void Bench_strspn_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = strspn(buffer.data(), "wxyz");
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_strspn_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_strspn_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = kr_strspn(buffer.data(), "wxyz");
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_strspn_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_simd_strspn_N(benchmark::State &state)
+{
+    std::vector<char> buffer = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = kr_simd_strspn(buffer.data(), "wxyz");
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_simd_strspn_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_strcmp_N(benchmark::State &state)
+{
+    std::vector<char> lhs = MakeString(state);
+    std::vector<char> rhs = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs.data());
+        benchmark::DoNotOptimize(rhs.data());
+        int r = strcmp(lhs.data(), rhs.data());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_strcmp_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_strcmp_N(benchmark::State &state)
+{
+    std::vector<char> lhs = MakeString(state);
+    std::vector<char> rhs = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs.data());
+        benchmark::DoNotOptimize(rhs.data());
+        int r = kr_strcmp(lhs.data(), rhs.data());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_strcmp_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_simd_strcmp_N(benchmark::State &state)
+{
+    std::vector<char> lhs = MakeString(state);
+    std::vector<char> rhs = MakeString(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs.data());
+        benchmark::DoNotOptimize(rhs.data());
+        int r = kr_simd_strcmp(lhs.data(), rhs.data());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_simd_strcmp_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+//------------------------------------------------------------------------------
+
+static void Bench_kr_strdup_key(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        char *r = kr_strdup("user:12345:session");
+        benchmark::DoNotOptimize(r);
+        KR_FREE(r);
+    }
+}
+
+BENCHMARK(Bench_kr_strdup_key);
+
+static void Bench_kr_strbuf_key(benchmark::State &state)
+{
+    struct kr_strbuf_s buf;
+    kr_strbuf_init(&buf);
+    for (auto _ : state)
+    {
+        kr_strbuf_clear(&buf);
+        bool r = kr_strbuf_append(&buf, "user:") && kr_strbuf_append(&buf, "12345") &&
+                 kr_strbuf_appendch(&buf, ':') && kr_strbuf_append(&buf, "session");
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(kr_strbuf_cstr(&buf));
+    }
+    kr_strbuf_free(&buf);
+}
+
+BENCHMARK(Bench_kr_strbuf_key);
+
+//------------------------------------------------------------------------------
+
+// Allocate a burst of objects, then free them in a scattered order, like
+// connections and messages coming and going.
+static const size_t STORM_COUNT = 1024;
+
+static size_t StormIndex(size_t i)
+{
+    return (i * 619) % STORM_COUNT;
+}
+
+static void Bench_malloc_storm(benchmark::State &state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    std::vector<void *> ptrs(STORM_COUNT);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < STORM_COUNT; i++)
+        {
+            ptrs[i] = malloc(size);
+            benchmark::DoNotOptimize(ptrs[i]);
+        }
+        for (size_t i = 0; i < STORM_COUNT; i++)
+        {
+            free(ptrs[StormIndex(i)]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * STORM_COUNT);
+}
+
+BENCHMARK(Bench_malloc_storm)->RangeMultiplier(2)->Range(16, 256);
+
+static void Bench_kr_pool_storm(benchmark::State &state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    std::vector<void *> ptrs(STORM_COUNT);
+    struct kr_pool_s pool;
+    kr_pool_init(&pool, size, 256);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < STORM_COUNT; i++)
+        {
+            ptrs[i] = kr_pool_alloc(&pool);
+            benchmark::DoNotOptimize(ptrs[i]);
+        }
+        for (size_t i = 0; i < STORM_COUNT; i++)
+        {
+            kr_pool_free(&pool, ptrs[StormIndex(i)]);
+        }
+    }
+    kr_pool_destroy(&pool);
+    state.SetItemsProcessed(state.iterations() * STORM_COUNT);
+}
+
+BENCHMARK(Bench_kr_pool_storm)->RangeMultiplier(2)->Range(16, 256);
+
+static void Bench_kr_pool_cache_storm(benchmark::State &state)
+{
+    static KR_THREAD struct kr_pool_cache_s cache;
+    const size_t size = static_cast<size_t>(state.range(0));
+    std::vector<void *> ptrs(STORM_COUNT);
+    struct kr_pool_s pool;
+    kr_pool_init(&pool, size, 256);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < STORM_COUNT; i++)
+        {
+            ptrs[i] = kr_pool_cache_alloc(&cache, &pool);
+            benchmark::DoNotOptimize(ptrs[i]);
+        }
+        for (size_t i = 0; i < STORM_COUNT; i++)
+        {
+            kr_pool_cache_free(&cache, &pool, ptrs[StormIndex(i)]);
+        }
+    }
+    kr_pool_cache_flush(&cache, &pool);
+    kr_pool_destroy(&pool);
+    state.SetItemsProcessed(state.iterations() * STORM_COUNT);
+}
+
+BENCHMARK(Bench_kr_pool_cache_storm)->RangeMultiplier(2)->Range(16, 256);
+
+//------------------------------------------------------------------------------
+
+static void Bench_kr_load_u32be_N(benchmark::State &state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<unsigned char> src(n * 4, 0x5a);
+    std::vector<uint32_t> dest(n);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            dest[i] = kr_load_u32be(&src[i * 4]);
+        }
+        benchmark::DoNotOptimize(dest.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 4);
+}
+
+BENCHMARK(Bench_kr_load_u32be_N)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_load_u32be_array_N(benchmark::State &state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<unsigned char> src(n * 4, 0x5a);
+    std::vector<uint32_t> dest(n);
+    for (auto _ : state)
+    {
+        kr_load_u32be_array(dest.data(), src.data(), n);
+        benchmark::DoNotOptimize(dest.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 4);
+}
+
+BENCHMARK(Bench_kr_load_u32be_array_N)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_bswap64_array_N(benchmark::State &state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    std::vector<uint64_t> arr(n, 0x0102030405060708);
+    for (auto _ : state)
+    {
+        kr_bswap64_array(arr.data(), n);
+        benchmark::DoNotOptimize(arr.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 8);
+}
+
+BENCHMARK(Bench_kr_bswap64_array_N)->Arg(4 << 10)->Arg(1 << 20);
+
+//------------------------------------------------------------------------------
+
+// Small values of unpredictable length, with the occasional large one, like
+// a typical wire format.
+static std::vector<uint64_t> MakeVarintValues(size_t n)
+{
+    std::vector<uint64_t> values(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const uint64_t h = (i + 1) * 0x9E3779B97F4A7C15;
+        values[i] = (i % 16 == 0) ? h >> (h % 64) : h >> (43 + h % 21);
+    }
+    return values;
+}
+
+static void Bench_kr_load_uleb128_array(benchmark::State &state)
+{
+    const size_t n = 4096;
+    std::vector<uint64_t> values = MakeVarintValues(n);
+    std::vector<unsigned char> buf(n * KR_LEB128_MAXLEN);
+    size_t len = 0, used = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        len += kr_store_uleb128(&buf[len], values[i]);
+    }
+    for (auto _ : state)
+    {
+        size_t r = kr_load_uleb128_array(values.data(), n, buf.data(), len, &used);
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_load_uleb128_array);
+
+static void Bench_kr_load_pvarint_array(benchmark::State &state)
+{
+    const size_t n = 4096;
+    std::vector<uint64_t> values = MakeVarintValues(n);
+    std::vector<unsigned char> buf(n * KR_PVARINT_MAXLEN);
+    size_t len = 0, used = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        len += kr_store_pvarint(&buf[len], values[i]);
+    }
+    for (auto _ : state)
+    {
+        size_t r = kr_load_pvarint_array(values.data(), n, buf.data(), len, &used);
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_load_pvarint_array);
+
+static void Bench_kr_jsf32_rand(benchmark::State &state)
+{
+    const size_t n = 4096;
+    std::vector<uint32_t> buf(n);
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            buf[i] = kr_jsf32_rand(&ctx);
+        }
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_jsf32_rand);
+
+static void Bench_kr_jsf32_fill(benchmark::State &state)
+{
+    const size_t n = 4096;
+    std::vector<uint32_t> buf(n);
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    for (auto _ : state)
+    {
+        kr_jsf32_fill(&ctx, buf.data(), n);
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_jsf32_fill);
+
+static void Bench_kr_jsf32x8_fill(benchmark::State &state)
+{
+    const size_t n = 4096;
+    const uint32_t seeds[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<uint32_t> buf(n);
+    kr_jsf32x8_ctx_s ctx;
+    kr_jsf32x8_srand(&ctx, seeds);
+    for (auto _ : state)
+    {
+        kr_jsf32x8_fill(&ctx, buf.data(), n);
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_jsf32x8_fill);
+
+static void Bench_kr_jsf64x4_fill(benchmark::State &state)
+{
+    const size_t n = 4096;
+    const uint64_t seeds[4] = {1, 2, 3, 4};
+    std::vector<uint64_t> buf(n);
+    kr_jsf64x4_ctx_s ctx;
+    kr_jsf64x4_srand(&ctx, seeds);
+    for (auto _ : state)
+    {
+        kr_jsf64x4_fill(&ctx, buf.data(), n);
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_jsf64x4_fill);
+
+static void Bench_kr_jsf32_rand_uniform(benchmark::State &state)
+{
+    const size_t n = 4096;
+    const uint32_t bound = uint32_t(state.range(0));
+    std::vector<uint32_t> buf(n);
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            buf[i] = kr_jsf32_rand_uniform(&ctx, bound);
+        }
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_jsf32_rand_uniform)->Arg(6)->Arg(1000)->Arg(3000000000);
+
+static void Bench_kr_jsf64_rand_uniform(benchmark::State &state)
+{
+    const size_t n = 4096;
+    const uint64_t bound = uint64_t(state.range(0));
+    std::vector<uint64_t> buf(n);
+    kr_jsf64_ctx_s ctx;
+    kr_jsf64_srand(&ctx, 1993);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            buf[i] = kr_jsf64_rand_uniform(&ctx, bound);
+        }
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_jsf64_rand_uniform)->Arg(6)->Arg(1000)->Arg(3000000000);
+
+static void Bench_kr_dist_normal(benchmark::State &state)
+{
+    const size_t n = 4096;
+    std::vector<double> buf(n);
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            buf[i] = kr_dist_normal(&ctx);
+        }
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_dist_normal);
+
+static std::vector<double> MakeWeights(size_t n)
+{
+    std::vector<double> weights(n);
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    for (size_t i = 0; i < n; i++)
+    {
+        weights[i] = kr_dist_double(&ctx);
+    }
+    return weights;
+}
+
+static void Bench_WeightedLinear(benchmark::State &state)
+{
+    const size_t n = size_t(state.range(0));
+    std::vector<double> weights = MakeWeights(n);
+    std::vector<uint32_t> cumulative(n);
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    uint32_t total = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        total += uint32_t(weights[i] * 1000000);
+        cumulative[i] = total;
+    }
+    for (auto _ : state)
+    {
+        uint32_t r = kr_jsf32_rand(&ctx) % total, i = 0;
+        while (cumulative[i] <= r)
+        {
+            i++;
+        }
+        benchmark::DoNotOptimize(i);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(Bench_WeightedLinear)->Arg(16)->Arg(1024);
+
+static void Bench_kr_dist_alias_sample(benchmark::State &state)
+{
+    const size_t n = size_t(state.range(0));
+    std::vector<double> weights = MakeWeights(n);
+    kr_dist_alias_s alias;
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    if (!kr_dist_alias_init(&alias, weights.data(), n))
+    {
+        state.SkipWithError("kr_dist_alias_init failed");
+        return;
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kr_dist_alias_sample(&alias, &ctx));
+    }
+    state.SetItemsProcessed(state.iterations());
+    kr_dist_alias_free(&alias);
+}
+
+BENCHMARK(Bench_kr_dist_alias_sample)->Arg(16)->Arg(1024);
+
+static void Bench_kr_dist_shuffle(benchmark::State &state)
+{
+    const size_t n = 4096;
+    std::vector<uint32_t> buf(n);
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    for (auto _ : state)
+    {
+        kr_dist_shuffle(&ctx, buf.data(), n, sizeof(uint32_t));
+        benchmark::DoNotOptimize(buf.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_dist_shuffle);
+
+static std::vector<uint64_t> MakeBitVector(size_t n)
+{
+    std::vector<uint64_t> words(n);
+    kr_jsf64_ctx_s ctx;
+    kr_jsf64_srand(&ctx, 1993);
+    for (size_t i = 0; i < n; i++)
+    {
+        words[i] = kr_jsf64_rand(&ctx);
+    }
+    return words;
+}
+
+static void Bench_PopcntLoop(benchmark::State &state)
+{
+    std::vector<uint64_t> words = MakeBitVector(16384);
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < words.size(); i++)
+        {
+            total += uint64_t(kr_popcnt64(words[i]));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(state.iterations() * words.size() * sizeof(uint64_t));
+}
+
+BENCHMARK(Bench_PopcntLoop);
+
+static void Bench_kr_popcount_array(benchmark::State &state)
+{
+    std::vector<uint64_t> words = MakeBitVector(16384);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kr_popcount_array(words.data(), words.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * words.size() * sizeof(uint64_t));
+}
+
+BENCHMARK(Bench_kr_popcount_array);
+
+static void Bench_kr_rank1(benchmark::State &state)
+{
+    std::vector<uint64_t> words = MakeBitVector(1 << 20);
+    kr_rank_s rs;
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    if (!kr_rank_init(&rs, words.data(), words.size() * 64))
+    {
+        state.SkipWithError("kr_rank_init failed");
+        return;
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kr_rank1(&rs, kr_jsf32_rand(&ctx) % rs.nbits));
+    }
+    state.SetItemsProcessed(state.iterations());
+    kr_rank_free(&rs);
+}
+
+BENCHMARK(Bench_kr_rank1);
+
+static void Bench_kr_select1(benchmark::State &state)
+{
+    std::vector<uint64_t> words = MakeBitVector(1 << 20);
+    kr_rank_s rs;
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    if (!kr_rank_init(&rs, words.data(), words.size() * 64))
+    {
+        state.SkipWithError("kr_rank_init failed");
+        return;
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kr_select1(&rs, kr_jsf32_rand(&ctx) % rs.ones));
+    }
+    state.SetItemsProcessed(state.iterations());
+    kr_rank_free(&rs);
+}
+
+BENCHMARK(Bench_kr_select1);
+
+static void MakeSparseBitset(kr_bitset_s *bs, size_t nbits)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    kr_bitset_init(bs);
+    if (!kr_bitset_resize(bs, nbits))
+    {
+        abort();
+    }
+    for (size_t i = 0; i < nbits / 64; i++)
+    {
+        kr_bitset_set(bs, kr_jsf32_rand_uniform(&ctx, uint32_t(nbits)));
+    }
+}
+
+static void Bench_BitsetTestEach(benchmark::State &state)
+{
+    kr_bitset_s bs;
+    MakeSparseBitset(&bs, 1 << 20);
+    for (auto _ : state)
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < bs.nbits; i++)
+        {
+            if (kr_bitset_test(&bs, i))
+            {
+                total += i;
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    kr_bitset_free(&bs);
+}
+
+BENCHMARK(Bench_BitsetTestEach);
+
+static void Bench_kr_bitset_iter(benchmark::State &state)
+{
+    kr_bitset_s bs;
+    MakeSparseBitset(&bs, 1 << 20);
+    for (auto _ : state)
+    {
+        kr_bitset_iter_s it;
+        size_t total = 0, pos = 0;
+        kr_bitset_iter_init(&it, &bs);
+        while (kr_bitset_iter_next(&it, &pos))
+        {
+            total += pos;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    kr_bitset_free(&bs);
+}
+
+BENCHMARK(Bench_kr_bitset_iter);
+
+static void Bench_kr_bitset_next_clear(benchmark::State &state)
+{
+    kr_bitset_s bs;
+    MakeSparseBitset(&bs, 1 << 20);
+    kr_bitset_setall(&bs);
+    kr_bitset_clear(&bs, bs.nbits - 1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kr_bitset_next_clear(&bs, 0));
+    }
+    kr_bitset_free(&bs);
+}
+
+BENCHMARK(Bench_kr_bitset_next_clear);
+
+static void Bench_kr_bitset_and_words(benchmark::State &state)
+{
+    std::vector<uint64_t> a = MakeBitVector(4096), b = MakeBitVector(4096);
+    for (auto _ : state)
+    {
+        kr_bitset_and_words(a.data(), b.data(), a.size());
+        benchmark::DoNotOptimize(a.data());
+    }
+    state.SetBytesProcessed(state.iterations() * a.size() * sizeof(uint64_t));
+}
+
+BENCHMARK(Bench_kr_bitset_and_words);
+
+// Each of these runs a dispatched kernel as if the CPU only had the features
+// in the argument, so baseline and dispatched paths can be compared.
+
+static void Bench_kr_popcount_array_Features(benchmark::State &state)
+{
+    const unsigned long features = kr_cpu_features();
+    std::vector<uint64_t> words = MakeBitVector(16384);
+    kr_cpu_set_features(features & static_cast<unsigned long>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kr_popcount_array(words.data(), words.size()));
+    }
+    kr_cpu_set_features(features);
+    state.SetBytesProcessed(state.iterations() * words.size() * sizeof(uint64_t));
+}
+
+BENCHMARK(Bench_kr_popcount_array_Features)->Arg(0)->Arg(KR_CPU_POPCNT)->Arg(KR_CPU_AVX2);
+
+static void Bench_kr_bswap64_array_Features(benchmark::State &state)
+{
+    const unsigned long features = kr_cpu_features();
+    std::vector<uint64_t> arr(4 << 10, 0x0102030405060708);
+    kr_cpu_set_features(features & static_cast<unsigned long>(state.range(0)));
+    for (auto _ : state)
+    {
+        kr_bswap64_array(arr.data(), arr.size());
+        benchmark::DoNotOptimize(arr.data());
+    }
+    kr_cpu_set_features(features);
+    state.SetBytesProcessed(state.iterations() * arr.size() * 8);
+}
+
+BENCHMARK(Bench_kr_bswap64_array_Features)->Arg(0)->Arg(KR_CPU_AVX2);
+
+static void Bench_kr_simd_strlen_Features(benchmark::State &state)
+{
+    const unsigned long features = kr_cpu_features();
+    std::vector<char> buffer(64 << 10, 'x');
+    buffer.back() = '\0';
+    kr_cpu_set_features(features & static_cast<unsigned long>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        size_t r = kr_simd_strlen(buffer.data());
+        benchmark::DoNotOptimize(r);
+    }
+    kr_cpu_set_features(features);
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(Bench_kr_simd_strlen_Features)->Arg(0)->Arg(KR_CPU_AVX2);
+
+static void Bench_DepositLoop(benchmark::State &state)
+{
+    kr_jsf64_ctx_s ctx;
+    kr_jsf64_srand(&ctx, 1993);
+    std::vector<uint64_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf64_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint64_t v : values)
+        {
+            // Naive Morton encoding, one bit at a time.
+            uint64_t r = 0, m = UINT64_C(0x5555555555555555);
+            for (uint64_t bb = 1; m != 0; bb += bb)
+            {
+                if (v & bb)
+                {
+                    r |= m & (~m + 1);
+                }
+                m &= m - 1;
+            }
+            total += r;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_DepositLoop);
+
+static void Bench_kr_bit_deposit64(benchmark::State &state)
+{
+    kr_jsf64_ctx_s ctx;
+    kr_jsf64_srand(&ctx, 1993);
+    std::vector<uint64_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf64_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint64_t v : values)
+        {
+            total += kr_bit_deposit64(v, UINT64_C(0x5555555555555555));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_bit_deposit64);
+
+static void Bench_kr_bit_extract64(benchmark::State &state)
+{
+    kr_jsf64_ctx_s ctx;
+    kr_jsf64_srand(&ctx, 1993);
+    std::vector<uint64_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf64_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint64_t v : values)
+        {
+            total += kr_bit_extract64(v, UINT64_C(0x5555555555555555));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_bit_extract64);
+
+static void Bench_kr_pdep64(benchmark::State &state)
+{
+    kr_jsf64_ctx_s ctx;
+    kr_jsf64_srand(&ctx, 1993);
+    std::vector<uint64_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf64_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint64_t v : values)
+        {
+            total += kr_pdep64(v, UINT64_C(0x5555555555555555));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_pdep64);
+
+static void Bench_MortonLoop(benchmark::State &state)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    std::vector<uint32_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf32_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint32_t v : values)
+        {
+            // Naive Morton encoding, one bit at a time.
+            uint32_t r = 0;
+            for (unsigned bit = 0; bit < 16; bit++)
+            {
+                r |= ((v >> bit) & 1) << (bit * 2);
+                r |= ((v >> (bit + 16)) & 1) << (bit * 2 + 1);
+            }
+            total += r;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_MortonLoop);
+
+static void Bench_kr_morton2_encode32(benchmark::State &state)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    std::vector<uint32_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf32_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint32_t v : values)
+        {
+            total += kr_morton2_encode32(uint16_t(v), uint16_t(v >> 16));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_morton2_encode32);
+
+static void Bench_kr_morton2_encode32_table(benchmark::State &state)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    std::vector<uint32_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf32_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint32_t v : values)
+        {
+            total += kr_morton2_encode32_table(uint16_t(v), uint16_t(v >> 16));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_morton2_encode32_table);
+
+static void Bench_kr_morton2_decode32(benchmark::State &state)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    std::vector<uint32_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf32_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint32_t v : values)
+        {
+            uint16_t x, y;
+            kr_morton2_decode32(v, &x, &y);
+            total += x + y;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_morton2_decode32);
+
+static void Bench_kr_morton3_encode32(benchmark::State &state)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    std::vector<uint32_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf32_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint32_t v : values)
+        {
+            total += kr_morton3_encode32(uint16_t(v), uint16_t(v >> 10), uint16_t(v >> 20));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_morton3_encode32);
+
+static void Bench_kr_morton3_encode32_table(benchmark::State &state)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    std::vector<uint32_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf32_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint32_t v : values)
+        {
+            total += kr_morton3_encode32_table(uint16_t(v), uint16_t(v >> 10), uint16_t(v >> 20));
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_morton3_encode32_table);
+
+static void Bench_kr_hilbert2_encode32(benchmark::State &state)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    std::vector<uint32_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf32_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint32_t v : values)
+        {
+            total += kr_hilbert2_encode32(uint16_t(v), uint16_t(v >> 16), 16);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_hilbert2_encode32);
+
+static void Bench_kr_hilbert2_decode32(benchmark::State &state)
+{
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    std::vector<uint32_t> values(1024);
+    for (auto &v : values)
+    {
+        v = kr_jsf32_rand(&ctx);
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (uint32_t v : values)
+        {
+            uint16_t x, y;
+            kr_hilbert2_decode32(v, 16, &x, &y);
+            total += x + y;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+BENCHMARK(Bench_kr_hilbert2_decode32);
+
+static void Bench_FNV1a_N(benchmark::State &state)
+{
+    std::vector<unsigned char> buffer(state.range(0));
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        // The usual hand-rolled hash, one byte at a time.
+        uint64_t r = UINT64_C(0xCBF29CE484222325);
+        for (unsigned char c : buffer)
+        {
+            r = (r ^ c) * UINT64_C(0x100000001B3);
+        }
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_FNV1a_N)->RangeMultiplier(8)->Range(8, 1 << 20);
+
+static void Bench_kr_hash32_N(benchmark::State &state)
+{
+    std::vector<unsigned char> buffer(state.range(0));
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        uint32_t r = kr_hash32(buffer.data(), buffer.size(), 0);
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_hash32_N)->RangeMultiplier(8)->Range(8, 1 << 20);
+
+static void Bench_kr_hash64_N(benchmark::State &state)
+{
+    std::vector<unsigned char> buffer(state.range(0));
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        uint64_t r = kr_hash64(buffer.data(), buffer.size(), 0);
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_hash64_N)->RangeMultiplier(8)->Range(8, 1 << 20);
+
+static void Bench_kr_hash64_update_N(benchmark::State &state)
+{
+    std::vector<unsigned char> buffer(state.range(0));
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        // Fed in uneven pieces, like a network stream.
+        kr_hash64_ctx_s ctx;
+        kr_hash64_init(&ctx, 0);
+        for (size_t i = 0; i < buffer.size(); i += 1500)
+        {
+            kr_hash64_update(&ctx, buffer.data() + i, std::min<size_t>(1500, buffer.size() - i));
+        }
+        uint64_t r = kr_hash64_final(&ctx);
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_hash64_update_N)->RangeMultiplier(8)->Range(8, 1 << 20);
+
+static void Bench_CRC32Bytewise_N(benchmark::State &state)
+{
+    std::vector<unsigned char> buffer(state.range(0));
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    uint32_t table[256];
+    for (uint32_t n = 0; n < 256; n++)
+    {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+        {
+            c = (c & 1) ? (c >> 1) ^ 0xEDB88320 : c >> 1;
+        }
+        table[n] = c;
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        // The usual byte-at-a-time table loop.
+        uint32_t r = 0xFFFFFFFF;
+        for (unsigned char c : buffer)
+        {
+            r = (r >> 8) ^ table[(r ^ c) & 0xFF];
+        }
+        r = ~r;
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_CRC32Bytewise_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_crc32_N(benchmark::State &state)
+{
+    std::vector<unsigned char> buffer(state.range(0));
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        uint32_t r = kr_crc32(0, buffer.data(), buffer.size());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_crc32_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_crc32c_N(benchmark::State &state)
+{
+    std::vector<unsigned char> buffer(state.range(0));
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        uint32_t r = kr_crc32c(0, buffer.data(), buffer.size());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_crc32c_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+static void Bench_kr_crc32c_Features(benchmark::State &state)
+{
+    const unsigned long features = kr_cpu_features();
+    std::vector<unsigned char> buffer(1 << 20, 0xA5);
+    kr_cpu_set_features(features & static_cast<unsigned long>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(kr_crc32c(0, buffer.data(), buffer.size()));
+    }
+    kr_cpu_set_features(features);
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(Bench_kr_crc32c_Features)->Arg(0)->Arg(KR_CPU_SSE42);
+
+static void Bench_kr_adler32_N(benchmark::State &state)
+{
+    std::vector<unsigned char> buffer(state.range(0));
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (unsigned char)(i * 2654435761u >> 24);
+    }
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buffer.data());
+        uint32_t r = kr_adler32(1, buffer.data(), buffer.size());
+        benchmark::DoNotOptimize(r);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Bench_kr_adler32_N)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+
+// Maps from random 64-bit keys to 64-bit values.  std::unordered_map is the
+// usual chained hash table, with one heap node per entry.
+
+static size_t MapHash(const void *key, size_t keySize)
+{
+    uint64_t k;
+    memcpy(&k, key, keySize);
+    return size_t(kr_hash_mix64(k));
+}
+
+static bool MapEqual(const void *a, const void *b, size_t keySize)
+{
+    (void)keySize;
+    return *static_cast<const uint64_t *>(a) == *static_cast<const uint64_t *>(b);
+}
+
+struct MapStdHash
+{
+    size_t operator()(uint64_t k) const
+    {
+        return size_t(kr_hash_mix64(k));
+    }
+};
+
+static std::vector<uint64_t> MakeMapKeys(size_t n, uint64_t seed)
+{
+    kr_jsf64_ctx_s ctx;
+    kr_jsf64_srand(&ctx, seed);
+    std::vector<uint64_t> keys(n);
+    for (auto &k : keys)
+    {
+        k = kr_jsf64_rand(&ctx);
+    }
+    return keys;
+}
+
+static void Bench_UnorderedMapInsert_N(benchmark::State &state)
+{
+    std::vector<uint64_t> keys = MakeMapKeys(state.range(0), 1993);
+    for (auto _ : state)
+    {
+        std::unordered_map<uint64_t, uint64_t, MapStdHash> map;
+        for (uint64_t k : keys)
+        {
+            map[k] = k;
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(Bench_UnorderedMapInsert_N)->Arg(1 << 20)->Arg(10000000)->Unit(benchmark::kMillisecond);
+
+static void Bench_kr_map_insert_N(benchmark::State &state)
+{
+    std::vector<uint64_t> keys = MakeMapKeys(state.range(0), 1993);
+    for (auto _ : state)
+    {
+        kr_map_s map;
+        kr_map_init(&map, sizeof(uint64_t), sizeof(uint64_t), MapHash, MapEqual);
+        for (uint64_t k : keys)
+        {
+            void *v = kr_map_insert(&map, &k, NULL);
+            memcpy(v, &k, sizeof(k));
+        }
+        benchmark::DoNotOptimize(map.count);
+        kr_map_free(&map);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(Bench_kr_map_insert_N)->Arg(1 << 20)->Arg(10000000)->Unit(benchmark::kMillisecond);
+
+static void Bench_UnorderedMapFind_N(benchmark::State &state)
+{
+    std::vector<uint64_t> keys = MakeMapKeys(state.range(0), 1993);
+    std::vector<uint64_t> misses = MakeMapKeys(state.range(0), 2024);
+    std::unordered_map<uint64_t, uint64_t, MapStdHash> map;
+    for (uint64_t k : keys)
+    {
+        map[k] = k;
+    }
+    for (auto _ : state)
+    {
+        // Half hits, half misses.
+        uint64_t total = 0;
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            auto it = map.find((i & 1) ? misses[i] : keys[i]);
+            total += it != map.end() ? it->second : 1;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(Bench_UnorderedMapFind_N)->Arg(1 << 20)->Arg(10000000)->Unit(benchmark::kMillisecond);
+
+static void Bench_kr_map_find_N(benchmark::State &state)
+{
+    std::vector<uint64_t> keys = MakeMapKeys(state.range(0), 1993);
+    std::vector<uint64_t> misses = MakeMapKeys(state.range(0), 2024);
+    kr_map_s map;
+    kr_map_init(&map, sizeof(uint64_t), sizeof(uint64_t), MapHash, MapEqual);
+    for (uint64_t k : keys)
+    {
+        void *v = kr_map_insert(&map, &k, NULL);
+        memcpy(v, &k, sizeof(k));
+    }
+    for (auto _ : state)
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            const void *v = kr_map_find(&map, (i & 1) ? &misses[i] : &keys[i]);
+            total += v != NULL ? *static_cast<const uint64_t *>(v) : 1;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    kr_map_free(&map);
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(Bench_kr_map_find_N)->Arg(1 << 20)->Arg(10000000)->Unit(benchmark::kMillisecond);
+
+static void Bench_kr_map_remove_N(benchmark::State &state)
+{
+    std::vector<uint64_t> keys = MakeMapKeys(state.range(0), 1993);
+    kr_map_s map;
+    kr_map_init(&map, sizeof(uint64_t), sizeof(uint64_t), MapHash, MapEqual);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (uint64_t k : keys)
+        {
+            void *v = kr_map_insert(&map, &k, NULL);
+            memcpy(v, &k, sizeof(k));
+        }
+        state.ResumeTiming();
+        for (uint64_t k : keys)
+        {
+            kr_map_remove(&map, &k);
+        }
+    }
+    kr_map_free(&map);
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(Bench_kr_map_remove_N)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+//------------------------------------------------------------------------------
+
+// A stream of 1M labels drawn from a few thousand distinct strings.
+static std::vector<std::string> MakeLabels(size_t distinct)
+{
+    std::vector<std::string> labels(1 << 20);
+    kr_jsf32_ctx_s ctx;
+    kr_jsf32_srand(&ctx, 1993);
+    for (auto &label : labels)
+    {
+        label = "service.http.requests.region" + std::to_string(kr_jsf32_rand(&ctx) % distinct);
+    }
+    return labels;
+}
+
+static void Bench_strdup_labels(benchmark::State &state)
+{
+    std::vector<std::string> labels = MakeLabels(state.range(0));
+    const char *hot = "service.http.requests.region7";
+    for (auto _ : state)
+    {
+        // Copy every label and compare it byte by byte.
+        size_t matches = 0;
+        for (const auto &label : labels)
+        {
+            char *dup = kr_strdup(label.c_str());
+            matches += kr_strcmp(dup, hot) == 0;
+            free(dup);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetItemsProcessed(state.iterations() * labels.size());
+}
+
+BENCHMARK(Bench_strdup_labels)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+static void Bench_kr_intern_labels(benchmark::State &state)
+{
+    std::vector<std::string> labels = MakeLabels(state.range(0));
+    kr_intern_s intern;
+    kr_intern_init(&intern, 65536);
+    const char *hot = kr_intern_str(&intern, "service.http.requests.region7");
+    for (auto _ : state)
+    {
+        // Intern every label and compare pointers.
+        size_t matches = 0;
+        for (const auto &label : labels)
+        {
+            matches += kr_intern_strn(&intern, label.data(), label.size()) == hot;
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    kr_intern_free(&intern);
+    state.SetItemsProcessed(state.iterations() * labels.size());
+}
+
+BENCHMARK(Bench_kr_intern_labels)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+//------------------------------------------------------------------------------
+
+static void Bench_realloc_push_N(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    for (auto _ : state)
+    {
+        // Grow by one element at a time.
+        uint32_t *data = nullptr;
+        for (size_t i = 0; i < n; i++)
+        {
+            data = static_cast<uint32_t *>(kr_reallocarray(data, i + 1, sizeof(uint32_t)));
+            data[i] = static_cast<uint32_t>(i);
+        }
+        benchmark::DoNotOptimize(data);
+        free(data);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_realloc_push_N)->Arg(1 << 10)->Arg(1 << 20);
+
+static void Bench_kr_vec_push_N(benchmark::State &state)
+{
+    const size_t n = state.range(0);
+    for (auto _ : state)
+    {
+        kr_vec_s vec;
+        kr_vec_init(&vec, sizeof(uint32_t));
+        for (size_t i = 0; i < n; i++)
+        {
+            const uint32_t x = static_cast<uint32_t>(i);
+            benchmark::DoNotOptimize(kr_vec_push(&vec, &x));
+        }
+        benchmark::DoNotOptimize(vec.data);
+        kr_vec_free(&vec);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_vec_push_N)->Arg(1 << 10)->Arg(1 << 20);
+
+//------------------------------------------------------------------------------
+
+static void Bench_MutexQueue_N(benchmark::State &state)
+{
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state)
+    {
+        // Pass n values from one thread to another through a locked deque.
+        // Both sides yield instead of spinning when there is nothing to do.
+        std::deque<uint32_t> queue;
+        std::mutex mutex;
+        std::thread producer([&] {
+            for (uint32_t i = 0; i < n; i++)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(i);
+            }
+        });
+        uint64_t total = 0;
+        for (uint32_t got = 0; got < n;)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!queue.empty())
+            {
+                total += queue.front();
+                queue.pop_front();
+                got++;
+            }
+            else
+            {
+                lock.unlock();
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_MutexQueue_N)->Arg(1 << 22)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void Bench_kr_ring_N(benchmark::State &state)
+{
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    kr_ring_s ring;
+    if (!kr_ring_init(&ring, sizeof(uint32_t), 1024))
+    {
+        state.SkipWithError("kr_ring_init failed");
+        return;
+    }
+    for (auto _ : state)
+    {
+        std::thread producer([&] {
+            for (uint32_t i = 0; i < n;)
+            {
+                if (kr_ring_push(&ring, &i))
+                {
+                    i++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        uint64_t total = 0;
+        for (uint32_t got = 0; got < n;)
+        {
+            uint32_t x;
+            if (kr_ring_pop(&ring, &x))
+            {
+                total += x;
+                got++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        benchmark::DoNotOptimize(total);
+    }
+    kr_ring_free(&ring);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_ring_N)->Arg(1 << 22)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void Bench_kr_ring_batch_N(benchmark::State &state)
+{
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    kr_ring_s ring;
+    if (!kr_ring_init(&ring, sizeof(uint32_t), 1024))
+    {
+        state.SkipWithError("kr_ring_init failed");
+        return;
+    }
+    for (auto _ : state)
+    {
+        // Move 64 values at a time in each direction.
+        std::thread producer([&] {
+            uint32_t batch[64];
+            for (uint32_t i = 0; i < n;)
+            {
+                const uint32_t want = std::min<uint32_t>(64, n - i);
+                for (uint32_t j = 0; j < want; j++)
+                {
+                    batch[j] = i + j;
+                }
+                const size_t k = kr_ring_push_n(&ring, batch, want);
+                if (k == 0)
+                {
+                    std::this_thread::yield();
+                }
+                i += static_cast<uint32_t>(k);
+            }
+        });
+        uint64_t total = 0;
+        uint32_t batch[64];
+        for (uint32_t got = 0; got < n;)
+        {
+            const size_t k = kr_ring_pop_n(&ring, batch, 64);
+            if (k == 0)
+            {
+                std::this_thread::yield();
+            }
+            for (size_t j = 0; j < k; j++)
+            {
+                total += batch[j];
+            }
+            got += static_cast<uint32_t>(k);
+        }
+        producer.join();
+        benchmark::DoNotOptimize(total);
+    }
+    kr_ring_free(&ring);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_kr_ring_batch_N)->Arg(1 << 22)->Unit(benchmark::kMillisecond)->UseRealTime();
+
 BENCHMARK_MAIN();
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#if !defined(KRARENA_H)
+#define KRARENA_H
+
+#include "./krconfig.h"
+
+#include "./krint.h"
+#include "./krstr.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+/**
+ * @brief Alignment of memory returned by kr_arena_alloc, suitable for any
+ *        fundamental type.
+ */
+#define KR_ARENA_ALIGN (KR_MAX_ALIGN)
+
+/**
+ * @brief A block of memory owned by an arena.  Usable memory follows the
+ *        header.
+ */
+struct kr_arena_block_s
+{
+    struct kr_arena_block_s *next;
+    size_t size;
+};
+
+/**
+ * @brief A region (bump) allocator.
+ *
+ * @details Allocating moves a pointer forward inside the current block, and
+ *          memory is never freed individually.  Instead, everything
+ *          allocated after a mark is released at once by rewinding to it,
+ *          or everything at all by resetting.  Blocks come from KR_MALLOC
+ *          and are kept for reuse until the arena is destroyed.
+ */
+struct kr_arena_s
+{
+    struct kr_arena_block_s *first;
+    struct kr_arena_block_s *block;
+    unsigned char *cur;
+    unsigned char *end;
+    size_t blockSize;
+};
+
+/**
+ * @brief A saved position inside an arena.
+ */
+struct kr_arena_mark_s
+{
+    struct kr_arena_block_s *block;
+    unsigned char *cur;
+};
+
+/**
+ * @brief Initialize an empty arena.  No memory is allocated until the first
+ *        allocation from the arena.
+ *
+ * @param arena Arena to initialize.
+ * @param blockSize Usable size of each block.  Larger allocations get a block
+ *        of their own.
+ */
+KR_INLINE void kr_arena_init(struct kr_arena_s *arena, size_t blockSize);
+
+/**
+ * @brief Free every block owned by an arena and leave it empty.
+ *
+ * @param arena Arena to destroy.
+ */
+KR_INLINE void kr_arena_destroy(struct kr_arena_s *arena);
+
+/**
+ * @brief Release every allocation in an arena in constant time.  Blocks are
+ *        kept for reuse.
+ *
+ * @param arena Arena to reset.
+ */
+KR_INLINE void kr_arena_reset(struct kr_arena_s *arena);
+
+/**
+ * @brief Save the current position inside an arena.
+ *
+ * @param arena Arena to mark.
+ * @return Mark that can be passed to kr_arena_rewind.
+ */
+KR_INLINE struct kr_arena_mark_s kr_arena_mark(const struct kr_arena_s *arena);
+
+/**
+ * @brief Release every allocation made since a mark was taken.
+ *
+ * @param arena Arena to rewind.
+ * @param mark Mark taken from the same arena, and not invalidated by
+ *        rewinding to an earlier mark or resetting.
+ */
+KR_INLINE void kr_arena_rewind(struct kr_arena_s *arena, struct kr_arena_mark_s mark);
+
+/**
+ * @brief Allocate memory from an arena with a specific alignment.
+ *
+ * @param arena Arena to allocate from.
+ * @param size Number of bytes to allocate.
+ * @param align Alignment of the allocation.  Must be a power of two.
+ * @return Allocated memory, or NULL if allocation failed.
+ */
+KR_NODISCARD KR_INLINE void *kr_arena_alloc_aligned(struct kr_arena_s *arena, size_t size, size_t align);
+
+/**
+ * @brief Allocate memory from an arena suitable for any fundamental type.
+ *
+ * @param arena Arena to allocate from.
+ * @param size Number of bytes to allocate.
+ * @return Allocated memory, or NULL if allocation failed.
+ */
+KR_NODISCARD KR_INLINE void *kr_arena_alloc(struct kr_arena_s *arena, size_t size);
+
+/**
+ * @brief Resize an array allocated from an arena, checking for overflow.
+ *
+ * @details The most recent allocation is grown in place if there is room.
+ *          Otherwise the contents are copied to a new allocation and the old
+ *          one is abandoned until the arena is reset.
+ *
+ * @param arena Arena to allocate from.
+ * @param ptr Existing allocation, or NULL to allocate a new array.
+ * @param oldNmemb Number of elements in the existing allocation.
+ * @param nmemb Number of elements to resize to.
+ * @param size Size of each element.
+ * @return Resized memory, or NULL if allocation failed.  The existing
+ *         allocation is unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE void *kr_arena_reallocarray(struct kr_arena_s *arena, void *ptr, size_t oldNmemb, size_t nmemb,
+                                                   size_t size);
+
+/**
+ * @brief Duplicate string into an arena.
+ *
+ * @param arena Arena to allocate from.
+ * @param str String to duplicate.
+ * @return Duplicated string, or NULL if allocation failed.
+ */
+KR_NODISCARD KR_INLINE char *kr_arena_strdup(struct kr_arena_s *arena, const char *str);
+
+/**
+ * @brief Duplicate string into an arena up to len characters.
+ *
+ * @param arena Arena to allocate from.
+ * @param str String to duplicate.
+ * @param len Maximum number of characters to copy.
+ * @return Duplicated string, or NULL if allocation failed.
+ */
+KR_NODISCARD KR_INLINE char *kr_arena_strndup(struct kr_arena_s *arena, const char *str, size_t len);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/**
+ * @brief Get the first usable byte of a block.
+ */
+#define KR_ARENA_DATA_DETAIL_(block) (KR_CASTR(unsigned char *, (block) + 1))
+
+KR_INLINE void kr_arena_init(struct kr_arena_s *arena, size_t blockSize)
+{
+    arena->first = NULL;
+    arena->block = NULL;
+    arena->cur = NULL;
+    arena->end = NULL;
+    arena->blockSize = blockSize;
+}
+
+KR_INLINE void kr_arena_destroy(struct kr_arena_s *arena)
+{
+    struct kr_arena_block_s *block = arena->first, *next = NULL;
+
+    for (; block != NULL; block = next)
+    {
+        next = block->next;
+        KR_FREE(block);
+    }
+    kr_arena_init(arena, arena->blockSize);
+}
+
+KR_INLINE void kr_arena_reset(struct kr_arena_s *arena)
+{
+    struct kr_arena_mark_s mark = {NULL, NULL};
+    kr_arena_rewind(arena, mark);
+}
+
+/******************************************************************************/
+
+KR_INLINE struct kr_arena_mark_s kr_arena_mark(const struct kr_arena_s *arena)
+{
+    struct kr_arena_mark_s mark = {NULL, NULL};
+    mark.block = arena->block;
+    mark.cur = arena->cur;
+    return mark;
+}
+
+KR_INLINE void kr_arena_rewind(struct kr_arena_s *arena, struct kr_arena_mark_s mark)
+{
+    if (mark.block == NULL)
+    {
+        /* Start over from the first block, which might not exist yet. */
+        arena->block = arena->first;
+        arena->cur = arena->first != NULL ? KR_ARENA_DATA_DETAIL_(arena->first) : NULL;
+        arena->end = arena->first != NULL ? arena->cur + arena->first->size : NULL;
+        return;
+    }
+
+    arena->block = mark.block;
+    arena->cur = mark.cur;
+    arena->end = KR_ARENA_DATA_DETAIL_(mark.block) + mark.block->size;
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE void *kr_arena_alloc_aligned(struct kr_arena_s *arena, size_t size, size_t align)
+{
+    struct kr_arena_block_s *next = NULL;
+    size_t pad = 0, need = 0;
+
+    if (size > SIZE_MAX - align)
+    {
+        return NULL;
+    }
+
+    for (;;)
+    {
+        if (arena->block != NULL)
+        {
+            pad = (align - KR_CASTR(uintptr_t, arena->cur) % align) % align;
+            if (pad <= KR_CASTS(size_t, arena->end - arena->cur) &&
+                size <= KR_CASTS(size_t, arena->end - arena->cur) - pad)
+            {
+                arena->cur += pad + size;
+                return arena->cur - size;
+            }
+        }
+
+        /* Move to the next block, reusing one left over from a rewind if it
+         * is big enough for this allocation at any alignment. */
+        need = size + align - 1;
+        next = arena->block != NULL ? arena->block->next : arena->first;
+        if (next == NULL || next->size < need)
+        {
+            const size_t blockSize = need > arena->blockSize ? need : arena->blockSize;
+            struct kr_arena_block_s *block = NULL;
+
+            if (blockSize > SIZE_MAX - sizeof(struct kr_arena_block_s))
+            {
+                return NULL;
+            }
+
+            block = KR_CASTS(struct kr_arena_block_s *, KR_MALLOC(sizeof(struct kr_arena_block_s) + blockSize));
+            if (block == NULL)
+            {
+                return NULL;
+            }
+
+            block->size = blockSize;
+            block->next = next;
+            if (arena->block != NULL)
+            {
+                arena->block->next = block;
+            }
+            else
+            {
+                arena->first = block;
+            }
+            next = block;
+        }
+
+        arena->block = next;
+        arena->cur = KR_ARENA_DATA_DETAIL_(next);
+        arena->end = arena->cur + next->size;
+    }
+}
+
+KR_NODISCARD KR_INLINE void *kr_arena_alloc(struct kr_arena_s *arena, size_t size)
+{
+    return kr_arena_alloc_aligned(arena, size, KR_ARENA_ALIGN);
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE void *kr_arena_reallocarray(struct kr_arena_s *arena, void *ptr, size_t oldNmemb, size_t nmemb,
+                                                   size_t size)
+{
+    const size_t x = nmemb * size;
+    const size_t oldx = oldNmemb * size;
+    unsigned char *bytes = KR_CASTS(unsigned char *, ptr);
+    void *res = NULL;
+
+    if (nmemb != 0 && x / nmemb != size)
+    {
+        return NULL;
+    }
+
+    if (bytes != NULL && bytes + oldx == arena->cur)
+    {
+        /* Most recent allocation, so it can grow or shrink in place. */
+        if (x <= oldx || x - oldx <= KR_CASTS(size_t, arena->end - arena->cur))
+        {
+            arena->cur = bytes + x;
+            return ptr;
+        }
+    }
+
+    if (x <= oldx && bytes != NULL)
+    {
+        return ptr;
+    }
+
+    res = kr_arena_alloc(arena, x);
+    if (res != NULL && bytes != NULL)
+    {
+        memcpy(res, bytes, oldx);
+    }
+    return res;
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE char *kr_arena_strdup(struct kr_arena_s *arena, const char *str)
+{
+    const size_t strl = kr_strlen(str);
+    char *dup = KR_CASTS(char *, kr_arena_alloc_aligned(arena, strl + 1, 1));
+    if (dup == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(dup, str, strl + 1);
+    return dup;
+}
+
+KR_NODISCARD KR_INLINE char *kr_arena_strndup(struct kr_arena_s *arena, const char *str, size_t len)
+{
+    const size_t strl = kr_strnlen(str, len);
+    char *dup = KR_CASTS(char *, kr_arena_alloc_aligned(arena, strl + 1, 1));
+    if (dup == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(dup, str, strl);
+    dup[strl] = '\0';
+    return dup;
+}
+
+#undef KR_ARENA_DATA_DETAIL_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRARENA_H) */
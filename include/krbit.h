@@ -310,6 +310,28 @@ KR_CONSTEXPR unsigned kr_count_ones16(uint16_t x) KR_NOEXCEPT;
  */
 KR_CONSTEXPR unsigned kr_count_ones32(uint32_t x) KR_NOEXCEPT;
 
+/**
+ * @brief Deposit the low bits of a value into the set bits of a mask, from
+ *        the LSB up.  This is the same as the BMI2 instruction pdep.
+ *
+ * @details Takes a fixed number of steps no matter how many bits are set
+ *          in the mask.
+ *
+ * @link https://www.hackersdelight.org/ (Section 7-5, "Expand")
+ */
+KR_CONSTEXPR uint32_t kr_bit_deposit32(uint32_t x, uint32_t mask) KR_NOEXCEPT;
+
+/**
+ * @brief Extract the bits of a value under the set bits of a mask, packed
+ *        into the low bits.  This is the same as the BMI2 instruction pext.
+ *
+ * @details Takes a fixed number of steps no matter how many bits are set
+ *          in the mask.
+ *
+ * @link https://www.hackersdelight.org/ (Section 7-4, "Compress")
+ */
+KR_CONSTEXPR uint32_t kr_bit_extract32(uint32_t x, uint32_t mask) KR_NOEXCEPT;
+
 #if defined(UINT64_MAX)
 
 /**
@@ -319,6 +341,31 @@ KR_CONSTEXPR unsigned kr_count_ones32(uint32_t x) KR_NOEXCEPT;
  */
 KR_CONSTEXPR unsigned kr_count_ones64(uint64_t x) KR_NOEXCEPT;
 
+/**
+ * @brief Find the position of the k-th set bit, counting from 0 at the LSB.
+ *
+ * @return Position of the bit, or 64 if fewer than k+1 bits are set.
+ *
+ * @link https://vigna.di.unimi.it/ftp/papers/Broadword.pdf
+ */
+KR_CONSTEXPR unsigned kr_bit_select64(uint64_t x, unsigned k) KR_NOEXCEPT;
+
+/**
+ * @brief Deposit the low bits of a value into the set bits of a mask, from
+ *        the LSB up.  This is the same as the BMI2 instruction pdep.
+ *
+ * @link https://www.hackersdelight.org/ (Section 7-5, "Expand")
+ */
+KR_CONSTEXPR uint64_t kr_bit_deposit64(uint64_t x, uint64_t mask) KR_NOEXCEPT;
+
+/**
+ * @brief Extract the bits of a value under the set bits of a mask, packed
+ *        into the low bits.  This is the same as the BMI2 instruction pext.
+ *
+ * @link https://www.hackersdelight.org/ (Section 7-4, "Compress")
+ */
+KR_CONSTEXPR uint64_t kr_bit_extract64(uint64_t x, uint64_t mask) KR_NOEXCEPT;
+
 #endif /* defined(UINT64_MAX) */
 
 /******************************************************************************/
@@ -826,6 +873,95 @@ KR_CONSTEXPR unsigned kr_count_ones32(uint32_t x) KR_NOEXCEPT
     return KR_CASTS(uint32_t, x * UINT32_C(0x01010101)) >> 24;
 }
 
+/*
+ * Deposit and extract move every bit by the number of clear mask bits to
+ * its right, in steps of 1, 2, 4, 8 and so on.  Each step finds the bits
+ * that move by that amount with a parallel suffix XOR of those counts.
+ * The steps are unrolled so a constant mask folds away at -O2.
+ */
+
+/**
+ * @brief Parallel suffix XOR, bit i of the result is the XOR of bits 0 to i.
+ */
+KR_CONSTEXPR uint32_t kr_bit_suffix32_detail_(uint32_t x) KR_NOEXCEPT
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    return x;
+}
+
+KR_CONSTEXPR uint32_t kr_bit_deposit32(uint32_t x, uint32_t mask) KR_NOEXCEPT
+{
+    uint32_t m = mask, mk = ~mask << 1, mp = 0;
+    uint32_t mv1 = 0, mv2 = 0, mv4 = 0, mv8 = 0, mv16 = 0;
+
+    mp = kr_bit_suffix32_detail_(mk);
+    mv1 = mp & m;
+    m = (m ^ mv1) | (mv1 >> 1);
+    mk &= ~mp;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv2 = mp & m;
+    m = (m ^ mv2) | (mv2 >> 2);
+    mk &= ~mp;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv4 = mp & m;
+    m = (m ^ mv4) | (mv4 >> 4);
+    mk &= ~mp;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv8 = mp & m;
+    m = (m ^ mv8) | (mv8 >> 8);
+    mk &= ~mp;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv16 = mp & m;
+
+    /* Replay the moves in reverse, shifting left instead of right. */
+    x = (x & ~mv16) | ((x << 16) & mv16);
+    x = (x & ~mv8) | ((x << 8) & mv8);
+    x = (x & ~mv4) | ((x << 4) & mv4);
+    x = (x & ~mv2) | ((x << 2) & mv2);
+    x = (x & ~mv1) | ((x << 1) & mv1);
+    return x & mask;
+}
+
+KR_CONSTEXPR uint32_t kr_bit_extract32(uint32_t x, uint32_t mask) KR_NOEXCEPT
+{
+    uint32_t mk = ~mask << 1, mp = 0, mv = 0, t = 0;
+
+    x &= mask;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 1);
+    t = x & mv;
+    x = (x ^ t) | (t >> 1);
+    mk &= ~mp;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 2);
+    t = x & mv;
+    x = (x ^ t) | (t >> 2);
+    mk &= ~mp;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 4);
+    t = x & mv;
+    x = (x ^ t) | (t >> 4);
+    mk &= ~mp;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 8);
+    t = x & mv;
+    x = (x ^ t) | (t >> 8);
+    mk &= ~mp;
+    mp = kr_bit_suffix32_detail_(mk);
+    mv = mp & mask;
+    t = x & mv;
+    x = (x ^ t) | (t >> 16);
+    return x;
+}
+
 #if defined(UINT64_MAX)
 
 KR_CONSTEXPR unsigned kr_count_ones64(uint64_t x) KR_NOEXCEPT
@@ -836,6 +972,131 @@ KR_CONSTEXPR unsigned kr_count_ones64(uint64_t x) KR_NOEXCEPT
     return KR_CASTS(uint64_t, x * UINT64_C(0x0101010101010101)) >> 56;
 }
 
+KR_CONSTEXPR unsigned kr_bit_select64(uint64_t x, unsigned k) KR_NOEXCEPT
+{
+    uint64_t s = 0, b = 0, w = 0;
+    unsigned place = 0, r = 0;
+
+    /* Running count of set bits at the end of each byte. */
+    s = x - ((x >> 1) & UINT64_C(0x5555555555555555));
+    s = (s & UINT64_C(0x3333333333333333)) + ((s >> 2) & UINT64_C(0x3333333333333333));
+    s = (s + (s >> 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+    b = s * UINT64_C(0x0101010101010101);
+    if (k >= (b >> 56))
+    {
+        return 64;
+    }
+
+    /* Every byte whose running count is <= k comes before the bit. */
+    w = ((k * UINT64_C(0x0101010101010101)) | UINT64_C(0x8080808080808080)) - b;
+    w = ((w & UINT64_C(0x8080808080808080)) >> 7) * UINT64_C(0x0101010101010101);
+    place = KR_CASTS(unsigned, (w >> 53) & ~KR_CASTS(uint64_t, 7));
+    r = k - KR_CASTS(unsigned, ((b << 8) >> place) & 0xFF);
+
+    /* Spread the bits of that byte out into bytes and do the same again,
+     * which avoids a data-dependent loop. */
+    w = ((x >> place) & 0xFF) * UINT64_C(0x0101010101010101);
+    s = (((w & UINT64_C(0x8040201008040201)) + UINT64_C(0x7F7F7F7F7F7F7F7F)) & UINT64_C(0x8080808080808080)) >> 7;
+    b = s * UINT64_C(0x0101010101010101);
+    w = ((r * UINT64_C(0x0101010101010101)) | UINT64_C(0x8080808080808080)) - b;
+    w = ((w & UINT64_C(0x8080808080808080)) >> 7) * UINT64_C(0x0101010101010101);
+    return place + KR_CASTS(unsigned, w >> 56);
+}
+
+/**
+ * @brief Parallel suffix XOR, bit i of the result is the XOR of bits 0 to i.
+ */
+KR_CONSTEXPR uint64_t kr_bit_suffix64_detail_(uint64_t x) KR_NOEXCEPT
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+KR_CONSTEXPR uint64_t kr_bit_deposit64(uint64_t x, uint64_t mask) KR_NOEXCEPT
+{
+    uint64_t m = mask, mk = ~mask << 1, mp = 0;
+    uint64_t mv1 = 0, mv2 = 0, mv4 = 0, mv8 = 0, mv16 = 0, mv32 = 0;
+
+    mp = kr_bit_suffix64_detail_(mk);
+    mv1 = mp & m;
+    m = (m ^ mv1) | (mv1 >> 1);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv2 = mp & m;
+    m = (m ^ mv2) | (mv2 >> 2);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv4 = mp & m;
+    m = (m ^ mv4) | (mv4 >> 4);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv8 = mp & m;
+    m = (m ^ mv8) | (mv8 >> 8);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv16 = mp & m;
+    m = (m ^ mv16) | (mv16 >> 16);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv32 = mp & m;
+
+    /* Replay the moves in reverse, shifting left instead of right. */
+    x = (x & ~mv32) | ((x << 32) & mv32);
+    x = (x & ~mv16) | ((x << 16) & mv16);
+    x = (x & ~mv8) | ((x << 8) & mv8);
+    x = (x & ~mv4) | ((x << 4) & mv4);
+    x = (x & ~mv2) | ((x << 2) & mv2);
+    x = (x & ~mv1) | ((x << 1) & mv1);
+    return x & mask;
+}
+
+KR_CONSTEXPR uint64_t kr_bit_extract64(uint64_t x, uint64_t mask) KR_NOEXCEPT
+{
+    uint64_t mk = ~mask << 1, mp = 0, mv = 0, t = 0;
+
+    x &= mask;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 1);
+    t = x & mv;
+    x = (x ^ t) | (t >> 1);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 2);
+    t = x & mv;
+    x = (x ^ t) | (t >> 2);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 4);
+    t = x & mv;
+    x = (x ^ t) | (t >> 4);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 8);
+    t = x & mv;
+    x = (x ^ t) | (t >> 8);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv = mp & mask;
+    mask = (mask ^ mv) | (mv >> 16);
+    t = x & mv;
+    x = (x ^ t) | (t >> 16);
+    mk &= ~mp;
+    mp = kr_bit_suffix64_detail_(mk);
+    mv = mp & mask;
+    t = x & mv;
+    x = (x ^ t) | (t >> 32);
+    return x;
+}
+
 #endif /* defined(UINT64_MAX) */
 
 #endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
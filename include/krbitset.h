@@ -0,0 +1,496 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * A dynamically sized bitset.
+ *
+ * Bits are stored in 64-bit words, and bit i is bit (i % 64) of word
+ * (i / 64), counting from the LSB, so the words can be handed straight to
+ * the functions in krrank.h.  Searching and iterating skip a whole word of
+ * zeroes at a time and find bits with kr_ctz64.
+ */
+
+#if !defined(KRBITSET_H)
+#define KRBITSET_H
+
+#include "./krconfig.h"
+
+#include "./krbltin.h"
+#include "./krbool.h"
+#include "./krint.h"
+#include "./krlib.h"
+#include "./krrank.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#if defined(UINT64_MAX)
+
+/**
+ * @brief A bitset, backed either by the heap or by a buffer from the caller.
+ */
+struct kr_bitset_s
+{
+    uint64_t *words;
+    size_t nbits;
+    size_t cap;
+    bool heap;
+};
+
+/**
+ * @brief Iterates over the set bits of a bitset in increasing order.
+ */
+struct kr_bitset_iter_s
+{
+    const uint64_t *words;
+    size_t nbits;
+    size_t base;
+    uint64_t cur;
+};
+
+/**
+ * @brief Get the number of words needed to hold a number of bits.
+ */
+#define KR_BITSET_WORDS(nbits) ((nbits) / 64 + ((nbits) % 64 != 0))
+
+/**
+ * @brief Initialize an empty bitset.  No memory is allocated until the
+ *        bitset is resized.
+ *
+ * @param bs Bitset to initialize.
+ */
+KR_INLINE void kr_bitset_init(struct kr_bitset_s *bs);
+
+/**
+ * @brief Initialize a bitset on top of a buffer from the caller.
+ *
+ * @details The existing contents of the buffer are used as the bits.  If the
+ *          bitset is resized past the end of the buffer, it moves to the
+ *          heap and the buffer is left alone from then on.
+ *
+ * @param bs Bitset to initialize.
+ * @param words Buffer of at least KR_BITSET_WORDS(nbits) words.
+ * @param nbits Number of bits in the bitset.
+ */
+KR_INLINE void kr_bitset_init_buffer(struct kr_bitset_s *bs, uint64_t *words, size_t nbits);
+
+/**
+ * @brief Free any memory owned by a bitset and leave it empty.
+ *
+ * @param bs Bitset to free.
+ */
+KR_INLINE void kr_bitset_free(struct kr_bitset_s *bs);
+
+/**
+ * @brief Change the number of bits in a bitset.  New bits are clear.
+ *
+ * @param bs Bitset to resize.
+ * @param nbits New number of bits.
+ * @return true if successful, or false if allocation failed.  The bitset is
+ *         unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_bitset_resize(struct kr_bitset_s *bs, size_t nbits);
+
+/**
+ * @brief Set a bit.
+ *
+ * @param bs Bitset to modify.
+ * @param i Bit to set.  Must be less than the number of bits.
+ */
+KR_INLINE void kr_bitset_set(struct kr_bitset_s *bs, size_t i);
+
+/**
+ * @brief Clear a bit.
+ *
+ * @param bs Bitset to modify.
+ * @param i Bit to clear.  Must be less than the number of bits.
+ */
+KR_INLINE void kr_bitset_clear(struct kr_bitset_s *bs, size_t i);
+
+/**
+ * @brief Test a bit.
+ *
+ * @param bs Bitset to read.
+ * @param i Bit to test.  Must be less than the number of bits.
+ * @return true if the bit is set.
+ */
+KR_INLINE bool kr_bitset_test(const struct kr_bitset_s *bs, size_t i);
+
+/**
+ * @brief Set every bit.
+ *
+ * @param bs Bitset to modify.
+ */
+KR_INLINE void kr_bitset_setall(struct kr_bitset_s *bs);
+
+/**
+ * @brief Clear every bit.
+ *
+ * @param bs Bitset to modify.
+ */
+KR_INLINE void kr_bitset_clearall(struct kr_bitset_s *bs);
+
+/**
+ * @brief Count the set bits.
+ *
+ * @param bs Bitset to read.
+ * @return Number of set bits.
+ */
+KR_INLINE size_t kr_bitset_count(const struct kr_bitset_s *bs);
+
+/**
+ * @brief Find the first set bit at or after a position.
+ *
+ * @param bs Bitset to search.
+ * @param from Position to start searching from.
+ * @return Position of the bit, or the number of bits if there is none.
+ */
+KR_INLINE size_t kr_bitset_next_set(const struct kr_bitset_s *bs, size_t from);
+
+/**
+ * @brief Find the first clear bit at or after a position.
+ *
+ * @param bs Bitset to search.
+ * @param from Position to start searching from.
+ * @return Position of the bit, or the number of bits if there is none.
+ */
+KR_INLINE size_t kr_bitset_next_clear(const struct kr_bitset_s *bs, size_t from);
+
+/**
+ * @brief Start iterating over the set bits of a bitset.
+ *
+ * @details The bitset must not be resized or freed while iterating.  Bits
+ *          changed after the iterator has passed them are not seen again.
+ *
+ * @param it Iterator to initialize.
+ * @param bs Bitset to iterate over.
+ */
+KR_INLINE void kr_bitset_iter_init(struct kr_bitset_iter_s *it, const struct kr_bitset_s *bs);
+
+/**
+ * @brief Get the next set bit.
+ *
+ * @param it Iterator to advance.
+ * @param pos Output position of the set bit.
+ * @return true if a set bit was found, or false if there are none left.
+ */
+KR_INLINE bool kr_bitset_iter_next(struct kr_bitset_iter_s *it, size_t *pos);
+
+/**
+ * @brief Bitwise AND one word array into another.
+ *
+ * @param dest Words to modify.
+ * @param src Words to AND into dest.  May be the same as dest.
+ * @param n Number of words.
+ */
+KR_INLINE void kr_bitset_and_words(uint64_t *dest, const uint64_t *src, size_t n);
+
+/**
+ * @brief Bitwise OR one word array into another.
+ *
+ * @param dest Words to modify.
+ * @param src Words to OR into dest.  May be the same as dest.
+ * @param n Number of words.
+ */
+KR_INLINE void kr_bitset_or_words(uint64_t *dest, const uint64_t *src, size_t n);
+
+/**
+ * @brief Bitwise XOR one word array into another.
+ *
+ * @param dest Words to modify.
+ * @param src Words to XOR into dest.  May be the same as dest.
+ * @param n Number of words.
+ */
+KR_INLINE void kr_bitset_xor_words(uint64_t *dest, const uint64_t *src, size_t n);
+
+/**
+ * @brief Clear the bits of one word array that are set in another.
+ *
+ * @param dest Words to modify.
+ * @param src Words whose set bits are cleared from dest.  May be the same
+ *        as dest.
+ * @param n Number of words.
+ */
+KR_INLINE void kr_bitset_andnot_words(uint64_t *dest, const uint64_t *src, size_t n);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/**
+ * @brief Get a mask of the bits of the last word that are inside a bitset.
+ */
+#define KR_BITSET_TAIL_DETAIL_(nbits)                                                                                  \
+    ((nbits) % 64 != 0 ? (UINT64_C(1) << ((nbits) % 64)) - 1 : UINT64_C(0xFFFFFFFFFFFFFFFF))
+
+KR_INLINE void kr_bitset_init(struct kr_bitset_s *bs)
+{
+    bs->words = NULL;
+    bs->nbits = 0;
+    bs->cap = 0;
+    bs->heap = false;
+}
+
+KR_INLINE void kr_bitset_init_buffer(struct kr_bitset_s *bs, uint64_t *words, size_t nbits)
+{
+    bs->words = words;
+    bs->nbits = nbits;
+    bs->cap = KR_BITSET_WORDS(nbits);
+    bs->heap = false;
+}
+
+KR_INLINE void kr_bitset_free(struct kr_bitset_s *bs)
+{
+    if (bs->heap)
+    {
+        KR_FREE(bs->words);
+    }
+    kr_bitset_init(bs);
+}
+
+KR_NODISCARD KR_INLINE bool kr_bitset_resize(struct kr_bitset_s *bs, size_t nbits)
+{
+    const size_t oldWords = KR_BITSET_WORDS(bs->nbits), newWords = KR_BITSET_WORDS(nbits);
+    size_t cap = bs->cap;
+    uint64_t *words = NULL;
+
+    if (newWords > cap)
+    {
+        /* Grow geometrically so growing a bit at a time stays cheap. */
+        cap = cap <= SIZE_MAX / 2 / sizeof(uint64_t) && cap * 2 > newWords ? cap * 2 : newWords;
+        if (bs->heap)
+        {
+            words = KR_CASTS(uint64_t *, kr_reallocarray(bs->words, cap, sizeof(uint64_t)));
+        }
+        else
+        {
+            words = KR_CASTS(uint64_t *, kr_reallocarray(NULL, cap, sizeof(uint64_t)));
+            if (words != NULL && oldWords != 0)
+            {
+                memcpy(words, bs->words, oldWords * sizeof(uint64_t));
+            }
+        }
+        if (words == NULL)
+        {
+            return false;
+        }
+        bs->words = words;
+        bs->cap = cap;
+        bs->heap = true;
+    }
+
+    /* Clear everything past the old end, so growing again later never
+     * brings old bits back. */
+    if (oldWords != 0 && bs->nbits % 64 != 0)
+    {
+        bs->words[oldWords - 1] &= KR_BITSET_TAIL_DETAIL_(bs->nbits);
+    }
+    if (newWords > oldWords)
+    {
+        memset(bs->words + oldWords, 0, (newWords - oldWords) * sizeof(uint64_t));
+    }
+    if (newWords != 0 && nbits < bs->nbits)
+    {
+        bs->words[newWords - 1] &= KR_BITSET_TAIL_DETAIL_(nbits);
+    }
+
+    bs->nbits = nbits;
+    return true;
+}
+
+/******************************************************************************/
+
+KR_INLINE void kr_bitset_set(struct kr_bitset_s *bs, size_t i)
+{
+    bs->words[i / 64] |= UINT64_C(1) << (i % 64);
+}
+
+KR_INLINE void kr_bitset_clear(struct kr_bitset_s *bs, size_t i)
+{
+    bs->words[i / 64] &= ~(UINT64_C(1) << (i % 64));
+}
+
+KR_INLINE bool kr_bitset_test(const struct kr_bitset_s *bs, size_t i)
+{
+    return ((bs->words[i / 64] >> (i % 64)) & 1) != 0;
+}
+
+KR_INLINE void kr_bitset_setall(struct kr_bitset_s *bs)
+{
+    const size_t n = KR_BITSET_WORDS(bs->nbits);
+
+    if (n != 0)
+    {
+        memset(bs->words, 0xFF, n * sizeof(uint64_t));
+        bs->words[n - 1] = KR_BITSET_TAIL_DETAIL_(bs->nbits);
+    }
+}
+
+KR_INLINE void kr_bitset_clearall(struct kr_bitset_s *bs)
+{
+    const size_t n = KR_BITSET_WORDS(bs->nbits);
+
+    if (n != 0)
+    {
+        memset(bs->words, 0, n * sizeof(uint64_t));
+    }
+}
+
+KR_INLINE size_t kr_bitset_count(const struct kr_bitset_s *bs)
+{
+    const size_t n = bs->nbits / 64;
+    size_t count = KR_CASTS(size_t, kr_popcount_array(bs->words, n));
+
+    if (bs->nbits % 64 != 0)
+    {
+        count += KR_CASTS(size_t, kr_popcnt64(bs->words[n] & KR_BITSET_TAIL_DETAIL_(bs->nbits)));
+    }
+    return count;
+}
+
+/******************************************************************************/
+
+KR_INLINE size_t kr_bitset_next_set(const struct kr_bitset_s *bs, size_t from)
+{
+    const size_t n = KR_BITSET_WORDS(bs->nbits);
+    size_t i = from / 64, pos = 0;
+    uint64_t w = 0;
+
+    if (from >= bs->nbits)
+    {
+        return bs->nbits;
+    }
+
+    /* Skip whole words of zeroes, then take the lowest bit. */
+    w = bs->words[i] & (UINT64_C(0xFFFFFFFFFFFFFFFF) << (from % 64));
+    while (w == 0)
+    {
+        if (++i == n)
+        {
+            return bs->nbits;
+        }
+        w = bs->words[i];
+    }
+
+    pos = i * 64 + KR_CASTS(size_t, kr_ctz64(w));
+    return pos < bs->nbits ? pos : bs->nbits;
+}
+
+KR_INLINE size_t kr_bitset_next_clear(const struct kr_bitset_s *bs, size_t from)
+{
+    const size_t n = KR_BITSET_WORDS(bs->nbits);
+    size_t i = from / 64, pos = 0;
+    uint64_t w = 0;
+
+    if (from >= bs->nbits)
+    {
+        return bs->nbits;
+    }
+
+    w = ~bs->words[i] & (UINT64_C(0xFFFFFFFFFFFFFFFF) << (from % 64));
+    while (w == 0)
+    {
+        if (++i == n)
+        {
+            return bs->nbits;
+        }
+        w = ~bs->words[i];
+    }
+
+    pos = i * 64 + KR_CASTS(size_t, kr_ctz64(w));
+    return pos < bs->nbits ? pos : bs->nbits;
+}
+
+/******************************************************************************/
+
+KR_INLINE void kr_bitset_iter_init(struct kr_bitset_iter_s *it, const struct kr_bitset_s *bs)
+{
+    it->words = bs->words;
+    it->nbits = bs->nbits;
+    it->base = 0;
+    it->cur = 0;
+    if (bs->nbits != 0)
+    {
+        it->cur = bs->words[0] & (bs->nbits < 64 ? KR_BITSET_TAIL_DETAIL_(bs->nbits) : UINT64_C(0xFFFFFFFFFFFFFFFF));
+    }
+}
+
+KR_INLINE bool kr_bitset_iter_next(struct kr_bitset_iter_s *it, size_t *pos)
+{
+    while (it->cur == 0)
+    {
+        it->base += 64;
+        if (it->base >= it->nbits)
+        {
+            return false;
+        }
+        it->cur = it->words[it->base / 64];
+        if (it->nbits - it->base < 64)
+        {
+            it->cur &= KR_BITSET_TAIL_DETAIL_(it->nbits);
+        }
+    }
+
+    /* Report the lowest set bit, then clear it. */
+    *pos = it->base + KR_CASTS(size_t, kr_ctz64(it->cur));
+    it->cur &= it->cur - 1;
+    return true;
+}
+
+/******************************************************************************/
+
+KR_INLINE void kr_bitset_and_words(uint64_t *dest, const uint64_t *src, size_t n)
+{
+    size_t i = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        dest[i] &= src[i];
+    }
+}
+
+KR_INLINE void kr_bitset_or_words(uint64_t *dest, const uint64_t *src, size_t n)
+{
+    size_t i = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        dest[i] |= src[i];
+    }
+}
+
+KR_INLINE void kr_bitset_xor_words(uint64_t *dest, const uint64_t *src, size_t n)
+{
+    size_t i = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        dest[i] ^= src[i];
+    }
+}
+
+KR_INLINE void kr_bitset_andnot_words(uint64_t *dest, const uint64_t *src, size_t n)
+{
+    size_t i = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        dest[i] &= ~src[i];
+    }
+}
+
+#undef KR_BITSET_TAIL_DETAIL_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* defined(UINT64_MAX) */
+
+#endif /* !defined(KRBITSET_H) */
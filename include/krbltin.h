@@ -25,6 +25,10 @@
 #define KR_MSC_HAS_INTRIN_ (0)
 #endif /* (KR_MSC_VER >= 1300) */
 
+#if (KR_BMI2) && (KR_GNUC || KR_CLANG)
+#include <immintrin.h>
+#endif /* (KR_BMI2) && (KR_GNUC || KR_CLANG) */
+
 /******************************************************************************/
 
 #if (KR_CLANG)
@@ -233,6 +237,26 @@ KR_FORCEINLINE int kr_ctz64_detail_(unsigned long long x)
 #endif /* defined(UINT64_MAX) */
 #endif
 
+/******************************************************************************/
+
+#if (KR_BMI2)
+#define kr_pdep32(x, m) (KR_CASTS(uint32_t, _pdep_u32((x), (m))))
+#define kr_pext32(x, m) (KR_CASTS(uint32_t, _pext_u32((x), (m))))
+#else
+#define kr_pdep32(x, m) (kr_bit_deposit32((x), (m)))
+#define kr_pext32(x, m) (kr_bit_extract32((x), (m)))
+#endif /* (KR_BMI2) */
+
+#if defined(UINT64_MAX)
+#if (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+#define kr_pdep64(x, m) (KR_CASTS(uint64_t, _pdep_u64((x), (m))))
+#define kr_pext64(x, m) (KR_CASTS(uint64_t, _pext_u64((x), (m))))
+#else
+#define kr_pdep64(x, m) (kr_bit_deposit64((x), (m)))
+#define kr_pext64(x, m) (kr_bit_extract64((x), (m)))
+#endif /* (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64)) */
+#endif /* defined(UINT64_MAX) */
+
 #undef KR_MSC_HAS_INTRIN_
 
 #endif /* !defined(KRBLTIN_H) */
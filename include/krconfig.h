@@ -14,6 +14,19 @@
  *  KRUFT_IMPLEMENTATION before including.
  * KR_CONFIG_NOINCLUDE:
  *	If defined, does not include any libc header automatically.
+ * KR_CONFIG_SWARSTR:
+ *	If non-zero, kr_strlen and kr_strnlen scan a machine word at a time
+ *  instead of a byte at a time.  Constant evaluation always uses bytes.
+ * KR_CONFIG_STRBUFSMALL:
+ *	Size of the buffer inside kr_strbuf_s used before allocating, including
+ *  the null terminator.  Defaults to 32.
+ * KR_CONFIG_POOL_LOCK, KR_CONFIG_POOL_UNLOCK:
+ *	Called with a pool when a kr_pool_cache_s moves cells to or from it.
+ *  Define these if caches on several threads share one pool.  By default
+ *  they do nothing.
+ * KR_CONFIG_POOL_CACHEBATCH:
+ *	Number of cells a kr_pool_cache_s moves to or from its pool at once.
+ *  Defaults to 32.
  */
 
 #if !defined(KRCONFIG_H)
@@ -29,6 +42,26 @@
 #define KR_CONFIG_NOINCLUDE (0)
 #endif
 
+#if !defined(KR_CONFIG_SWARSTR)
+#define KR_CONFIG_SWARSTR (0)
+#endif
+
+#if !defined(KR_CONFIG_STRBUFSMALL)
+#define KR_CONFIG_STRBUFSMALL (32)
+#endif
+
+#if !defined(KR_CONFIG_POOL_LOCK)
+#define KR_CONFIG_POOL_LOCK(pool) ((void)(pool))
+#endif
+
+#if !defined(KR_CONFIG_POOL_UNLOCK)
+#define KR_CONFIG_POOL_UNLOCK(pool) ((void)(pool))
+#endif
+
+#if !defined(KR_CONFIG_POOL_CACHEBATCH)
+#define KR_CONFIG_POOL_CACHEBATCH (32)
+#endif
+
 #if !defined(KR_MALLOC)
 #define KR_MALLOC(sz) (malloc((sz)))
 #endif
@@ -130,6 +163,56 @@
 #define KR_SIZEOF_SIZE_T (INT_WIDTH / CHAR_BIT)
 #endif /* (KR_GNUC || KR_CLANG) */
 
+/*
+ * Instruction set detection.
+ *
+ * These only reflect what the compiler was told it could target, not what
+ * the running CPU supports.  Define any of these to 0 ahead of time to keep
+ * kruft from using that instruction set.
+ */
+
+#if !defined(KR_SSE2)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KR_SSE2 (1)
+#else
+#define KR_SSE2 (0)
+#endif
+#endif /* !defined(KR_SSE2) */
+
+#if !defined(KR_SSE42)
+#if defined(__SSE4_2__) || ((KR_MSC_VER) && defined(__AVX__))
+#define KR_SSE42 (1)
+#else
+#define KR_SSE42 (0)
+#endif
+#endif /* !defined(KR_SSE42) */
+
+#if !defined(KR_AVX2)
+#if defined(__AVX2__)
+#define KR_AVX2 (1)
+#else
+#define KR_AVX2 (0)
+#endif
+#endif /* !defined(KR_AVX2) */
+
+/* pdep and pext are microcoded and slow on AMD CPUs before Zen 3, so
+ * consider defining KR_BMI2 to 0 if targeting those. */
+#if !defined(KR_BMI2)
+#if defined(__BMI2__) || ((KR_MSC_VER) && defined(__AVX2__))
+#define KR_BMI2 (1)
+#else
+#define KR_BMI2 (0)
+#endif
+#endif /* !defined(KR_BMI2) */
+
+#if !defined(KR_NEON)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define KR_NEON (1)
+#else
+#define KR_NEON (0)
+#endif
+#endif /* !defined(KR_NEON) */
+
 /* Language and compiler feature shims. */
 
 #if (KR_CPLUSPLUS >= 199711)
@@ -156,6 +239,29 @@
 #define KR_CONSTEXPR KR_INLINE
 #endif
 
+/*
+ * Allows a constexpr function to take a faster path that is not allowed
+ * in constant expressions.  If we can't tell, assume we're constant.
+ */
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define KR_HAS_IS_CONSTANT_EVALUATED_
+#endif /* __has_builtin(__builtin_is_constant_evaluated) */
+#elif (KR_GNUC >= 9 && !KR_CLANG) || (KR_MSC_VER >= 1925)
+#define KR_HAS_IS_CONSTANT_EVALUATED_
+#endif /* defined(__has_builtin) */
+
+#if (KR_CPLUSPLUS >= 201402) && defined(KR_HAS_IS_CONSTANT_EVALUATED_)
+#define KR_IS_CONSTANT_EVALUATED() (__builtin_is_constant_evaluated())
+#elif (KR_CPLUSPLUS >= 201402)
+#define KR_IS_CONSTANT_EVALUATED() (1)
+#else
+#define KR_IS_CONSTANT_EVALUATED() (0)
+#endif
+
+#undef KR_HAS_IS_CONSTANT_EVALUATED_
+
 #if (KR_MSC_VER)
 #define KR_FORCEINLINE __forceinline
 #elif (KR_GNUC || KR_CLANG)
@@ -192,6 +298,14 @@
 #define KR_NOEXCEPT
 #endif
 
+#if (KR_MSC_VER >= 1928) /* Visual C++ 2019 16.9 */
+#define KR_NOSANITIZE_ADDRESS __declspec(no_sanitize_address)
+#elif (KR_GNUC || KR_CLANG)
+#define KR_NOSANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define KR_NOSANITIZE_ADDRESS
+#endif
+
 #if (KR_MSC_VER)
 #define KR_RESTRICT __restrict
 #elif (KR_GNUC || KR_CLANG)
@@ -216,4 +330,27 @@
 #define KR_UNREACHABLE()
 #endif
 
+/*
+ * Strictest alignment of a fundamental type, for allocators that hand out
+ * memory of no particular type.  Using it needs offsetof from <stddef.h>.
+ */
+
+struct kr_max_align_detail_s
+{
+    char c;
+    union
+    {
+        long double ld;
+        double d;
+#if (KR_STDC_VERSION >= 199901) || (KR_CPLUSPLUS >= 201103)
+        long long ll;
+#endif
+        long l;
+        void *p;
+        void (*fp)(void);
+    } u;
+};
+
+#define KR_MAX_ALIGN (offsetof(struct kr_max_align_detail_s, u))
+
 #endif /* !defined(KRCONFIG_H) */
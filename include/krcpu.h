@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * Runtime CPU feature detection.
+ *
+ * The instruction set macros in krconfig.h only say what the compiler was
+ * allowed to target, so a binary built for baseline x86-64 never uses
+ * anything newer than SSE2.  This header asks the running CPU what it
+ * supports, using cpuid on x86 and the auxiliary vector on ARM Linux, and
+ * caches the answer so kernels can cheaply pick a faster path.
+ *
+ * Kernels that dispatch compile their faster paths with KR_CPU_TARGET, so
+ * the rest of the program is not built for an instruction set the CPU might
+ * lack.  If the compiler was already allowed to target an instruction set,
+ * kernels use it directly and never consult this header.
+ *
+ * User configuration settings:
+ *
+ * KR_CPU_DISPATCH:
+ *	If non-zero, kernels built without KR_AVX2 check at runtime whether they
+ *  can use it anyway.  Defaults to 1 on x86 with GCC 5, Clang or Visual
+ *  C++ 2013 and newer, and 0 everywhere else.
+ */
+
+#if !defined(KRCPU_H)
+#define KRCPU_H
+
+#include "./krconfig.h"
+
+#include "./krbool.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define KR_CPU_X86 (1)
+#else
+#define KR_CPU_X86 (0)
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define KR_CPU_ARM64 (1)
+#else
+#define KR_CPU_ARM64 (0)
+#endif
+
+#if !defined(KR_CPU_DISPATCH)
+#if (KR_CPU_X86) && ((KR_GNUC >= 5) || (KR_CLANG) || (KR_MSC_VER >= 1800))
+#define KR_CPU_DISPATCH (1)
+#else
+#define KR_CPU_DISPATCH (0)
+#endif
+#endif /* !defined(KR_CPU_DISPATCH) */
+
+/**
+ * @brief Compile a function for an instruction set the rest of the program
+ *        might not be built for, such as "avx2" or "popcnt".
+ *
+ * @details Visual C++ allows any intrinsic anywhere, so this expands to
+ *          nothing there.
+ */
+#if (KR_GNUC || KR_CLANG) && (KR_CPU_X86)
+#define KR_CPU_TARGET(isa) __attribute__((target(isa)))
+#else
+#define KR_CPU_TARGET(isa)
+#endif
+
+#if (!KR_CONFIG_NOINCLUDE)
+#if (KR_MSC_VER) && (KR_CPU_X86)
+#include <immintrin.h>
+#include <intrin.h>
+#elif defined(__linux__) && (defined(__arm__) || defined(__aarch64__))
+#include <sys/auxv.h>
+#endif
+
+#if (KR_CPLUSPLUS >= 201103)
+#include <atomic>
+#elif (KR_STDC_VERSION >= 201112) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#endif
+#endif
+
+/*
+ * Feature flags.  A flag is only set if both the CPU and the operating
+ * system support the feature, so AVX and AVX2 also require the OS to save
+ * the upper halves of the vector registers.
+ */
+
+#define KR_CPU_SSE2 (0x1UL)
+#define KR_CPU_SSSE3 (0x2UL)
+#define KR_CPU_SSE41 (0x4UL)
+#define KR_CPU_SSE42 (0x8UL)
+#define KR_CPU_POPCNT (0x10UL)
+#define KR_CPU_LZCNT (0x20UL)
+#define KR_CPU_BMI1 (0x40UL)
+#define KR_CPU_BMI2 (0x80UL)
+#define KR_CPU_AVX (0x100UL)
+#define KR_CPU_AVX2 (0x200UL)
+#define KR_CPU_PCLMUL (0x400UL)
+#define KR_CPU_NEON (0x10000UL)
+#define KR_CPU_CRC32 (0x20000UL)
+#define KR_CPU_PMULL (0x40000UL)
+
+/**
+ * @brief Ask the CPU which features it supports, without caching.
+ *
+ * @return Bitwise OR of KR_CPU_* flags.
+ */
+KR_INLINE unsigned long kr_cpu_detect(void);
+
+/**
+ * @brief Get the features of the running CPU, detecting them on first use.
+ *
+ * @details Detection always gives the same answer, so threads that race to
+ *          detect at the same time store the same value.  The cache is read
+ *          and written with relaxed atomics, or on compilers without them,
+ *          this must be called once before starting any threads.  In C,
+ *          every translation unit has its own cache.
+ *
+ * @return Bitwise OR of KR_CPU_* flags.
+ */
+KR_INLINE unsigned long kr_cpu_features(void);
+
+/**
+ * @brief Check if the running CPU supports every one of a set of features.
+ *
+ * @param features Bitwise OR of KR_CPU_* flags.
+ * @return true if every feature is supported.
+ */
+KR_INLINE bool kr_cpu_has(unsigned long features);
+
+/**
+ * @brief Replace the cached features, so kernels behave as if running on a
+ *        different CPU.
+ *
+ * @details Meant for testing and benchmarking fallback paths.  Never pass a
+ *          feature that kr_cpu_detect did not report.
+ *
+ * @param features Bitwise OR of KR_CPU_* flags.
+ */
+KR_INLINE void kr_cpu_set_features(unsigned long features);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/**
+ * @brief Marks the cache as filled, even if no features were found.
+ */
+#define KR_CPU_DETECTED_DETAIL_ (0x80000000UL)
+
+/*
+ * The cached features, and loads and stores of them.  Every thread stores
+ * the same value, so only atomicity is needed, not ordering.
+ */
+
+#if (KR_CPLUSPLUS >= 201103)
+#define KR_CPU_ATOMIC_DETAIL_ std::atomic<unsigned long>
+#define KR_CPU_LOAD_DETAIL_(p) ((p)->load(std::memory_order_relaxed))
+#define KR_CPU_STORE_DETAIL_(p, v) ((p)->store((v), std::memory_order_relaxed))
+#elif (KR_STDC_VERSION >= 201112) && !defined(__STDC_NO_ATOMICS__)
+#define KR_CPU_ATOMIC_DETAIL_ _Atomic unsigned long
+#define KR_CPU_LOAD_DETAIL_(p) (atomic_load_explicit((p), memory_order_relaxed))
+#define KR_CPU_STORE_DETAIL_(p, v) (atomic_store_explicit((p), (v), memory_order_relaxed))
+#elif (KR_GNUC || KR_CLANG)
+#define KR_CPU_ATOMIC_DETAIL_ unsigned long
+#define KR_CPU_LOAD_DETAIL_(p) (__atomic_load_n((p), __ATOMIC_RELAXED))
+#define KR_CPU_STORE_DETAIL_(p, v) (__atomic_store_n((p), (v), __ATOMIC_RELAXED))
+#else /* Visual C++ reads and writes an aligned long in one access. */
+#define KR_CPU_ATOMIC_DETAIL_ volatile unsigned long
+#define KR_CPU_LOAD_DETAIL_(p) (*(p))
+#define KR_CPU_STORE_DETAIL_(p, v) (*(p) = (v))
+#endif
+
+KR_INLINE KR_CPU_ATOMIC_DETAIL_ *kr_cpu_cache_detail_(void)
+{
+    static KR_CPU_ATOMIC_DETAIL_ cache;
+    return &cache;
+}
+
+#if (KR_CPU_X86) && ((KR_GNUC || KR_CLANG) || (KR_MSC_VER))
+
+KR_INLINE void kr_cpu_cpuid_detail_(unsigned long regs[4], unsigned long leaf, unsigned long sub)
+{
+#if (KR_MSC_VER) && !(KR_CLANG)
+    int r[4];
+    __cpuidex(r, KR_CASTS(int, leaf), KR_CASTS(int, sub));
+    regs[0] = KR_CASTS(unsigned long, KR_CASTS(unsigned int, r[0]));
+    regs[1] = KR_CASTS(unsigned long, KR_CASTS(unsigned int, r[1]));
+    regs[2] = KR_CASTS(unsigned long, KR_CASTS(unsigned int, r[2]));
+    regs[3] = KR_CASTS(unsigned long, KR_CASTS(unsigned int, r[3]));
+#else
+    unsigned int a = 0, b = 0, c = 0, d = 0;
+#if defined(__i386__) && defined(__PIC__)
+    /* ebx holds the GOT pointer, and GCC before 5 refuses to give it up, so
+     * swap it out around cpuid instead. */
+    __asm__ __volatile__("xchgl %%ebx, %1\n\t"
+                         "cpuid\n\t"
+                         "xchgl %%ebx, %1"
+                         : "=a"(a), "=&r"(b), "=c"(c), "=d"(d)
+                         : "a"(KR_CASTS(unsigned int, leaf)), "c"(KR_CASTS(unsigned int, sub)));
+#else
+    __asm__ __volatile__("cpuid"
+                         : "=a"(a), "=b"(b), "=c"(c), "=d"(d)
+                         : "a"(KR_CASTS(unsigned int, leaf)), "c"(KR_CASTS(unsigned int, sub)));
+#endif
+    regs[0] = a;
+    regs[1] = b;
+    regs[2] = c;
+    regs[3] = d;
+#endif
+}
+
+/**
+ * @brief Read the low half of XCR0, which says which register state the OS
+ *        saves on a context switch.
+ */
+KR_INLINE unsigned long kr_cpu_xcr0_detail_(void)
+{
+#if (KR_MSC_VER) && !(KR_CLANG)
+    return KR_CASTS(unsigned long, _xgetbv(0) & 0xFFFFFFFF);
+#else
+    unsigned int lo = 0, hi = 0;
+    /* xgetbv, spelled out for assemblers that predate it. */
+    __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0));
+    (void)hi;
+    return lo;
+#endif
+}
+
+KR_INLINE unsigned long kr_cpu_detect(void)
+{
+    unsigned long regs[4];
+    unsigned long features = 0, maxLeaf = 0, maxExt = 0;
+
+    kr_cpu_cpuid_detail_(regs, 0, 0);
+    maxLeaf = regs[0];
+    if (maxLeaf < 1)
+    {
+        return 0;
+    }
+
+    kr_cpu_cpuid_detail_(regs, 1, 0);
+    features |= (regs[3] & (1UL << 26)) ? KR_CPU_SSE2 : 0;
+    features |= (regs[2] & (1UL << 1)) ? KR_CPU_PCLMUL : 0;
+    features |= (regs[2] & (1UL << 9)) ? KR_CPU_SSSE3 : 0;
+    features |= (regs[2] & (1UL << 19)) ? KR_CPU_SSE41 : 0;
+    features |= (regs[2] & (1UL << 20)) ? KR_CPU_SSE42 : 0;
+    features |= (regs[2] & (1UL << 23)) ? KR_CPU_POPCNT : 0;
+
+    /* AVX also needs the OS to save the YMM registers, which it reports
+     * with OSXSAVE and XCR0. */
+    if ((regs[2] & (1UL << 27)) && (regs[2] & (1UL << 28)) && (kr_cpu_xcr0_detail_() & 0x6) == 0x6)
+    {
+        features |= KR_CPU_AVX;
+    }
+
+    if (maxLeaf >= 7)
+    {
+        kr_cpu_cpuid_detail_(regs, 7, 0);
+        features |= (regs[1] & (1UL << 3)) ? KR_CPU_BMI1 : 0;
+        features |= (regs[1] & (1UL << 8)) ? KR_CPU_BMI2 : 0;
+        features |= ((regs[1] & (1UL << 5)) && (features & KR_CPU_AVX)) ? KR_CPU_AVX2 : 0;
+    }
+
+    kr_cpu_cpuid_detail_(regs, 0x80000000UL, 0);
+    maxExt = regs[0];
+    if (maxExt >= 0x80000001UL)
+    {
+        kr_cpu_cpuid_detail_(regs, 0x80000001UL, 0);
+        features |= (regs[2] & (1UL << 5)) ? KR_CPU_LZCNT : 0;
+    }
+
+    return features;
+}
+
+#else /* (KR_CPU_X86) && ((KR_GNUC || KR_CLANG) || (KR_MSC_VER)) */
+
+KR_INLINE unsigned long kr_cpu_detect(void)
+{
+    unsigned long features = 0;
+
+#if (KR_NEON)
+    features |= KR_CPU_NEON;
+#endif
+#if defined(__ARM_FEATURE_CRC32)
+    features |= KR_CPU_CRC32;
+#endif
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES)
+    features |= KR_CPU_PMULL;
+#endif
+
+#if (!KR_CONFIG_NOINCLUDE) && defined(__linux__) && defined(__aarch64__)
+    {
+        const unsigned long hwcap = getauxval(AT_HWCAP);
+        features |= (hwcap & (1UL << 1)) ? KR_CPU_NEON : 0;
+        features |= (hwcap & (1UL << 4)) ? KR_CPU_PMULL : 0;
+        features |= (hwcap & (1UL << 7)) ? KR_CPU_CRC32 : 0;
+    }
+#elif (!KR_CONFIG_NOINCLUDE) && defined(__linux__) && defined(__arm__)
+    {
+        const unsigned long hwcap = getauxval(AT_HWCAP), hwcap2 = getauxval(AT_HWCAP2);
+        features |= (hwcap & (1UL << 12)) ? KR_CPU_NEON : 0;
+        features |= (hwcap2 & (1UL << 1)) ? KR_CPU_PMULL : 0;
+        features |= (hwcap2 & (1UL << 4)) ? KR_CPU_CRC32 : 0;
+    }
+#elif defined(__APPLE__) && (KR_CPU_ARM64)
+    /* Every Apple ARM64 CPU has these. */
+    features |= KR_CPU_NEON | KR_CPU_PMULL | KR_CPU_CRC32;
+#endif
+
+    return features;
+}
+
+#endif /* (KR_CPU_X86) && ((KR_GNUC || KR_CLANG) || (KR_MSC_VER)) */
+
+KR_INLINE unsigned long kr_cpu_features(void)
+{
+    KR_CPU_ATOMIC_DETAIL_ *cache = kr_cpu_cache_detail_();
+    unsigned long features = KR_CPU_LOAD_DETAIL_(cache);
+    if (features == 0)
+    {
+        features = kr_cpu_detect() | KR_CPU_DETECTED_DETAIL_;
+        KR_CPU_STORE_DETAIL_(cache, features);
+    }
+    return features;
+}
+
+KR_INLINE bool kr_cpu_has(unsigned long features)
+{
+    return (kr_cpu_features() & features) == features;
+}
+
+KR_INLINE void kr_cpu_set_features(unsigned long features)
+{
+    KR_CPU_STORE_DETAIL_(kr_cpu_cache_detail_(), features | KR_CPU_DETECTED_DETAIL_);
+}
+
+#undef KR_CPU_DETECTED_DETAIL_
+#undef KR_CPU_ATOMIC_DETAIL_
+#undef KR_CPU_LOAD_DETAIL_
+#undef KR_CPU_STORE_DETAIL_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRCPU_H) */
@@ -0,0 +1,712 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * Space-filling curves, for laying out 2D and 3D grids so that cells close
+ * together in space are close together in memory.
+ *
+ * Morton (Z-order) codes interleave the bits of each coordinate, with x in
+ * the lowest bit.  They are cheap to compute, and every function comes in
+ * two flavors: one that spreads bits with magic-number shifts and masks, or
+ * pdep and pext with KR_BMI2, and one that looks up a byte at a time in a
+ * table.  Which one is faster depends on the CPU and the surrounding loop,
+ * so measure.
+ *
+ * Hilbert curves have better locality than Morton codes, since consecutive
+ * indexes are always next to each other, at the cost of more work per
+ * point.  These use the branch-free prefix scan by rawrunprotected:
+ *  <http://threadlocalmutex.com/?p=126>
+ *
+ * Like krbit.h, this header is allowed to break the "no cleverness" rule.
+ */
+
+#if !defined(KRCURVE_H)
+#define KRCURVE_H
+
+#include "./krconfig.h"
+
+#include "./krbltin.h"
+#include "./krint.h"
+
+/**
+ * @brief Interleave two 8-bit coordinates into a 16-bit Morton code.
+ */
+KR_CONSTEXPR uint16_t kr_morton2_encode16(uint8_t x, uint8_t y) KR_NOEXCEPT;
+
+/**
+ * @brief Interleave two 16-bit coordinates into a 32-bit Morton code.
+ */
+KR_CONSTEXPR uint32_t kr_morton2_encode32(uint16_t x, uint16_t y) KR_NOEXCEPT;
+
+/**
+ * @brief Split a 16-bit Morton code into two 8-bit coordinates.
+ */
+KR_CONSTEXPR void kr_morton2_decode16(uint16_t code, uint8_t *x, uint8_t *y) KR_NOEXCEPT;
+
+/**
+ * @brief Split a 32-bit Morton code into two 16-bit coordinates.
+ */
+KR_CONSTEXPR void kr_morton2_decode32(uint32_t code, uint16_t *x, uint16_t *y) KR_NOEXCEPT;
+
+/**
+ * @brief Interleave three 5-bit coordinates into a 15-bit Morton code.
+ *        Higher coordinate bits are ignored.
+ */
+KR_CONSTEXPR uint16_t kr_morton3_encode16(uint8_t x, uint8_t y, uint8_t z) KR_NOEXCEPT;
+
+/**
+ * @brief Interleave three 10-bit coordinates into a 30-bit Morton code.
+ *        Higher coordinate bits are ignored.
+ */
+KR_CONSTEXPR uint32_t kr_morton3_encode32(uint16_t x, uint16_t y, uint16_t z) KR_NOEXCEPT;
+
+/**
+ * @brief Split a 15-bit Morton code into three 5-bit coordinates.
+ */
+KR_CONSTEXPR void kr_morton3_decode16(uint16_t code, uint8_t *x, uint8_t *y, uint8_t *z) KR_NOEXCEPT;
+
+/**
+ * @brief Split a 30-bit Morton code into three 10-bit coordinates.
+ */
+KR_CONSTEXPR void kr_morton3_decode32(uint32_t code, uint16_t *x, uint16_t *y, uint16_t *z) KR_NOEXCEPT;
+
+/**
+ * @brief kr_morton2_encode16 using table lookups.
+ */
+KR_CONSTEXPR uint16_t kr_morton2_encode16_table(uint8_t x, uint8_t y) KR_NOEXCEPT;
+
+/**
+ * @brief kr_morton2_encode32 using table lookups.
+ */
+KR_CONSTEXPR uint32_t kr_morton2_encode32_table(uint16_t x, uint16_t y) KR_NOEXCEPT;
+
+/**
+ * @brief kr_morton3_encode16 using table lookups.
+ */
+KR_CONSTEXPR uint16_t kr_morton3_encode16_table(uint8_t x, uint8_t y, uint8_t z) KR_NOEXCEPT;
+
+/**
+ * @brief kr_morton3_encode32 using table lookups.
+ */
+KR_CONSTEXPR uint32_t kr_morton3_encode32_table(uint16_t x, uint16_t y, uint16_t z) KR_NOEXCEPT;
+
+/**
+ * @brief Find the index of a point along a 2D Hilbert curve.
+ *
+ * @param x X coordinate, less than 2^order.
+ * @param y Y coordinate, less than 2^order.
+ * @param order Number of bits in each coordinate, from 1 to 16.  The curve
+ *        covers a 2^order by 2^order grid, and starts at (0, 0) and ends at
+ *        (2^order - 1, 0).
+ * @return Index along the curve, less than 4^order.
+ */
+KR_CONSTEXPR uint32_t kr_hilbert2_encode32(uint16_t x, uint16_t y, unsigned order) KR_NOEXCEPT;
+
+/**
+ * @brief Find the point at an index along a 2D Hilbert curve.
+ *
+ * @param index Index along the curve, less than 4^order.
+ * @param order Number of bits in each coordinate, from 1 to 16.
+ * @param x Output X coordinate.
+ * @param y Output Y coordinate.
+ */
+KR_CONSTEXPR void kr_hilbert2_decode32(uint32_t index, unsigned order, uint16_t *x, uint16_t *y) KR_NOEXCEPT;
+
+#if defined(UINT64_MAX)
+
+/**
+ * @brief Interleave two 32-bit coordinates into a 64-bit Morton code.
+ */
+KR_CONSTEXPR uint64_t kr_morton2_encode64(uint32_t x, uint32_t y) KR_NOEXCEPT;
+
+/**
+ * @brief Split a 64-bit Morton code into two 32-bit coordinates.
+ */
+KR_CONSTEXPR void kr_morton2_decode64(uint64_t code, uint32_t *x, uint32_t *y) KR_NOEXCEPT;
+
+/**
+ * @brief Interleave three 21-bit coordinates into a 63-bit Morton code.
+ *        Higher coordinate bits are ignored.
+ */
+KR_CONSTEXPR uint64_t kr_morton3_encode64(uint32_t x, uint32_t y, uint32_t z) KR_NOEXCEPT;
+
+/**
+ * @brief Split a 63-bit Morton code into three 21-bit coordinates.
+ */
+KR_CONSTEXPR void kr_morton3_decode64(uint64_t code, uint32_t *x, uint32_t *y, uint32_t *z) KR_NOEXCEPT;
+
+/**
+ * @brief kr_morton2_encode64 using table lookups.
+ */
+KR_CONSTEXPR uint64_t kr_morton2_encode64_table(uint32_t x, uint32_t y) KR_NOEXCEPT;
+
+/**
+ * @brief kr_morton3_encode64 using table lookups.
+ */
+KR_CONSTEXPR uint64_t kr_morton3_encode64_table(uint32_t x, uint32_t y, uint32_t z) KR_NOEXCEPT;
+
+/**
+ * @brief Find the index of a point along a 2D Hilbert curve.
+ *
+ * @param x X coordinate, less than 2^order.
+ * @param y Y coordinate, less than 2^order.
+ * @param order Number of bits in each coordinate, from 1 to 32.
+ * @return Index along the curve, less than 4^order.  The same as
+ *         kr_hilbert2_encode32 for orders up to 16.
+ */
+KR_CONSTEXPR uint64_t kr_hilbert2_encode64(uint32_t x, uint32_t y, unsigned order) KR_NOEXCEPT;
+
+/**
+ * @brief Find the point at an index along a 2D Hilbert curve.
+ *
+ * @param index Index along the curve, less than 4^order.
+ * @param order Number of bits in each coordinate, from 1 to 32.
+ * @param x Output X coordinate.
+ * @param y Output Y coordinate.
+ */
+KR_CONSTEXPR void kr_hilbert2_decode64(uint64_t index, unsigned order, uint32_t *x, uint32_t *y) KR_NOEXCEPT;
+
+#endif /* defined(UINT64_MAX) */
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/*
+ * Tables that spread the bits of a byte out to every second or every third
+ * bit, starting with the LSB.  C++ keeps them in a class template, so every
+ * translation unit shares one copy, and makes them constexpr wherever the
+ * encoders are.
+ */
+
+#if (KR_CPLUSPLUS)
+template <typename T>
+struct kr_curve_tables_detail_s
+{
+    static const uint16_t spread2[256];
+    static const uint32_t spread3[256];
+};
+
+#if (KR_CPLUSPLUS >= 201402)
+#define KR_CURVE_TABLE_DETAIL_(type, name) template <typename T> constexpr type kr_curve_tables_detail_s<T>::name[256]
+#else
+#define KR_CURVE_TABLE_DETAIL_(type, name) template <typename T> const type kr_curve_tables_detail_s<T>::name[256]
+#endif
+#define KR_CURVE_SPREAD2_DETAIL_ (kr_curve_tables_detail_s<void>::spread2)
+#define KR_CURVE_SPREAD3_DETAIL_ (kr_curve_tables_detail_s<void>::spread3)
+#else
+#define KR_CURVE_TABLE_DETAIL_(type, name) static const type kr_curve_##name##_detail_[256]
+#define KR_CURVE_SPREAD2_DETAIL_ (kr_curve_spread2_detail_)
+#define KR_CURVE_SPREAD3_DETAIL_ (kr_curve_spread3_detail_)
+#endif /* (KR_CPLUSPLUS) */
+
+KR_CURVE_TABLE_DETAIL_(uint16_t, spread2) = {
+    0x0000, 0x0001, 0x0004, 0x0005, 0x0010, 0x0011, 0x0014, 0x0015,
+    0x0040, 0x0041, 0x0044, 0x0045, 0x0050, 0x0051, 0x0054, 0x0055,
+    0x0100, 0x0101, 0x0104, 0x0105, 0x0110, 0x0111, 0x0114, 0x0115,
+    0x0140, 0x0141, 0x0144, 0x0145, 0x0150, 0x0151, 0x0154, 0x0155,
+    0x0400, 0x0401, 0x0404, 0x0405, 0x0410, 0x0411, 0x0414, 0x0415,
+    0x0440, 0x0441, 0x0444, 0x0445, 0x0450, 0x0451, 0x0454, 0x0455,
+    0x0500, 0x0501, 0x0504, 0x0505, 0x0510, 0x0511, 0x0514, 0x0515,
+    0x0540, 0x0541, 0x0544, 0x0545, 0x0550, 0x0551, 0x0554, 0x0555,
+    0x1000, 0x1001, 0x1004, 0x1005, 0x1010, 0x1011, 0x1014, 0x1015,
+    0x1040, 0x1041, 0x1044, 0x1045, 0x1050, 0x1051, 0x1054, 0x1055,
+    0x1100, 0x1101, 0x1104, 0x1105, 0x1110, 0x1111, 0x1114, 0x1115,
+    0x1140, 0x1141, 0x1144, 0x1145, 0x1150, 0x1151, 0x1154, 0x1155,
+    0x1400, 0x1401, 0x1404, 0x1405, 0x1410, 0x1411, 0x1414, 0x1415,
+    0x1440, 0x1441, 0x1444, 0x1445, 0x1450, 0x1451, 0x1454, 0x1455,
+    0x1500, 0x1501, 0x1504, 0x1505, 0x1510, 0x1511, 0x1514, 0x1515,
+    0x1540, 0x1541, 0x1544, 0x1545, 0x1550, 0x1551, 0x1554, 0x1555,
+    0x4000, 0x4001, 0x4004, 0x4005, 0x4010, 0x4011, 0x4014, 0x4015,
+    0x4040, 0x4041, 0x4044, 0x4045, 0x4050, 0x4051, 0x4054, 0x4055,
+    0x4100, 0x4101, 0x4104, 0x4105, 0x4110, 0x4111, 0x4114, 0x4115,
+    0x4140, 0x4141, 0x4144, 0x4145, 0x4150, 0x4151, 0x4154, 0x4155,
+    0x4400, 0x4401, 0x4404, 0x4405, 0x4410, 0x4411, 0x4414, 0x4415,
+    0x4440, 0x4441, 0x4444, 0x4445, 0x4450, 0x4451, 0x4454, 0x4455,
+    0x4500, 0x4501, 0x4504, 0x4505, 0x4510, 0x4511, 0x4514, 0x4515,
+    0x4540, 0x4541, 0x4544, 0x4545, 0x4550, 0x4551, 0x4554, 0x4555,
+    0x5000, 0x5001, 0x5004, 0x5005, 0x5010, 0x5011, 0x5014, 0x5015,
+    0x5040, 0x5041, 0x5044, 0x5045, 0x5050, 0x5051, 0x5054, 0x5055,
+    0x5100, 0x5101, 0x5104, 0x5105, 0x5110, 0x5111, 0x5114, 0x5115,
+    0x5140, 0x5141, 0x5144, 0x5145, 0x5150, 0x5151, 0x5154, 0x5155,
+    0x5400, 0x5401, 0x5404, 0x5405, 0x5410, 0x5411, 0x5414, 0x5415,
+    0x5440, 0x5441, 0x5444, 0x5445, 0x5450, 0x5451, 0x5454, 0x5455,
+    0x5500, 0x5501, 0x5504, 0x5505, 0x5510, 0x5511, 0x5514, 0x5515,
+    0x5540, 0x5541, 0x5544, 0x5545, 0x5550, 0x5551, 0x5554, 0x5555
+};
+
+KR_CURVE_TABLE_DETAIL_(uint32_t, spread3) = {
+    0x000000, 0x000001, 0x000008, 0x000009, 0x000040, 0x000041, 0x000048, 0x000049,
+    0x000200, 0x000201, 0x000208, 0x000209, 0x000240, 0x000241, 0x000248, 0x000249,
+    0x001000, 0x001001, 0x001008, 0x001009, 0x001040, 0x001041, 0x001048, 0x001049,
+    0x001200, 0x001201, 0x001208, 0x001209, 0x001240, 0x001241, 0x001248, 0x001249,
+    0x008000, 0x008001, 0x008008, 0x008009, 0x008040, 0x008041, 0x008048, 0x008049,
+    0x008200, 0x008201, 0x008208, 0x008209, 0x008240, 0x008241, 0x008248, 0x008249,
+    0x009000, 0x009001, 0x009008, 0x009009, 0x009040, 0x009041, 0x009048, 0x009049,
+    0x009200, 0x009201, 0x009208, 0x009209, 0x009240, 0x009241, 0x009248, 0x009249,
+    0x040000, 0x040001, 0x040008, 0x040009, 0x040040, 0x040041, 0x040048, 0x040049,
+    0x040200, 0x040201, 0x040208, 0x040209, 0x040240, 0x040241, 0x040248, 0x040249,
+    0x041000, 0x041001, 0x041008, 0x041009, 0x041040, 0x041041, 0x041048, 0x041049,
+    0x041200, 0x041201, 0x041208, 0x041209, 0x041240, 0x041241, 0x041248, 0x041249,
+    0x048000, 0x048001, 0x048008, 0x048009, 0x048040, 0x048041, 0x048048, 0x048049,
+    0x048200, 0x048201, 0x048208, 0x048209, 0x048240, 0x048241, 0x048248, 0x048249,
+    0x049000, 0x049001, 0x049008, 0x049009, 0x049040, 0x049041, 0x049048, 0x049049,
+    0x049200, 0x049201, 0x049208, 0x049209, 0x049240, 0x049241, 0x049248, 0x049249,
+    0x200000, 0x200001, 0x200008, 0x200009, 0x200040, 0x200041, 0x200048, 0x200049,
+    0x200200, 0x200201, 0x200208, 0x200209, 0x200240, 0x200241, 0x200248, 0x200249,
+    0x201000, 0x201001, 0x201008, 0x201009, 0x201040, 0x201041, 0x201048, 0x201049,
+    0x201200, 0x201201, 0x201208, 0x201209, 0x201240, 0x201241, 0x201248, 0x201249,
+    0x208000, 0x208001, 0x208008, 0x208009, 0x208040, 0x208041, 0x208048, 0x208049,
+    0x208200, 0x208201, 0x208208, 0x208209, 0x208240, 0x208241, 0x208248, 0x208249,
+    0x209000, 0x209001, 0x209008, 0x209009, 0x209040, 0x209041, 0x209048, 0x209049,
+    0x209200, 0x209201, 0x209208, 0x209209, 0x209240, 0x209241, 0x209248, 0x209249,
+    0x240000, 0x240001, 0x240008, 0x240009, 0x240040, 0x240041, 0x240048, 0x240049,
+    0x240200, 0x240201, 0x240208, 0x240209, 0x240240, 0x240241, 0x240248, 0x240249,
+    0x241000, 0x241001, 0x241008, 0x241009, 0x241040, 0x241041, 0x241048, 0x241049,
+    0x241200, 0x241201, 0x241208, 0x241209, 0x241240, 0x241241, 0x241248, 0x241249,
+    0x248000, 0x248001, 0x248008, 0x248009, 0x248040, 0x248041, 0x248048, 0x248049,
+    0x248200, 0x248201, 0x248208, 0x248209, 0x248240, 0x248241, 0x248248, 0x248249,
+    0x249000, 0x249001, 0x249008, 0x249009, 0x249040, 0x249041, 0x249048, 0x249049,
+    0x249200, 0x249201, 0x249208, 0x249209, 0x249240, 0x249241, 0x249248, 0x249249
+};
+
+/******************************************************************************/
+
+/*
+ * Spread the low bits of a value out to every second or every third bit,
+ * and compact them back again.
+ */
+
+KR_CONSTEXPR uint32_t kr_curve_part2_32_detail_(uint32_t x) KR_NOEXCEPT
+{
+#if (KR_BMI2)
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_pdep32(x, UINT32_C(0x55555555));
+    }
+#endif /* (KR_BMI2) */
+
+    x &= UINT32_C(0x0000FFFF);
+    x = (x | (x << 8)) & UINT32_C(0x00FF00FF);
+    x = (x | (x << 4)) & UINT32_C(0x0F0F0F0F);
+    x = (x | (x << 2)) & UINT32_C(0x33333333);
+    x = (x | (x << 1)) & UINT32_C(0x55555555);
+    return x;
+}
+
+KR_CONSTEXPR uint32_t kr_curve_compact2_32_detail_(uint32_t x) KR_NOEXCEPT
+{
+#if (KR_BMI2)
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_pext32(x, UINT32_C(0x55555555));
+    }
+#endif /* (KR_BMI2) */
+
+    x &= UINT32_C(0x55555555);
+    x = (x | (x >> 1)) & UINT32_C(0x33333333);
+    x = (x | (x >> 2)) & UINT32_C(0x0F0F0F0F);
+    x = (x | (x >> 4)) & UINT32_C(0x00FF00FF);
+    x = (x | (x >> 8)) & UINT32_C(0x0000FFFF);
+    return x;
+}
+
+KR_CONSTEXPR uint32_t kr_curve_part3_32_detail_(uint32_t x) KR_NOEXCEPT
+{
+#if (KR_BMI2)
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_pdep32(x, UINT32_C(0x09249249));
+    }
+#endif /* (KR_BMI2) */
+
+    x &= UINT32_C(0x000003FF);
+    x = (x | (x << 16)) & UINT32_C(0x030000FF);
+    x = (x | (x << 8)) & UINT32_C(0x0300F00F);
+    x = (x | (x << 4)) & UINT32_C(0x030C30C3);
+    x = (x | (x << 2)) & UINT32_C(0x09249249);
+    return x;
+}
+
+KR_CONSTEXPR uint32_t kr_curve_compact3_32_detail_(uint32_t x) KR_NOEXCEPT
+{
+#if (KR_BMI2)
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_pext32(x, UINT32_C(0x09249249));
+    }
+#endif /* (KR_BMI2) */
+
+    x &= UINT32_C(0x09249249);
+    x = (x | (x >> 2)) & UINT32_C(0x030C30C3);
+    x = (x | (x >> 4)) & UINT32_C(0x0300F00F);
+    x = (x | (x >> 8)) & UINT32_C(0x030000FF);
+    x = (x | (x >> 16)) & UINT32_C(0x000003FF);
+    return x;
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR uint16_t kr_morton2_encode16(uint8_t x, uint8_t y) KR_NOEXCEPT
+{
+    return KR_CASTS(uint16_t, kr_curve_part2_32_detail_(x) | (kr_curve_part2_32_detail_(y) << 1));
+}
+
+KR_CONSTEXPR uint32_t kr_morton2_encode32(uint16_t x, uint16_t y) KR_NOEXCEPT
+{
+    return kr_curve_part2_32_detail_(x) | (kr_curve_part2_32_detail_(y) << 1);
+}
+
+KR_CONSTEXPR void kr_morton2_decode16(uint16_t code, uint8_t *x, uint8_t *y) KR_NOEXCEPT
+{
+    *x = KR_CASTS(uint8_t, kr_curve_compact2_32_detail_(code));
+    *y = KR_CASTS(uint8_t, kr_curve_compact2_32_detail_(KR_CASTS(uint32_t, code >> 1)));
+}
+
+KR_CONSTEXPR void kr_morton2_decode32(uint32_t code, uint16_t *x, uint16_t *y) KR_NOEXCEPT
+{
+    *x = KR_CASTS(uint16_t, kr_curve_compact2_32_detail_(code));
+    *y = KR_CASTS(uint16_t, kr_curve_compact2_32_detail_(code >> 1));
+}
+
+KR_CONSTEXPR uint16_t kr_morton3_encode16(uint8_t x, uint8_t y, uint8_t z) KR_NOEXCEPT
+{
+    return KR_CASTS(uint16_t, kr_curve_part3_32_detail_(x & 0x1Fu) | (kr_curve_part3_32_detail_(y & 0x1Fu) << 1) |
+                                  (kr_curve_part3_32_detail_(z & 0x1Fu) << 2));
+}
+
+KR_CONSTEXPR uint32_t kr_morton3_encode32(uint16_t x, uint16_t y, uint16_t z) KR_NOEXCEPT
+{
+    return kr_curve_part3_32_detail_(x & 0x3FFu) | (kr_curve_part3_32_detail_(y & 0x3FFu) << 1) |
+           (kr_curve_part3_32_detail_(z & 0x3FFu) << 2);
+}
+
+KR_CONSTEXPR void kr_morton3_decode16(uint16_t code, uint8_t *x, uint8_t *y, uint8_t *z) KR_NOEXCEPT
+{
+    *x = KR_CASTS(uint8_t, kr_curve_compact3_32_detail_(code & 0x7FFFu));
+    *y = KR_CASTS(uint8_t, kr_curve_compact3_32_detail_(KR_CASTS(uint32_t, (code & 0x7FFFu) >> 1)));
+    *z = KR_CASTS(uint8_t, kr_curve_compact3_32_detail_(KR_CASTS(uint32_t, (code & 0x7FFFu) >> 2)));
+}
+
+KR_CONSTEXPR void kr_morton3_decode32(uint32_t code, uint16_t *x, uint16_t *y, uint16_t *z) KR_NOEXCEPT
+{
+    *x = KR_CASTS(uint16_t, kr_curve_compact3_32_detail_(code));
+    *y = KR_CASTS(uint16_t, kr_curve_compact3_32_detail_(code >> 1));
+    *z = KR_CASTS(uint16_t, kr_curve_compact3_32_detail_(code >> 2));
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR uint16_t kr_morton2_encode16_table(uint8_t x, uint8_t y) KR_NOEXCEPT
+{
+    return KR_CASTS(uint16_t, KR_CURVE_SPREAD2_DETAIL_[x] | (KR_CURVE_SPREAD2_DETAIL_[y] << 1));
+}
+
+KR_CONSTEXPR uint32_t kr_morton2_encode32_table(uint16_t x, uint16_t y) KR_NOEXCEPT
+{
+    const uint32_t sx =
+        KR_CURVE_SPREAD2_DETAIL_[x & 0xFF] | (KR_CASTS(uint32_t, KR_CURVE_SPREAD2_DETAIL_[x >> 8]) << 16);
+    const uint32_t sy =
+        KR_CURVE_SPREAD2_DETAIL_[y & 0xFF] | (KR_CASTS(uint32_t, KR_CURVE_SPREAD2_DETAIL_[y >> 8]) << 16);
+    return sx | (sy << 1);
+}
+
+KR_CONSTEXPR uint16_t kr_morton3_encode16_table(uint8_t x, uint8_t y, uint8_t z) KR_NOEXCEPT
+{
+    return KR_CASTS(uint16_t, KR_CURVE_SPREAD3_DETAIL_[x & 0x1F] | (KR_CURVE_SPREAD3_DETAIL_[y & 0x1F] << 1) |
+                                  (KR_CURVE_SPREAD3_DETAIL_[z & 0x1F] << 2));
+}
+
+KR_CONSTEXPR uint32_t kr_morton3_encode32_table(uint16_t x, uint16_t y, uint16_t z) KR_NOEXCEPT
+{
+    const uint32_t sx = KR_CURVE_SPREAD3_DETAIL_[x & 0xFF] | (KR_CURVE_SPREAD3_DETAIL_[(x >> 8) & 0x3] << 24);
+    const uint32_t sy = KR_CURVE_SPREAD3_DETAIL_[y & 0xFF] | (KR_CURVE_SPREAD3_DETAIL_[(y >> 8) & 0x3] << 24);
+    const uint32_t sz = KR_CURVE_SPREAD3_DETAIL_[z & 0xFF] | (KR_CURVE_SPREAD3_DETAIL_[(z >> 8) & 0x3] << 24);
+    return sx | (sy << 1) | (sz << 2);
+}
+
+/******************************************************************************/
+
+/*
+ * The Hilbert curve is walked from the top bit down as a state machine with
+ * four states, kept as a pair of bitmasks per bit.  Composing the states is
+ * associative, so a prefix scan finds the state at every bit at once.
+ */
+
+KR_CONSTEXPR uint32_t kr_hilbert2_encode32(uint16_t x, uint16_t y, unsigned order) KR_NOEXCEPT
+{
+    const uint32_t hx = KR_CASTS(uint32_t, x) << (16 - order);
+    const uint32_t hy = KR_CASTS(uint32_t, y) << (16 - order);
+    uint32_t sa = 0, sb = 0, sc = 0, sd = 0;
+    uint32_t a = 0, b = 0, c = 0, d = 0, i0 = 0, i1 = 0;
+
+    /* The state after each bit on its own. */
+    a = hx ^ hy;
+    b = 0xFFFF ^ a;
+    c = 0xFFFF ^ (hx | hy);
+    d = hx & (hy ^ 0xFFFF);
+    sa = a | (b >> 1);
+    sb = (a >> 1) ^ a;
+    sc = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    sd = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    /* Compose with the states 2, 4 and 8 bits above. */
+    a = sa;
+    b = sb;
+    c = sc;
+    d = sd;
+    sa = (a & (a >> 2)) ^ (b & (b >> 2));
+    sb = (a & (b >> 2)) ^ (b & ((a ^ b) >> 2));
+    sc ^= (a & (c >> 2)) ^ (b & (d >> 2));
+    sd ^= (b & (c >> 2)) ^ ((a ^ b) & (d >> 2));
+
+    a = sa;
+    b = sb;
+    c = sc;
+    d = sd;
+    sa = (a & (a >> 4)) ^ (b & (b >> 4));
+    sb = (a & (b >> 4)) ^ (b & ((a ^ b) >> 4));
+    sc ^= (a & (c >> 4)) ^ (b & (d >> 4));
+    sd ^= (b & (c >> 4)) ^ ((a ^ b) & (d >> 4));
+
+    a = sa;
+    b = sb;
+    c = sc;
+    d = sd;
+    sc ^= (a & (c >> 8)) ^ (b & (d >> 8));
+    sd ^= (b & (c >> 8)) ^ ((a ^ b) & (d >> 8));
+
+    /* Undo the scan's transformation and recover the index bits. */
+    a = sc ^ (sc >> 1);
+    b = sd ^ (sd >> 1);
+    i0 = hx ^ hy;
+    i1 = b | (0xFFFF ^ (i0 | a));
+    return ((kr_curve_part2_32_detail_(i1) << 1) | kr_curve_part2_32_detail_(i0)) >> (32 - 2 * order);
+}
+
+KR_CONSTEXPR void kr_hilbert2_decode32(uint32_t index, unsigned order, uint16_t *x, uint16_t *y) KR_NOEXCEPT
+{
+    const uint32_t hi = index << (32 - 2 * order);
+    const uint32_t i0 = kr_curve_compact2_32_detail_(hi);
+    const uint32_t i1 = kr_curve_compact2_32_detail_(hi >> 1);
+    uint32_t t0 = (i0 | i1) ^ 0xFFFF, t1 = i0 & i1, a = 0;
+
+    t0 ^= t0 >> 8;
+    t0 ^= t0 >> 4;
+    t0 ^= t0 >> 2;
+    t0 ^= t0 >> 1;
+    t1 ^= t1 >> 8;
+    t1 ^= t1 >> 4;
+    t1 ^= t1 >> 2;
+    t1 ^= t1 >> 1;
+    a = ((i0 ^ 0xFFFF) & t1) | (i0 & t0);
+
+    *x = KR_CASTS(uint16_t, (a ^ i1) >> (16 - order));
+    *y = KR_CASTS(uint16_t, (a ^ i0 ^ i1) >> (16 - order));
+}
+
+#if defined(UINT64_MAX)
+
+/******************************************************************************/
+
+KR_CONSTEXPR uint64_t kr_curve_part2_64_detail_(uint64_t x) KR_NOEXCEPT
+{
+#if (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_pdep64(x, UINT64_C(0x5555555555555555));
+    }
+#endif /* (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64)) */
+
+    x &= UINT64_C(0x00000000FFFFFFFF);
+    x = (x | (x << 16)) & UINT64_C(0x0000FFFF0000FFFF);
+    x = (x | (x << 8)) & UINT64_C(0x00FF00FF00FF00FF);
+    x = (x | (x << 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+    x = (x | (x << 2)) & UINT64_C(0x3333333333333333);
+    x = (x | (x << 1)) & UINT64_C(0x5555555555555555);
+    return x;
+}
+
+KR_CONSTEXPR uint64_t kr_curve_compact2_64_detail_(uint64_t x) KR_NOEXCEPT
+{
+#if (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_pext64(x, UINT64_C(0x5555555555555555));
+    }
+#endif /* (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64)) */
+
+    x &= UINT64_C(0x5555555555555555);
+    x = (x | (x >> 1)) & UINT64_C(0x3333333333333333);
+    x = (x | (x >> 2)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+    x = (x | (x >> 4)) & UINT64_C(0x00FF00FF00FF00FF);
+    x = (x | (x >> 8)) & UINT64_C(0x0000FFFF0000FFFF);
+    x = (x | (x >> 16)) & UINT64_C(0x00000000FFFFFFFF);
+    return x;
+}
+
+KR_CONSTEXPR uint64_t kr_curve_part3_64_detail_(uint64_t x) KR_NOEXCEPT
+{
+#if (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_pdep64(x, UINT64_C(0x1249249249249249));
+    }
+#endif /* (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64)) */
+
+    x &= UINT64_C(0x00000000001FFFFF);
+    x = (x | (x << 32)) & UINT64_C(0x001F00000000FFFF);
+    x = (x | (x << 16)) & UINT64_C(0x001F0000FF0000FF);
+    x = (x | (x << 8)) & UINT64_C(0x100F00F00F00F00F);
+    x = (x | (x << 4)) & UINT64_C(0x10C30C30C30C30C3);
+    x = (x | (x << 2)) & UINT64_C(0x1249249249249249);
+    return x;
+}
+
+KR_CONSTEXPR uint64_t kr_curve_compact3_64_detail_(uint64_t x) KR_NOEXCEPT
+{
+#if (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64))
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_pext64(x, UINT64_C(0x1249249249249249));
+    }
+#endif /* (KR_BMI2) && (defined(__x86_64__) || defined(_M_X64)) */
+
+    x &= UINT64_C(0x1249249249249249);
+    x = (x | (x >> 2)) & UINT64_C(0x10C30C30C30C30C3);
+    x = (x | (x >> 4)) & UINT64_C(0x100F00F00F00F00F);
+    x = (x | (x >> 8)) & UINT64_C(0x001F0000FF0000FF);
+    x = (x | (x >> 16)) & UINT64_C(0x001F00000000FFFF);
+    x = (x | (x >> 32)) & UINT64_C(0x00000000001FFFFF);
+    return x;
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR uint64_t kr_morton2_encode64(uint32_t x, uint32_t y) KR_NOEXCEPT
+{
+    return kr_curve_part2_64_detail_(x) | (kr_curve_part2_64_detail_(y) << 1);
+}
+
+KR_CONSTEXPR void kr_morton2_decode64(uint64_t code, uint32_t *x, uint32_t *y) KR_NOEXCEPT
+{
+    *x = KR_CASTS(uint32_t, kr_curve_compact2_64_detail_(code));
+    *y = KR_CASTS(uint32_t, kr_curve_compact2_64_detail_(code >> 1));
+}
+
+KR_CONSTEXPR uint64_t kr_morton3_encode64(uint32_t x, uint32_t y, uint32_t z) KR_NOEXCEPT
+{
+    return kr_curve_part3_64_detail_(x & 0x1FFFFFu) | (kr_curve_part3_64_detail_(y & 0x1FFFFFu) << 1) |
+           (kr_curve_part3_64_detail_(z & 0x1FFFFFu) << 2);
+}
+
+KR_CONSTEXPR void kr_morton3_decode64(uint64_t code, uint32_t *x, uint32_t *y, uint32_t *z) KR_NOEXCEPT
+{
+    *x = KR_CASTS(uint32_t, kr_curve_compact3_64_detail_(code));
+    *y = KR_CASTS(uint32_t, kr_curve_compact3_64_detail_(code >> 1));
+    *z = KR_CASTS(uint32_t, kr_curve_compact3_64_detail_(code >> 2));
+}
+
+KR_CONSTEXPR uint64_t kr_morton2_encode64_table(uint32_t x, uint32_t y) KR_NOEXCEPT
+{
+    return KR_CASTS(uint64_t, kr_morton2_encode32_table(KR_CASTS(uint16_t, x), KR_CASTS(uint16_t, y))) |
+           (KR_CASTS(uint64_t, kr_morton2_encode32_table(KR_CASTS(uint16_t, x >> 16), KR_CASTS(uint16_t, y >> 16)))
+            << 32);
+}
+
+KR_CONSTEXPR uint64_t kr_morton3_encode64_table(uint32_t x, uint32_t y, uint32_t z) KR_NOEXCEPT
+{
+    const uint64_t sx = KR_CURVE_SPREAD3_DETAIL_[x & 0xFF] |
+                        (KR_CASTS(uint64_t, KR_CURVE_SPREAD3_DETAIL_[(x >> 8) & 0xFF]) << 24) |
+                        (KR_CASTS(uint64_t, KR_CURVE_SPREAD3_DETAIL_[(x >> 16) & 0x1F]) << 48);
+    const uint64_t sy = KR_CURVE_SPREAD3_DETAIL_[y & 0xFF] |
+                        (KR_CASTS(uint64_t, KR_CURVE_SPREAD3_DETAIL_[(y >> 8) & 0xFF]) << 24) |
+                        (KR_CASTS(uint64_t, KR_CURVE_SPREAD3_DETAIL_[(y >> 16) & 0x1F]) << 48);
+    const uint64_t sz = KR_CURVE_SPREAD3_DETAIL_[z & 0xFF] |
+                        (KR_CASTS(uint64_t, KR_CURVE_SPREAD3_DETAIL_[(z >> 8) & 0xFF]) << 24) |
+                        (KR_CASTS(uint64_t, KR_CURVE_SPREAD3_DETAIL_[(z >> 16) & 0x1F]) << 48);
+    return sx | (sy << 1) | (sz << 2);
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR uint64_t kr_hilbert2_encode64(uint32_t x, uint32_t y, unsigned order) KR_NOEXCEPT
+{
+    const uint32_t hx = x << (32 - order);
+    const uint32_t hy = y << (32 - order);
+    uint32_t sa = 0, sb = 0, sc = 0, sd = 0;
+    uint32_t a = 0, b = 0, c = 0, d = 0, i0 = 0, i1 = 0;
+    unsigned shift = 0;
+
+    a = hx ^ hy;
+    b = 0xFFFFFFFF ^ a;
+    c = 0xFFFFFFFF ^ (hx | hy);
+    d = hx & (hy ^ 0xFFFFFFFF);
+    sa = a | (b >> 1);
+    sb = (a >> 1) ^ a;
+    sc = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    sd = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    for (shift = 2; shift < 16; shift *= 2)
+    {
+        a = sa;
+        b = sb;
+        c = sc;
+        d = sd;
+        sa = (a & (a >> shift)) ^ (b & (b >> shift));
+        sb = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));
+        sc ^= (a & (c >> shift)) ^ (b & (d >> shift));
+        sd ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));
+    }
+
+    a = sa;
+    b = sb;
+    c = sc;
+    d = sd;
+    sc ^= (a & (c >> 16)) ^ (b & (d >> 16));
+    sd ^= (b & (c >> 16)) ^ ((a ^ b) & (d >> 16));
+
+    a = sc ^ (sc >> 1);
+    b = sd ^ (sd >> 1);
+    i0 = hx ^ hy;
+    i1 = b | (0xFFFFFFFF ^ (i0 | a));
+    return ((kr_curve_part2_64_detail_(i1) << 1) | kr_curve_part2_64_detail_(i0)) >> (64 - 2 * order);
+}
+
+KR_CONSTEXPR void kr_hilbert2_decode64(uint64_t index, unsigned order, uint32_t *x, uint32_t *y) KR_NOEXCEPT
+{
+    const uint64_t hi = index << (64 - 2 * order);
+    const uint32_t i0 = KR_CASTS(uint32_t, kr_curve_compact2_64_detail_(hi));
+    const uint32_t i1 = KR_CASTS(uint32_t, kr_curve_compact2_64_detail_(hi >> 1));
+    uint32_t t0 = (i0 | i1) ^ 0xFFFFFFFF, t1 = i0 & i1, a = 0;
+
+    t0 ^= t0 >> 16;
+    t0 ^= t0 >> 8;
+    t0 ^= t0 >> 4;
+    t0 ^= t0 >> 2;
+    t0 ^= t0 >> 1;
+    t1 ^= t1 >> 16;
+    t1 ^= t1 >> 8;
+    t1 ^= t1 >> 4;
+    t1 ^= t1 >> 2;
+    t1 ^= t1 >> 1;
+    a = ((i0 ^ 0xFFFFFFFF) & t1) | (i0 & t0);
+
+    *x = (a ^ i1) >> (32 - order);
+    *y = (a ^ i0 ^ i1) >> (32 - order);
+}
+
+#endif /* defined(UINT64_MAX) */
+
+#undef KR_CURVE_TABLE_DETAIL_
+#undef KR_CURVE_SPREAD2_DETAIL_
+#undef KR_CURVE_SPREAD3_DETAIL_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRCURVE_H) */
@@ -0,0 +1,794 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * Random distributions on top of the 32-bit PRNG in krrand.h.
+ *
+ * Like krrand.h, every function gives the same results on every platform.
+ * The Ziggurat tables are precomputed constants, and the exp and log needed
+ * on the slow paths are implemented here instead of taken from the C library,
+ * so results only depend on IEEE-754 double arithmetic.  Compilers that
+ * contract multiplies and adds into FMA instructions, or that keep doubles in
+ * x87 registers, can still change the last bit of a result.
+ *
+ * Normal and exponential samplers use the Ziggurat method of Marsaglia and
+ * Tsang, with the layer index and the sample taken from different bits:
+ *  <https://www.jstatsoft.org/article/view/v005i08>
+ *
+ * Weighted choice uses Vose's alias method:
+ *  <https://www.keithschwarz.com/darts-dice-coins/>
+ */
+
+#if !defined(KRDIST_H)
+#define KRDIST_H
+
+#include "./krconfig.h"
+
+#include "./krbool.h"
+#include "./krint.h"
+#include "./krlib.h"
+#include "./krrand.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+/**
+ * @brief A table for choosing from weighted outcomes in constant time.
+ */
+struct kr_dist_alias_s
+{
+    uint32_t *prob;
+    uint32_t *alias;
+    uint32_t n;
+};
+
+/**
+ * @brief Return a uniformly distributed float in the half-open range of
+ *        [0, 1).
+ *
+ * @details Every one of the 2^24 possible results is equally likely.
+ */
+KR_INLINE float kr_dist_float(struct kr_jsf32_ctx_s *x);
+
+/**
+ * @brief Return a uniformly distributed double in the half-open range of
+ *        [0, 1).
+ *
+ * @details Every one of the 2^53 possible results is equally likely.  Uses
+ *          two random numbers.
+ */
+KR_INLINE double kr_dist_double(struct kr_jsf32_ctx_s *x);
+
+/**
+ * @brief Return a normally distributed double with a mean of 0 and a
+ *        standard deviation of 1.
+ *
+ * @details Usually costs one random number and a multiply.
+ */
+KR_INLINE double kr_dist_normal(struct kr_jsf32_ctx_s *x);
+
+/**
+ * @brief Return an exponentially distributed double with a rate of 1.
+ *
+ * @details Usually costs one random number and a multiply.  Divide by the
+ *          rate to get other rates.
+ */
+KR_INLINE double kr_dist_exponential(struct kr_jsf32_ctx_s *x);
+
+/**
+ * @brief Build an alias table from a list of weights.
+ *
+ * @param alias Table to initialize.
+ * @param weights Weight of each outcome.  Weights must not be negative, and
+ *        at least one must be positive.
+ * @param n Number of outcomes.  Must be between 1 and UINT32_MAX.
+ * @return true if successful, or false if the weights are invalid or
+ *         allocation failed.  The table is empty on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_dist_alias_init(struct kr_dist_alias_s *alias, const double *weights, size_t n);
+
+/**
+ * @brief Free the memory owned by an alias table and leave it empty.
+ *
+ * @param alias Table to free.
+ */
+KR_INLINE void kr_dist_alias_free(struct kr_dist_alias_s *alias);
+
+/**
+ * @brief Choose an outcome from an alias table.
+ *
+ * @param alias Table to choose from.  Must not be empty.
+ * @return Index of the chosen outcome.
+ */
+KR_INLINE uint32_t kr_dist_alias_sample(const struct kr_dist_alias_s *alias, struct kr_jsf32_ctx_s *x);
+
+/**
+ * @brief Shuffle an array in place with the Fisher-Yates method.
+ *
+ * @param base Array to shuffle.
+ * @param nmemb Number of elements.  Must not be greater than UINT32_MAX.
+ * @param size Size of each element.
+ */
+KR_INLINE void kr_dist_shuffle(struct kr_jsf32_ctx_s *x, void *base, size_t nmemb, size_t size);
+
+/**
+ * @brief Decide where an item from a stream goes in a random sample of k
+ *        items, using reservoir sampling.
+ *
+ * @details Call once for every item in the stream.  Once the stream ends,
+ *          the reservoir holds k items chosen uniformly from all of them.
+ *
+ * @param seen Number of items seen before this one.  Must be less than
+ *        UINT32_MAX.
+ * @param k Size of the reservoir.
+ * @return Slot in the reservoir to store the item in, or k if the item is
+ *         not part of the sample.
+ */
+KR_INLINE uint32_t kr_dist_reservoir(struct kr_jsf32_ctx_s *x, uint32_t seen, uint32_t k);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+#define KR_DIST_LN2HI_DETAIL_ (6.93147180369123816490e-01)
+#define KR_DIST_LN2LO_DETAIL_ (1.90821492927058770002e-10)
+#define KR_DIST_NORMR_DETAIL_ (3.442619855899)
+#define KR_DIST_EXPR_DETAIL_ (7.697117470131487)
+
+/*
+ * Ziggurat tables, generated once from the formulas in Marsaglia and Tsang
+ * with 128 normal layers and 256 exponential layers.  The k tables are
+ * acceptance thresholds for a 24-bit sample, the w tables scale the sample
+ * to a double, and the f tables are the density at each layer.  They live
+ * inside inline functions, so C++ programs share one copy instead of one
+ * per translation unit.
+ */
+
+/**
+ * @brief Get the normal acceptance thresholds.
+ */
+KR_INLINE const uint32_t *kr_dist_normk_detail_(void)
+{
+    static const uint32_t table[128] = {
+        15555140, 0, 12590646, 14272655, 14988941, 15384586, 15635011, 15807563,
+        15933579, 16029596, 16105157, 16166149, 16216401, 16258510, 16294297, 16325080,
+        16351833, 16375293, 16396028, 16414481, 16431004, 16445882, 16459345, 16471580,
+        16482746, 16492973, 16502371, 16511033, 16519041, 16526461, 16533355, 16539771,
+        16545757, 16551350, 16556586, 16561495, 16566103, 16570436, 16574514, 16578356,
+        16581979, 16585400, 16588632, 16591687, 16594578, 16597313, 16599904, 16602357,
+        16604681, 16606884, 16608971, 16610948, 16612821, 16614596, 16616275, 16617864,
+        16619366, 16620785, 16622124, 16623386, 16624574, 16625689, 16626734, 16627712,
+        16628623, 16629469, 16630252, 16630973, 16631633, 16632232, 16632772, 16633253,
+        16633676, 16634040, 16634345, 16634592, 16634780, 16634909, 16634978, 16634986,
+        16634933, 16634816, 16634636, 16634389, 16634074, 16633688, 16633230, 16632697,
+        16632084, 16631389, 16630608, 16629736, 16628767, 16627697, 16626519, 16625225,
+        16623807, 16622256, 16620562, 16618713, 16616695, 16614493, 16612090, 16609464,
+        16606592, 16603448, 16599998, 16596205, 16592024, 16587401, 16582272, 16576558,
+        16570162, 16562964, 16554811, 16545510, 16534808, 16522367, 16507732, 16490264,
+        16469044, 16442689, 16409025, 16364393, 16302110, 16208407, 16049218, 15707337
+    };
+    return table;
+}
+
+/**
+ * @brief Get the normal sample scales.
+ */
+KR_INLINE const double *kr_dist_normw_detail_(void)
+{
+    static const double table[128] = {
+        2.2131718675747815e-07, 1.6231588412163536e-08, 2.1628822749676225e-08, 2.5424241206373186e-08,
+        2.8457512694399942e-08, 3.103351824057463e-08, 3.330064883280904e-08, 3.5343345550981064e-08,
+        3.7214672406676453e-08, 3.8950362130402043e-08, 4.057573787386147e-08, 4.210946627470472e-08,
+        4.35657447959476e-08, 4.4955650833490826e-08, 4.628801273672342e-08, 4.7569993772748525e-08,
+        4.8807496231815654e-08, 5.000544871673449e-08, 5.116801519357045e-08, 5.2298750228460036e-08,
+        5.340071633940564e-08, 5.447657412427856e-08, 5.5528652466246535e-08, 5.655900392003694e-08,
+        5.7569448912212246e-08, 5.856161138507301e-08, 5.9536947816192126e-08, 6.049677105255905e-08,
+        6.144227004457686e-08, 6.237452630782398e-08, 6.329452775089885e-08, 6.420318036633108e-08,
+        6.510131817503437e-08, 6.598971173370099e-08, 6.686907545224084e-08, 6.774007392008071e-08,
+        6.860332740240499e-08, 6.945941663770392e-08, 7.030888704442907e-08, 7.11522524257379e-08,
+        7.198999824618993e-08, 7.282258454203584e-08, 7.365044851680771e-08, 7.447400686580349e-08,
+        7.529365786639578e-08, 7.610978326559994e-08, 7.692274999178627e-08, 7.773291171363692e-08,
+        7.854061026629293e-08, 7.93461769619958e-08, 8.01499338003127e-08, 8.095219459117314e-08,
+        8.175326600237743e-08, 8.25534485419185e-08, 8.335303748434814e-08, 8.415232374948607e-08,
+        8.49515947409904e-08, 8.575113515165827e-08, 8.655122774179128e-08, 8.735215409652655e-08,
+        8.815419536768938e-08, 8.895763300546134e-08, 8.976274948496838e-08, 9.056982903277517e-08,
+        9.137915835821887e-08, 9.219102739452782e-08, 9.300573005474621e-08, 9.382356500762706e-08,
+        9.464483647886372e-08, 9.54698550833093e-08, 9.629893869418865e-08, 9.713241335574595e-08,
+        9.797061424630097e-08, 9.881388669932032e-08, 9.966258729085928e-08, 1.0051708500261117e-07,
+        1.0137776247083645e-07, 1.0224501733265326e-07, 1.0311926368258777e-07, 1.0400093365393879e-07,
+        1.0489047914144954e-07, 1.057883736840528e-07, 1.0669511452912442e-07, 1.0761122490282228e-07,
+        1.0853725651479516e-07, 1.09473792329934e-07, 1.1042144964504785e-07, 1.1138088351455263e-07,
+        1.1235279057668203e-07, 1.1333791334063715e-07, 1.1433704500582873e-07, 1.1535103489736455e-07,
+        1.1638079461774568e-07, 1.1742730503406087e-07, 1.1849162424371361e-07, 1.1957489669105244e-07,
+        1.2067836364372882e-07, 1.218033752831857e-07, 1.2295140472104004e-07, 1.2412406432581048e-07,
+        1.2532312483723393e-07, 1.2655053786480287e-07, 1.2780846252205344e-07, 1.2909929715090525e-07,
+        1.3042571735835368e-07, 1.3179072194568535e-07, 1.3319768879359838e-07, 1.346504434269189e-07,
+        1.3615334389671515e-07, 1.3771138690106648e-07, 1.3933034189577322e-07, 1.4101692260012857e-07,
+        1.427790092236437e-07, 1.4462594065271317e-07, 1.4656890496086064e-07, 1.4862147105308605e-07,
+        1.5080032780103847e-07, 1.5312633668928968e-07, 1.5562607338618323e-07, 1.5833416052230356e-07,
+        1.6129693824778912e-07, 1.6457851960582595e-07, 1.6827138367586794e-07, 1.7251634639629894e-07,
+        1.7754413203285815e-07, 1.8377476085524966e-07, 1.921108355868543e-07, 2.0519613360756637e-07
+    };
+    return table;
+}
+
+/**
+ * @brief Get the normal density at each layer.
+ */
+KR_INLINE const double *kr_dist_normf_detail_(void)
+{
+    static const double table[128] = {
+        1.0, 0.9635996931270862, 0.9362826816850596, 0.9130436479717402,
+        0.8922816507840261, 0.8732430489100695, 0.8555006078694506, 0.8387836052959896,
+        0.822907211381409, 0.8077382946829605, 0.7931770117713051, 0.7791460859296877,
+        0.7655841738977045, 0.7524415591746114, 0.7396772436726473, 0.7272569183441848,
+        0.7151515074104986, 0.7033360990161581, 0.6917891434366751, 0.6804918409973341,
+        0.6694276673488904, 0.658582000050088, 0.6479418211102225, 0.6374954773350423,
+        0.6272324852499273, 0.6171433708188809, 0.6072195366251203, 0.5974531509445167,
+        0.5878370544347066, 0.5783646811197631, 0.5690299910679509, 0.5598274127040869,
+        0.5507517931146045, 0.5417983550254255, 0.5329626593838361, 0.5242405726729841,
+        0.5156282382440018, 0.507122051075569, 0.4987186354709795, 0.4904148252838441,
+        0.4822076463294852, 0.47409430069301695, 0.4660721526894561, 0.45813871626787206,
+        0.4502916436820392, 0.44252871527546844, 0.4348478302499909, 0.4272469983049961,
+        0.4197243320495744, 0.412278040102661, 0.40490642080722294, 0.3976078564938733,
+        0.3903808082373146, 0.3832238110559012, 0.3761354695105626, 0.3691144536644722,
+        0.3621594953693176, 0.3552693848479171, 0.3484429675463266, 0.3416791412315504,
+        0.3349768533135892, 0.3283350983728503, 0.3217529158759849, 0.3152293880650109,
+        0.3087636380061811, 0.30235482778648354, 0.296002156846933, 0.28970486044295984,
+        0.283462208223233, 0.2772735029191881, 0.2711380791383846, 0.2650553022555892,
+        0.25902456739620483, 0.25304529850732577, 0.2471169475123214, 0.24123899354543982,
+        0.23541094226347908, 0.22963232523211613, 0.22390269938500842, 0.2182216465543054,
+        0.2125887730717303, 0.20700370943992652, 0.20146611007431367, 0.19597565311627774,
+        0.19053204031913715, 0.1851349970089922, 0.17978427212329545, 0.1744796383307895,
+        0.169220892237365, 0.16400785468342038, 0.1588403711394793, 0.15371831220818166,
+        0.14864157424234226, 0.14361008009062776, 0.1386237799845946, 0.13368265258343937,
+        0.1287867061959432, 0.12393598020286782, 0.11913054670765083, 0.11437051244886601,
+        0.10965602101484027, 0.10498725540942132, 0.10036444102865587, 0.09578784912173144,
+        0.09125780082683026, 0.08677467189478018, 0.08233889824223566, 0.0779509825139734,
+        0.0736115018841134, 0.06932111739357791, 0.06508058521306807, 0.060890770348040406,
+        0.05675266348104985, 0.05266740190305101, 0.048636295859867805, 0.044660862200491425,
+        0.040742868074444175, 0.0368843887866562, 0.03308788614622575, 0.02935631744000685,
+        0.02569329193593427, 0.022103304615927098, 0.018592102737011288, 0.015167298010546568,
+        0.011839478657884862, 0.008624484412859885, 0.005548995220771345, 0.002669629083880923
+    };
+    return table;
+}
+
+/**
+ * @brief Get the exponential acceptance thresholds.
+ */
+KR_INLINE const uint32_t *kr_dist_expk_detail_(void)
+{
+    static const uint32_t table[256] = {
+        14848161, 0, 10218206, 12810156, 13950393, 14584127, 14985448, 15261681,
+        15463134, 15616422, 15736910, 15834075, 15914072, 15981072, 16037997, 16086957,
+        16129512, 16166839, 16199845, 16229238, 16255579, 16279320, 16300827, 16320400,
+        16338288, 16354700, 16369810, 16383767, 16396697, 16408709, 16419898, 16430344,
+        16440118, 16449284, 16457894, 16465999, 16473641, 16480857, 16487683, 16494148,
+        16500280, 16506104, 16511642, 16516913, 16521937, 16526731, 16531308, 16535683,
+        16539869, 16543878, 16547720, 16551404, 16554941, 16558338, 16561603, 16564744,
+        16567767, 16570677, 16573482, 16576186, 16578795, 16581312, 16583743, 16586091,
+        16588360, 16590554, 16592677, 16594730, 16596718, 16598643, 16600508, 16602315,
+        16604066, 16605765, 16607412, 16609009, 16610560, 16612065, 16613526, 16614944,
+        16616322, 16617660, 16618961, 16620225, 16621453, 16622647, 16623807, 16624936,
+        16626033, 16627100, 16628137, 16629147, 16630128, 16631083, 16632012, 16632916,
+        16633795, 16634649, 16635481, 16636290, 16637076, 16637841, 16638585, 16639309,
+        16640012, 16640695, 16641360, 16642005, 16642632, 16643242, 16643833, 16644407,
+        16644964, 16645505, 16646029, 16646538, 16647030, 16647507, 16647969, 16648415,
+        16648847, 16649264, 16649667, 16650056, 16650431, 16650792, 16651139, 16651473,
+        16651793, 16652101, 16652395, 16652676, 16652944, 16653199, 16653442, 16653672,
+        16653890, 16654095, 16654287, 16654467, 16654635, 16654791, 16654934, 16655065,
+        16655183, 16655290, 16655384, 16655465, 16655535, 16655592, 16655636, 16655668,
+        16655687, 16655694, 16655688, 16655669, 16655637, 16655592, 16655534, 16655462,
+        16655377, 16655279, 16655166, 16655040, 16654899, 16654744, 16654574, 16654389,
+        16654189, 16653974, 16653742, 16653495, 16653232, 16652951, 16652654, 16652338,
+        16652005, 16651654, 16651284, 16650894, 16650485, 16650055, 16649604, 16649132,
+        16648637, 16648119, 16647578, 16647012, 16646421, 16645803, 16645158, 16644486,
+        16643784, 16643052, 16642288, 16641491, 16640661, 16639795, 16638891, 16637949,
+        16636967, 16635942, 16634873, 16633757, 16632593, 16631377, 16630107, 16628780,
+        16627394, 16625943, 16624426, 16622837, 16621174, 16619430, 16617601, 16615681,
+        16613665, 16611545, 16609314, 16606964, 16604487, 16601871, 16599107, 16596181,
+        16593081, 16589790, 16586292, 16582567, 16578593, 16574345, 16569794, 16564906,
+        16559645, 16553965, 16547814, 16541132, 16533847, 16525871, 16517102, 16507411,
+        16496645, 16484608, 16471057, 16455680, 16438068, 16417682, 16393787, 16365357,
+        16330913, 16288240, 16233847, 16161893, 16061744, 15911694, 15658929, 15129198
+    };
+    return table;
+}
+
+/**
+ * @brief Get the exponential sample scales.
+ */
+KR_INLINE const double *kr_dist_expw_detail_(void)
+{
+    static const double table[256] = {
+        5.183885973772339e-07, 3.8058855423319565e-09, 6.248862002241797e-09, 8.184014614820463e-09,
+        9.842373285542489e-09, 1.1322420216943133e-08, 1.2676209845003929e-08, 1.3934998694638382e-08,
+        1.511921664392376e-08, 1.6243051617053574e-08, 1.7316815584374852e-08, 1.834827391355784e-08,
+        1.934344273906366e-08, 2.030709273009555e-08, 2.1243081108235574e-08, 2.2154578288192227e-08,
+        2.30442272389599e-08, 2.3914258414284722e-08, 2.4766574478170347e-08, 2.5602813972556925e-08,
+        2.6424399976345742e-08, 2.723257785626741e-08, 2.8028444950709595e-08, 2.881297419389827e-08,
+        2.9587033123890552e-08, 3.03513993289262e-08, 3.110677311373536e-08, 3.18537879727579e-08,
+        3.259301931639353e-08, 3.332499179312806e-08, 3.4050185473715345e-08, 3.4769041106031295e-08,
+        3.5481964605540004e-08, 3.6189330912846137e-08, 3.6891487323932215e-08, 3.758875637850089e-08,
+        3.8281438375981644e-08, 3.8969813576201317e-08, 3.9654144131700685e-08, 4.033467579063891e-08,
+        4.101163940273196e-08, 4.1685252255393814e-08, 4.235571926293685e-08, 4.302323402814589e-08,
+        4.368797979261654e-08, 4.435013028982315e-08, 4.5009850512861e-08, 4.5667297407116433e-08,
+        4.6322620496697866e-08, 4.697596245226206e-08, 4.762745960685521e-08, 4.8277242425526146e-08,
+        4.892543593373356e-08, 4.9572160108940064e-08, 5.021753023924628e-08, 5.0861657252453044e-08,
+        5.1504648018539093e-08, 5.21466056281938e-08, 5.278762964974341e-08, 5.3427816366546634e-08,
+        5.406725899670651e-08, 5.470604789674534e-08, 5.534427075071386e-08, 5.5982012746051574e-08,
+        5.6619356737379675e-08, 5.725638339928774e-08, 5.789317136906991e-08, 5.85297973802722e-08,
+        5.9166336387829424e-08, 5.980286168549627e-08, 6.043944501621096e-08, 6.107615667597149e-08,
+        6.17130656117515e-08, 6.23502395139362e-08, 6.298774490371644e-08, 6.36256472158412e-08,
+        6.426401087709491e-08, 6.490289938083561e-08, 6.554237535790178e-08, 6.618250064417179e-08,
+        6.682333634503653e-08, 6.746494289702633e-08, 6.81073801268143e-08, 6.8750707307802e-08,
+        6.939498321447832e-08, 7.004026617472827e-08, 7.068661412025693e-08, 7.133408463528164e-08,
+        7.198273500363586e-08, 7.263262225441865e-08, 7.328380320631549e-08, 7.393633451070814e-08,
+        7.459027269368475e-08, 7.524567419705473e-08, 7.59025954184675e-08, 7.656109275072879e-08,
+        7.722122262040372e-08, 7.788304152579143e-08, 7.854660607435244e-08, 7.921197301966636e-08,
+        7.987919929799457e-08, 8.054834206451974e-08, 8.12194587293318e-08, 8.189260699322754e-08,
+        8.25678448833895e-08, 8.324523078900818e-08, 8.392482349691e-08, 8.460668222725283e-08,
+        8.529086666934958e-08, 8.59774370176799e-08, 8.666645400814966e-08, 8.735797895465758e-08,
+        8.80520737860282e-08, 8.874880108337076e-08, 8.944822411792374e-08, 9.015040688944557e-08,
+        9.085541416521225e-08, 9.156331151968428e-08, 9.227416537490564e-08, 9.298804304169937e-08,
+        9.370501276172573e-08, 9.442514375047017e-08, 9.514850624123113e-08, 9.587517153017865e-08,
+        9.66052120225583e-08, 9.733870128011649e-08, 9.807571406982678e-08, 9.881632641399934e-08,
+        9.956061564185927e-08, 1.0030866044268332e-07, 1.0106054092058765e-07, 1.018163386510645e-07,
+        1.0257613673936935e-07, 1.0334001988086531e-07, 1.0410807442343679e-07, 1.0488038843208997e-07,
+        1.0565705175586376e-07, 1.064381560971812e-07, 1.0722379508377857e-07, 1.0801406434335654e-07,
+        1.0880906158110619e-07, 1.096088866602707e-07, 1.1041364168591356e-07, 1.1122343109207323e-07,
+        1.1203836173249554e-07, 1.128585429751461e-07, 1.136840868007176e-07, 1.145151079053598e-07,
+        1.1535172380787447e-07, 1.1619405496163284e-07, 1.1704222487148937e-07, 1.178963602159835e-07,
+        1.1875659097514023e-07, 1.1962305056420087e-07, 1.2049587597363755e-07, 1.2137520791582888e-07,
+        1.2226119097880042e-07, 1.2315397378746133e-07, 1.2405370917279878e-07, 1.2496055434952476e-07,
+        1.258746711027052e-07, 1.2679622598393974e-07, 1.277253905177023e-07, 1.28662341418498e-07,
+        1.2960726081954098e-07, 1.305603365137113e-07, 1.3152176220760734e-07, 1.3249173778957356e-07,
+        1.3347046961265268e-07, 1.3445817079348687e-07, 1.3545506152827478e-07, 1.3646136942698185e-07,
+        1.374773298670996e-07, 1.38503186368358e-07, 1.395391909899137e-07, 1.4058560475166673e-07,
+        1.416426980815019e-07, 1.427107512904084e-07, 1.4379005507760482e-07, 1.448809110679878e-07,
+        1.4598363238443446e-07, 1.4709854425772232e-07, 1.4822598467708896e-07, 1.493663050847409e-07,
+        1.5051987111793937e-07, 1.5168706340264515e-07, 1.5286827840309786e-07, 1.5406392933214566e-07,
+        1.552744471276306e-07, 1.5650028150068471e-07, 1.5774190206240491e-07, 1.589997995360655e-07,
+        1.602744870628004e-07, 1.6156650160955982e-07, 1.6287640548912907e-07, 1.6420478800310785e-07,
+        1.6555226722000605e-07, 1.66919491902038e-07, 1.6830714359581707e-07, 1.6971593890399893e-07,
+        1.7114663195702677e-07, 1.7260001710654177e-07, 1.740769318647829e-07, 1.7557826011747426e-07,
+        1.7710493564135405e-07, 1.7865794596172195e-07, 1.8023833659027117e-07, 1.818472156891502e-07,
+        1.8348575921381097e-07, 1.851552165949244e-07, 1.8685691702869222e-07, 1.8859227645552042e-07,
+        1.9036280531956243e-07, 1.9217011721648408e-07, 1.9401593855443348e-07, 1.9590211937422023e-07,
+        1.9783064549987062e-07, 1.9980365222097154e-07, 2.0182343974472947e-07, 2.0389249069995464e-07,
+        2.0601349002914255e-07, 2.0818934767091696e-07, 2.104232245164725e-07, 2.1271856222440893e-07,
+        2.150791176038338e-07, 2.1750900243287484e-07, 2.2001272977813674e-07, 2.2259526813267536e-07,
+        2.252621050126363e-07, 2.280193220688314e-07, 2.3087368431088473e-07, 2.3383274675223265e-07,
+        2.3690498272620473e-07, 2.400999393849346e-07, 2.434284276013563e-07, 2.4690275583649105e-07,
+        2.505370207867149e-07, 2.543474722073906e-07, 2.583529758642493e-07, 2.6257560810289377e-07,
+        2.6704142967036065e-07, 2.7178150783225183e-07, 2.7683328899265034e-07, 2.822424767376051e-07,
+        2.8806565648467244e-07, 2.9437405382998545e-07, 3.012590700376839e-07, 3.088407088101836e-07,
+        3.1728091870274887e-07, 3.268057481960136e-07, 3.377443651827641e-07, 3.506031224605736e-07,
+        3.66220752344882e-07, 3.861414488454299e-07, 4.13717843853083e-07, 4.5878395260164065e-07
+    };
+    return table;
+}
+
+/**
+ * @brief Get the exponential density at each layer.
+ */
+KR_INLINE const double *kr_dist_expf_detail_(void)
+{
+    static const double table[256] = {
+        1.0, 0.9381436808621963, 0.9004699299257618, 0.8717043323812159,
+        0.847785500624, 0.8269932966430594, 0.8084216515230165, 0.7915276369725031,
+        0.7759568520401224, 0.7614633888499026, 0.7478686219852011, 0.7350380924314291,
+        0.7228676595935773, 0.711274760805081, 0.7001926550827929, 0.6895664961170825,
+        0.6793505722647697, 0.6695063167319288, 0.6600008410790036, 0.6508058334145748,
+        0.6418967164272696, 0.6332519942143695, 0.6248527387036692, 0.6166821809152108,
+        0.6087253820796251, 0.6009689663652352, 0.5934009016917363, 0.5860103184772708,
+        0.5787873586028477, 0.5717230486648284, 0.5648091929124027, 0.5580382822625899,
+        0.5514034165406436, 0.5448982376724418, 0.538516872002864, 0.5322538802630453,
+        0.5261042139836217, 0.5200631773682355, 0.5141263938147504, 0.5082897764106447,
+        0.5025495018413495, 0.49690198724155127, 0.4913438695940342, 0.4858719873418865,
+        0.48048336393045576, 0.4751751930373789, 0.4699448252839615, 0.4647897562504276,
+        0.4597076156421391, 0.45469615747461684, 0.44975325116275633, 0.44487687341454984,
+        0.4400651008423552, 0.43531610321563785, 0.43062813728846006, 0.42599954114303556,
+        0.4214287289976178, 0.41691418643300404, 0.4124544659971623, 0.40804818315203345,
+        0.40369401253053133, 0.3993906844752321, 0.39513698183329116, 0.3909317369847981,
+        0.38677382908413865, 0.3826621814960108, 0.37859575940958173, 0.37457356761590305,
+        0.3705946484351469, 0.36665807978151504, 0.36276297335481866, 0.35890847294875056,
+        0.3550937528667882, 0.351318016437484, 0.34758049462163765, 0.3438804447045031,
+        0.3402171490667807, 0.33658991402867827, 0.33299806876180965, 0.32944096426413705,
+        0.3259179723935569, 0.32242848495608983, 0.3189719128449579, 0.31554768522712956,
+        0.31215524877418016, 0.30879406693456074, 0.3054636192445908, 0.3021634006756941,
+        0.2988929210155823, 0.2956517042812617, 0.2924392881618931, 0.2892552234896782,
+        0.28609907373707727, 0.2829704145387812, 0.2798688332369733, 0.27679392844851775,
+        0.27374530965280336, 0.27072259679906047, 0.26772541993204524, 0.2647534188350626,
+        0.2618062426893633, 0.25888354974901656, 0.2559850070304157, 0.2531102900156298,
+        0.25025908236886263, 0.24743107566532793, 0.24462596913189236, 0.24184346939887746,
+        0.23908329026244937, 0.23634515245705984, 0.23362878343743348, 0.23093391716962755,
+        0.2282602939307168, 0.22560766011668415, 0.22297576805812028, 0.22036437584335958,
+        0.2177732471487006, 0.21520215107537877, 0.21265086199297836, 0.21011915938898837,
+        0.20760682772422212, 0.2051136562938378, 0.2026394390937091, 0.20018397469191135,
+        0.19774706610509893, 0.19532852067956327, 0.1929281499767714, 0.19054576966319545,
+        0.18818119940425435, 0.18583426276219714, 0.18350478709776744, 0.18119260347549626,
+        0.17889754657247828, 0.17661945459049483, 0.1743581691713534, 0.17211353531531998,
+        0.16988540130252755, 0.16767361861725008, 0.1654780418749359, 0.16329852875190168,
+        0.1611349399175919, 0.15898713896931407, 0.1568549923693651, 0.15473836938446794,
+        0.15263714202744272, 0.15055118500103976, 0.14848037564386662, 0.14642459387834475,
+        0.14438372216063458, 0.142357645432472, 0.14034625107486226, 0.13834942886358,
+        0.13636707092642864, 0.1343990717022134, 0.13244532790138733, 0.1305057384683306,
+        0.128580204545228, 0.1266686294375105, 0.12477091858083077, 0.12288697950954494,
+        0.12101672182667463, 0.11916005717532749, 0.11731689921155537, 0.11548716357863334,
+        0.11367076788274413, 0.11186763167005613, 0.11007767640518522, 0.1083008254510336,
+        0.10653700405000148, 0.10478613930657, 0.10304816017125756, 0.10132299742595349,
+        0.099610583670637, 0.09791085331149207, 0.09622374255043266, 0.09454918937605569,
+        0.09288713355604336, 0.09123751663103996, 0.08960028191003268, 0.08797537446727004,
+        0.08636274114075673, 0.08476233053236795, 0.08317409300963222, 0.08159798070923724,
+        0.08003394754231972, 0.07848194920160623, 0.07694194317048031, 0.0754138887340582,
+        0.07389774699236455, 0.07239348087570853, 0.07090105516237159, 0.0694204364987285,
+        0.06795159342193637, 0.06649449638533955, 0.06504911778675354, 0.0636154319998071,
+        0.06219341540854076, 0.06078304644547939, 0.059384305633420016, 0.0579971756312004,
+        0.05662164128374262, 0.05525768967669679, 0.053905310196045816, 0.05256449459307141,
+        0.05123523705512598, 0.049917534282706066, 0.0486113855733792, 0.04731679291318125,
+        0.04603376107617487, 0.04476229773294299, 0.04350241356888789, 0.042254122413315935,
+        0.04101744138041453, 0.03979239102337382, 0.038578995503074545, 0.03737728277295905,
+        0.03618728478193111, 0.03500903769739709, 0.03384258215087401, 0.03268796350895922,
+        0.03154523217289329, 0.030414443910466285, 0.02929566022463707, 0.028188948763978306,
+        0.027094383780955467, 0.026012046645133884, 0.024942026419731454, 0.023884420511557845,
+        0.022839335406384914, 0.02180688750428326, 0.0207872040725778, 0.019780424338009424,
+        0.018786700744695708, 0.01780620041091104, 0.016839106826039625, 0.015885621839972847,
+        0.01494596801169083, 0.014020391403181618, 0.013109164931254677, 0.012212592426255064,
+        0.011331013597834288, 0.010464810181029675, 0.009614413642501905, 0.008780314985808673,
+        0.00796307743801674, 0.0071633531836346855, 0.006381905937318883, 0.005619642207205189,
+        0.004877655983542105, 0.0041572951208335126, 0.0034602647778366304, 0.0027887987935738107,
+        0.0021459677437186517, 0.0015362997803013297, 0.0009672692823269484, 0.00045413435384129814
+    };
+    return table;
+}
+
+/******************************************************************************/
+
+/**
+ * @brief Portable exp, only valid for x <= 0.
+ */
+KR_INLINE double kr_dist_exp_detail_(double x)
+{
+    double r = 0.0, p = 0.0, scale = 1.0, half = 0.5;
+    int k = 0, n = 0;
+
+    if (x < -708.0)
+    {
+        return 0.0;
+    }
+
+    /* Reduce to exp(r) * 2^k with |r| <= ln(2) / 2. */
+    k = KR_CASTS(int, x * 1.4426950408889634 - 0.5);
+    r = x - k * KR_DIST_LN2HI_DETAIL_ - k * KR_DIST_LN2LO_DETAIL_;
+
+    p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    for (n = -k; n != 0; n >>= 1)
+    {
+        if (n & 1)
+        {
+            scale *= half;
+        }
+        half *= half;
+    }
+    return p * scale;
+}
+
+/**
+ * @brief Portable log, only valid for 0 < x <= 1.
+ */
+KR_INLINE double kr_dist_log_detail_(double x)
+{
+    double f = 0.0, s = 0.0, z = 0.0, p = 0.0;
+    int e = 0;
+
+    /* Reduce to log(1 + f) + e * ln(2) with sqrt(1/2) <= 1 + f < sqrt(2). */
+    while (x < 1.0 / 4294967296.0)
+    {
+        x *= 4294967296.0;
+        e -= 32;
+    }
+    while (x < 0.70710678118654752440)
+    {
+        x *= 2.0;
+        e -= 1;
+    }
+
+    f = x - 1.0;
+    s = f / (2.0 + f);
+    z = s * s;
+
+    p = 1.0 / 21.0;
+    p = p * z + 1.0 / 19.0;
+    p = p * z + 1.0 / 17.0;
+    p = p * z + 1.0 / 15.0;
+    p = p * z + 1.0 / 13.0;
+    p = p * z + 1.0 / 11.0;
+    p = p * z + 1.0 / 9.0;
+    p = p * z + 1.0 / 7.0;
+    p = p * z + 1.0 / 5.0;
+    p = p * z + 1.0 / 3.0;
+    p = p * z + 1.0;
+
+    return e * KR_DIST_LN2HI_DETAIL_ + (e * KR_DIST_LN2LO_DETAIL_ + 2.0 * s * p);
+}
+
+/**
+ * @brief Return a uniformly distributed double in the half-open range of
+ *        (0, 1], which is safe to take the log of.
+ */
+KR_INLINE double kr_dist_open_detail_(struct kr_jsf32_ctx_s *x)
+{
+    return 1.0 - kr_dist_double(x);
+}
+
+/******************************************************************************/
+
+KR_INLINE float kr_dist_float(struct kr_jsf32_ctx_s *x)
+{
+    return KR_CASTS(float, kr_jsf32_rand(x) >> 8) * (1.0f / 16777216.0f);
+}
+
+KR_INLINE double kr_dist_double(struct kr_jsf32_ctx_s *x)
+{
+    const uint32_t hi = kr_jsf32_rand(x) >> 5;
+    const uint32_t lo = kr_jsf32_rand(x) >> 6;
+    return (hi * 67108864.0 + lo) * (1.0 / 9007199254740992.0);
+}
+
+/******************************************************************************/
+
+KR_INLINE double kr_dist_normal(struct kr_jsf32_ctx_s *x)
+{
+    const uint32_t *k = kr_dist_normk_detail_();
+    const double *w = kr_dist_normw_detail_(), *f = kr_dist_normf_detail_();
+    uint32_t u = 0, i = 0, j = 0;
+    double v = 0.0, y = 0.0;
+
+    for (;;)
+    {
+        /* Low bits pick the layer and sign, high bits pick the sample. */
+        u = kr_jsf32_rand(x);
+        i = u & 0x7F;
+        j = u >> 8;
+        v = j * w[i];
+        if (j < k[i])
+        {
+            break;
+        }
+
+        if (i == 0)
+        {
+            /* Fell off the base layer into the infinite tail. */
+            do
+            {
+                v = -kr_dist_log_detail_(kr_dist_open_detail_(x)) / KR_DIST_NORMR_DETAIL_;
+                y = -kr_dist_log_detail_(kr_dist_open_detail_(x));
+            } while (y + y < v * v);
+            v += KR_DIST_NORMR_DETAIL_;
+            break;
+        }
+
+        /* Fell into the wedge outside the layer's inner rectangle. */
+        if (f[i] + kr_dist_double(x) * (f[i - 1] - f[i]) < kr_dist_exp_detail_(-0.5 * v * v))
+        {
+            break;
+        }
+    }
+
+    return (u & 0x80) ? -v : v;
+}
+
+KR_INLINE double kr_dist_exponential(struct kr_jsf32_ctx_s *x)
+{
+    const uint32_t *k = kr_dist_expk_detail_();
+    const double *w = kr_dist_expw_detail_(), *f = kr_dist_expf_detail_();
+    uint32_t u = 0, i = 0, j = 0;
+    double v = 0.0;
+
+    for (;;)
+    {
+        u = kr_jsf32_rand(x);
+        i = u & 0xFF;
+        j = u >> 8;
+        v = j * w[i];
+        if (j < k[i])
+        {
+            return v;
+        }
+
+        if (i == 0)
+        {
+            /* The tail of an exponential is another exponential. */
+            return KR_DIST_EXPR_DETAIL_ - kr_dist_log_detail_(kr_dist_open_detail_(x));
+        }
+
+        if (f[i] + kr_dist_double(x) * (f[i - 1] - f[i]) < kr_dist_exp_detail_(-v))
+        {
+            return v;
+        }
+    }
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE bool kr_dist_alias_init(struct kr_dist_alias_s *alias, const double *weights, size_t n)
+{
+    double sum = 0.0, *p = NULL;
+    uint32_t *work = NULL, small = 0, large = 0, s = 0, l = 0, i = 0;
+
+    alias->prob = NULL;
+    alias->alias = NULL;
+    alias->n = 0;
+
+    if (n == 0 || n > UINT32_MAX)
+    {
+        return false;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        if (!(weights[i] >= 0.0))
+        {
+            return false;
+        }
+        sum += weights[i];
+    }
+    if (!(sum > 0.0) || sum - sum != 0.0)
+    {
+        return false;
+    }
+
+    alias->prob = KR_CASTS(uint32_t *, kr_reallocarray(NULL, n, sizeof(uint32_t) * 2));
+    p = KR_CASTS(double *, kr_reallocarray(NULL, n, sizeof(double) + sizeof(uint32_t)));
+    if (alias->prob == NULL || p == NULL)
+    {
+        KR_FREE(alias->prob);
+        KR_FREE(p);
+        alias->prob = NULL;
+        return false;
+    }
+    alias->alias = alias->prob + n;
+    alias->n = KR_CASTS(uint32_t, n);
+
+    /* Scale so the average weight is 1, then sort outcomes into a stack of
+     * small ones growing from the front and large ones from the back. */
+    work = KR_CASTR(uint32_t *, p + n);
+    large = alias->n;
+    for (i = 0; i < n; i++)
+    {
+        p[i] = weights[i] * (KR_CASTS(double, n) / sum);
+        if (p[i] < 1.0)
+        {
+            work[small++] = i;
+        }
+        else
+        {
+            work[--large] = i;
+        }
+    }
+
+    /* Fill each small outcome's column with part of a large one. */
+    while (small != 0 && large != alias->n)
+    {
+        s = work[--small];
+        l = work[large++];
+        alias->prob[s] = p[s] * 4294967296.0 < 4294967295.0 ? KR_CASTS(uint32_t, p[s] * 4294967296.0) : UINT32_MAX;
+        alias->alias[s] = l;
+        p[l] = (p[l] + p[s]) - 1.0;
+        if (p[l] < 1.0)
+        {
+            work[small++] = l;
+        }
+        else
+        {
+            work[--large] = l;
+        }
+    }
+
+    /* Whatever is left is full, give or take rounding error. */
+    while (small != 0)
+    {
+        s = work[--small];
+        alias->prob[s] = UINT32_MAX;
+        alias->alias[s] = s;
+    }
+    while (large != alias->n)
+    {
+        l = work[large++];
+        alias->prob[l] = UINT32_MAX;
+        alias->alias[l] = l;
+    }
+
+    KR_FREE(p);
+    return true;
+}
+
+KR_INLINE void kr_dist_alias_free(struct kr_dist_alias_s *alias)
+{
+    KR_FREE(alias->prob);
+    alias->prob = NULL;
+    alias->alias = NULL;
+    alias->n = 0;
+}
+
+KR_INLINE uint32_t kr_dist_alias_sample(const struct kr_dist_alias_s *alias, struct kr_jsf32_ctx_s *x)
+{
+    const uint32_t i = kr_jsf32_rand_uniform(x, alias->n);
+    return kr_jsf32_rand(x) < alias->prob[i] ? i : alias->alias[i];
+}
+
+/******************************************************************************/
+
+KR_INLINE void kr_dist_shuffle(struct kr_jsf32_ctx_s *x, void *base, size_t nmemb, size_t size)
+{
+    unsigned char *bytes = KR_CASTS(unsigned char *, base), *a = NULL, *b = NULL;
+    unsigned char tmp[64];
+    size_t i = 0, j = 0, left = 0, chunk = 0;
+
+    for (i = nmemb; i > 1; i--)
+    {
+        j = kr_jsf32_rand_uniform(x, KR_CASTS(uint32_t, i));
+        if (j == i - 1)
+        {
+            continue;
+        }
+
+        a = bytes + (i - 1) * size;
+        b = bytes + j * size;
+        for (left = size; left != 0; left -= chunk)
+        {
+            chunk = left < sizeof(tmp) ? left : sizeof(tmp);
+            memcpy(tmp, a, chunk);
+            memcpy(a, b, chunk);
+            memcpy(b, tmp, chunk);
+            a += chunk;
+            b += chunk;
+        }
+    }
+}
+
+KR_INLINE uint32_t kr_dist_reservoir(struct kr_jsf32_ctx_s *x, uint32_t seen, uint32_t k)
+{
+    uint32_t j = 0;
+
+    if (seen < k)
+    {
+        return seen;
+    }
+
+    j = kr_jsf32_rand_uniform(x, seen + 1);
+    return j < k ? j : k;
+}
+
+#undef KR_DIST_LN2HI_DETAIL_
+#undef KR_DIST_LN2LO_DETAIL_
+#undef KR_DIST_NORMR_DETAIL_
+#undef KR_DIST_EXPR_DETAIL_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRDIST_H) */
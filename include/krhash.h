@@ -0,0 +1,506 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * Fast non-cryptographic hash functions that give the same results on every
+ * platform.
+ *
+ * Uses xxHash by Yann Collet, XXH32 and XXH64 specifically:
+ *  <https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md>
+ *
+ * xxHash passes SMHasher, runs at close to memory speed on large inputs, and
+ * is specified precisely enough that hashes can be stored or sent over the
+ * wire.  Input is read through krserial.h little-endian loads, so results
+ * match the reference implementation on big-endian machines too.
+ *
+ * These are not suitable for anything where an attacker picks the input and
+ * benefits from collisions.
+ */
+
+#if !defined(KRHASH_H)
+#define KRHASH_H
+
+#include "./krconfig.h"
+
+#include "./krbit.h" /* bit rotation */
+#include "./krint.h"
+#include "./krserial.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <string.h>
+#endif
+
+/******************************************************************************/
+
+/**
+ * @brief State for hashing input with XXH32 a piece at a time.
+ */
+struct kr_hash32_ctx_s
+{
+    uint32_t v[4];
+    uint32_t total;
+    uint32_t large;
+    unsigned char buf[16];
+    size_t bufLen;
+};
+
+/**
+ * @brief Hash a buffer with XXH32.
+ *
+ * @param data Buffer to hash.
+ * @param len Length of buffer in bytes.
+ * @param seed Seed, which gives an unrelated hash function for each value.
+ * @return 32-bit hash.
+ */
+KR_INLINE uint32_t kr_hash32(const void *data, size_t len, uint32_t seed);
+
+/**
+ * @brief Start hashing with XXH32 a piece at a time.
+ *
+ * @param ctx Context to initialize.
+ * @param seed Seed, as passed to kr_hash32.
+ */
+KR_INLINE void kr_hash32_init(struct kr_hash32_ctx_s *ctx, uint32_t seed);
+
+/**
+ * @brief Hash the next piece of input.
+ *
+ * @param ctx Context to update.
+ * @param data Buffer to hash.
+ * @param len Length of buffer in bytes.
+ */
+KR_INLINE void kr_hash32_update(struct kr_hash32_ctx_s *ctx, const void *data, size_t len);
+
+/**
+ * @brief Get the hash of all input so far.
+ *
+ * @details Does not change the context, so more input can follow.
+ *
+ * @param ctx Context to read.
+ * @return The same hash kr_hash32 would give for all input at once.
+ */
+KR_INLINE uint32_t kr_hash32_final(const struct kr_hash32_ctx_s *ctx);
+
+/**
+ * @brief Scramble the bits of an integer, so that every input bit affects
+ *        every output bit.
+ *
+ * @details Uses the XXH32 avalanche step.  Every output comes from exactly
+ *          one input, and 0 maps to 0.
+ */
+KR_CONSTEXPR uint32_t kr_hash_mix32(uint32_t x) KR_NOEXCEPT;
+
+#if defined(UINT64_MAX)
+
+/**
+ * @brief State for hashing input with XXH64 a piece at a time.
+ */
+struct kr_hash64_ctx_s
+{
+    uint64_t v[4];
+    uint64_t total;
+    unsigned char buf[32];
+    size_t bufLen;
+};
+
+/**
+ * @brief Hash a buffer with XXH64.
+ *
+ * @details Faster than kr_hash32 on 64-bit CPUs.
+ *
+ * @param data Buffer to hash.
+ * @param len Length of buffer in bytes.
+ * @param seed Seed, which gives an unrelated hash function for each value.
+ * @return 64-bit hash.
+ */
+KR_INLINE uint64_t kr_hash64(const void *data, size_t len, uint64_t seed);
+
+/**
+ * @brief Start hashing with XXH64 a piece at a time.
+ *
+ * @param ctx Context to initialize.
+ * @param seed Seed, as passed to kr_hash64.
+ */
+KR_INLINE void kr_hash64_init(struct kr_hash64_ctx_s *ctx, uint64_t seed);
+
+/**
+ * @brief Hash the next piece of input.
+ *
+ * @param ctx Context to update.
+ * @param data Buffer to hash.
+ * @param len Length of buffer in bytes.
+ */
+KR_INLINE void kr_hash64_update(struct kr_hash64_ctx_s *ctx, const void *data, size_t len);
+
+/**
+ * @brief Get the hash of all input so far.
+ *
+ * @details Does not change the context, so more input can follow.
+ *
+ * @param ctx Context to read.
+ * @return The same hash kr_hash64 would give for all input at once.
+ */
+KR_INLINE uint64_t kr_hash64_final(const struct kr_hash64_ctx_s *ctx);
+
+/**
+ * @brief Scramble the bits of an integer, so that every input bit affects
+ *        every output bit.
+ *
+ * @details Uses the XXH64 avalanche step.  Every output comes from exactly
+ *          one input, and 0 maps to 0.
+ */
+KR_CONSTEXPR uint64_t kr_hash_mix64(uint64_t x) KR_NOEXCEPT;
+
+#endif /* defined(UINT64_MAX) */
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+#define KR_HASH_P32_1_DETAIL_ UINT32_C(0x9E3779B1)
+#define KR_HASH_P32_2_DETAIL_ UINT32_C(0x85EBCA77)
+#define KR_HASH_P32_3_DETAIL_ UINT32_C(0xC2B2AE3D)
+#define KR_HASH_P32_4_DETAIL_ UINT32_C(0x27D4EB2F)
+#define KR_HASH_P32_5_DETAIL_ UINT32_C(0x165667B1)
+
+KR_INLINE uint32_t kr_hash32_round_detail_(uint32_t acc, uint32_t input)
+{
+    acc += input * KR_HASH_P32_2_DETAIL_;
+    acc = kr_rotate_left32(acc, 13);
+    return acc * KR_HASH_P32_1_DETAIL_;
+}
+
+/**
+ * @brief Mix in every 16-byte stripe of a buffer.
+ *
+ * @return Number of bytes consumed.
+ */
+KR_INLINE size_t kr_hash32_stripes_detail_(uint32_t v[4], const unsigned char *p, size_t len)
+{
+    /* Separate accumulators keep the four multiply chains independent. */
+    uint32_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    const unsigned char *const start = p, *const end = p + (len & ~KR_CASTS(size_t, 15));
+
+    for (; p != end; p += 16)
+    {
+        v1 = kr_hash32_round_detail_(v1, kr_load_u32le(p));
+        v2 = kr_hash32_round_detail_(v2, kr_load_u32le(p + 4));
+        v3 = kr_hash32_round_detail_(v3, kr_load_u32le(p + 8));
+        v4 = kr_hash32_round_detail_(v4, kr_load_u32le(p + 12));
+    }
+
+    v[0] = v1;
+    v[1] = v2;
+    v[2] = v3;
+    v[3] = v4;
+    return KR_CASTS(size_t, p - start);
+}
+
+/**
+ * @brief Mix in the last 0 to 15 bytes and scramble the result.
+ */
+KR_INLINE uint32_t kr_hash32_finish_detail_(uint32_t h, const unsigned char *p, size_t len)
+{
+    for (; len >= 4; p += 4, len -= 4)
+    {
+        h += kr_load_u32le(p) * KR_HASH_P32_3_DETAIL_;
+        h = kr_rotate_left32(h, 17) * KR_HASH_P32_4_DETAIL_;
+    }
+    for (; len > 0; p++, len--)
+    {
+        h += KR_CASTS(uint32_t, *p) * KR_HASH_P32_5_DETAIL_;
+        h = kr_rotate_left32(h, 11) * KR_HASH_P32_1_DETAIL_;
+    }
+    return kr_hash_mix32(h);
+}
+
+KR_INLINE uint32_t kr_hash32_merge_detail_(const uint32_t v[4])
+{
+    return kr_rotate_left32(v[0], 1) + kr_rotate_left32(v[1], 7) + kr_rotate_left32(v[2], 12) +
+           kr_rotate_left32(v[3], 18);
+}
+
+KR_INLINE uint32_t kr_hash32(const void *data, size_t len, uint32_t seed)
+{
+    const unsigned char *p = KR_CASTS(const unsigned char *, data);
+    uint32_t v[4];
+    uint32_t h = 0;
+    size_t used = 0;
+
+    if (len >= 16)
+    {
+        v[0] = seed + KR_HASH_P32_1_DETAIL_ + KR_HASH_P32_2_DETAIL_;
+        v[1] = seed + KR_HASH_P32_2_DETAIL_;
+        v[2] = seed;
+        v[3] = seed - KR_HASH_P32_1_DETAIL_;
+        used = kr_hash32_stripes_detail_(v, p, len);
+        h = kr_hash32_merge_detail_(v);
+    }
+    else
+    {
+        h = seed + KR_HASH_P32_5_DETAIL_;
+    }
+
+    h += KR_CASTS(uint32_t, len);
+    return kr_hash32_finish_detail_(h, p + used, len - used);
+}
+
+KR_INLINE void kr_hash32_init(struct kr_hash32_ctx_s *ctx, uint32_t seed)
+{
+    ctx->v[0] = seed + KR_HASH_P32_1_DETAIL_ + KR_HASH_P32_2_DETAIL_;
+    ctx->v[1] = seed + KR_HASH_P32_2_DETAIL_;
+    ctx->v[2] = seed;
+    ctx->v[3] = seed - KR_HASH_P32_1_DETAIL_;
+    ctx->total = 0;
+    ctx->large = 0;
+    ctx->bufLen = 0;
+}
+
+KR_INLINE void kr_hash32_update(struct kr_hash32_ctx_s *ctx, const void *data, size_t len)
+{
+    const unsigned char *p = KR_CASTS(const unsigned char *, data);
+    size_t fill = 0;
+
+    /* The total wraps, so remember separately if there was ever a stripe. */
+    ctx->total += KR_CASTS(uint32_t, len);
+    ctx->large |= (len >= 16 || ctx->total >= 16) ? 1 : 0;
+
+    if (ctx->bufLen + len < 16)
+    {
+        if (len > 0)
+        {
+            memcpy(ctx->buf + ctx->bufLen, p, len);
+        }
+        ctx->bufLen += len;
+        return;
+    }
+
+    if (ctx->bufLen > 0)
+    {
+        fill = 16 - ctx->bufLen;
+        memcpy(ctx->buf + ctx->bufLen, p, fill);
+        kr_hash32_stripes_detail_(ctx->v, ctx->buf, 16);
+        p += fill;
+        len -= fill;
+        ctx->bufLen = 0;
+    }
+
+    fill = kr_hash32_stripes_detail_(ctx->v, p, len);
+    ctx->bufLen = len - fill;
+    if (ctx->bufLen > 0)
+    {
+        memcpy(ctx->buf, p + fill, ctx->bufLen);
+    }
+}
+
+KR_INLINE uint32_t kr_hash32_final(const struct kr_hash32_ctx_s *ctx)
+{
+    /* v[2] is still the seed if no stripe was mixed in. */
+    uint32_t h = ctx->large ? kr_hash32_merge_detail_(ctx->v) : ctx->v[2] + KR_HASH_P32_5_DETAIL_;
+    h += ctx->total;
+    return kr_hash32_finish_detail_(h, ctx->buf, ctx->bufLen);
+}
+
+KR_CONSTEXPR uint32_t kr_hash_mix32(uint32_t x) KR_NOEXCEPT
+{
+    x ^= x >> 15;
+    x *= KR_HASH_P32_2_DETAIL_;
+    x ^= x >> 13;
+    x *= KR_HASH_P32_3_DETAIL_;
+    x ^= x >> 16;
+    return x;
+}
+
+#undef KR_HASH_P32_1_DETAIL_
+#undef KR_HASH_P32_2_DETAIL_
+#undef KR_HASH_P32_3_DETAIL_
+#undef KR_HASH_P32_4_DETAIL_
+#undef KR_HASH_P32_5_DETAIL_
+
+/******************************************************************************/
+
+#if defined(UINT64_MAX)
+
+#define KR_HASH_P64_1_DETAIL_ UINT64_C(0x9E3779B185EBCA87)
+#define KR_HASH_P64_2_DETAIL_ UINT64_C(0xC2B2AE3D27D4EB4F)
+#define KR_HASH_P64_3_DETAIL_ UINT64_C(0x165667B19E3779F9)
+#define KR_HASH_P64_4_DETAIL_ UINT64_C(0x85EBCA77C2B2AE63)
+#define KR_HASH_P64_5_DETAIL_ UINT64_C(0x27D4EB2F165667C5)
+
+KR_INLINE uint64_t kr_hash64_round_detail_(uint64_t acc, uint64_t input)
+{
+    acc += input * KR_HASH_P64_2_DETAIL_;
+    acc = kr_rotate_left64(acc, 31);
+    return acc * KR_HASH_P64_1_DETAIL_;
+}
+
+KR_INLINE uint64_t kr_hash64_merge_round_detail_(uint64_t acc, uint64_t v)
+{
+    acc ^= kr_hash64_round_detail_(0, v);
+    return acc * KR_HASH_P64_1_DETAIL_ + KR_HASH_P64_4_DETAIL_;
+}
+
+/**
+ * @brief Mix in every 32-byte stripe of a buffer.
+ *
+ * @return Number of bytes consumed.
+ */
+KR_INLINE size_t kr_hash64_stripes_detail_(uint64_t v[4], const unsigned char *p, size_t len)
+{
+    uint64_t v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    const unsigned char *const start = p, *const end = p + (len & ~KR_CASTS(size_t, 31));
+
+    for (; p != end; p += 32)
+    {
+        v1 = kr_hash64_round_detail_(v1, kr_load_u64le(p));
+        v2 = kr_hash64_round_detail_(v2, kr_load_u64le(p + 8));
+        v3 = kr_hash64_round_detail_(v3, kr_load_u64le(p + 16));
+        v4 = kr_hash64_round_detail_(v4, kr_load_u64le(p + 24));
+    }
+
+    v[0] = v1;
+    v[1] = v2;
+    v[2] = v3;
+    v[3] = v4;
+    return KR_CASTS(size_t, p - start);
+}
+
+KR_INLINE uint64_t kr_hash64_merge_detail_(const uint64_t v[4])
+{
+    uint64_t h = kr_rotate_left64(v[0], 1) + kr_rotate_left64(v[1], 7) + kr_rotate_left64(v[2], 12) +
+                 kr_rotate_left64(v[3], 18);
+    h = kr_hash64_merge_round_detail_(h, v[0]);
+    h = kr_hash64_merge_round_detail_(h, v[1]);
+    h = kr_hash64_merge_round_detail_(h, v[2]);
+    return kr_hash64_merge_round_detail_(h, v[3]);
+}
+
+/**
+ * @brief Mix in the last 0 to 31 bytes and scramble the result.
+ */
+KR_INLINE uint64_t kr_hash64_finish_detail_(uint64_t h, const unsigned char *p, size_t len)
+{
+    for (; len >= 8; p += 8, len -= 8)
+    {
+        h ^= kr_hash64_round_detail_(0, kr_load_u64le(p));
+        h = kr_rotate_left64(h, 27) * KR_HASH_P64_1_DETAIL_ + KR_HASH_P64_4_DETAIL_;
+    }
+    if (len >= 4)
+    {
+        h ^= KR_CASTS(uint64_t, kr_load_u32le(p)) * KR_HASH_P64_1_DETAIL_;
+        h = kr_rotate_left64(h, 23) * KR_HASH_P64_2_DETAIL_ + KR_HASH_P64_3_DETAIL_;
+        p += 4;
+        len -= 4;
+    }
+    for (; len > 0; p++, len--)
+    {
+        h ^= KR_CASTS(uint64_t, *p) * KR_HASH_P64_5_DETAIL_;
+        h = kr_rotate_left64(h, 11) * KR_HASH_P64_1_DETAIL_;
+    }
+    return kr_hash_mix64(h);
+}
+
+KR_INLINE uint64_t kr_hash64(const void *data, size_t len, uint64_t seed)
+{
+    const unsigned char *p = KR_CASTS(const unsigned char *, data);
+    uint64_t v[4];
+    uint64_t h = 0;
+    size_t used = 0;
+
+    if (len >= 32)
+    {
+        v[0] = seed + KR_HASH_P64_1_DETAIL_ + KR_HASH_P64_2_DETAIL_;
+        v[1] = seed + KR_HASH_P64_2_DETAIL_;
+        v[2] = seed;
+        v[3] = seed - KR_HASH_P64_1_DETAIL_;
+        used = kr_hash64_stripes_detail_(v, p, len);
+        h = kr_hash64_merge_detail_(v);
+    }
+    else
+    {
+        h = seed + KR_HASH_P64_5_DETAIL_;
+    }
+
+    h += len;
+    return kr_hash64_finish_detail_(h, p + used, len - used);
+}
+
+KR_INLINE void kr_hash64_init(struct kr_hash64_ctx_s *ctx, uint64_t seed)
+{
+    ctx->v[0] = seed + KR_HASH_P64_1_DETAIL_ + KR_HASH_P64_2_DETAIL_;
+    ctx->v[1] = seed + KR_HASH_P64_2_DETAIL_;
+    ctx->v[2] = seed;
+    ctx->v[3] = seed - KR_HASH_P64_1_DETAIL_;
+    ctx->total = 0;
+    ctx->bufLen = 0;
+}
+
+KR_INLINE void kr_hash64_update(struct kr_hash64_ctx_s *ctx, const void *data, size_t len)
+{
+    const unsigned char *p = KR_CASTS(const unsigned char *, data);
+    size_t fill = 0;
+
+    ctx->total += len;
+
+    if (ctx->bufLen + len < 32)
+    {
+        if (len > 0)
+        {
+            memcpy(ctx->buf + ctx->bufLen, p, len);
+        }
+        ctx->bufLen += len;
+        return;
+    }
+
+    if (ctx->bufLen > 0)
+    {
+        fill = 32 - ctx->bufLen;
+        memcpy(ctx->buf + ctx->bufLen, p, fill);
+        kr_hash64_stripes_detail_(ctx->v, ctx->buf, 32);
+        p += fill;
+        len -= fill;
+        ctx->bufLen = 0;
+    }
+
+    fill = kr_hash64_stripes_detail_(ctx->v, p, len);
+    ctx->bufLen = len - fill;
+    if (ctx->bufLen > 0)
+    {
+        memcpy(ctx->buf, p + fill, ctx->bufLen);
+    }
+}
+
+KR_INLINE uint64_t kr_hash64_final(const struct kr_hash64_ctx_s *ctx)
+{
+    uint64_t h = ctx->total >= 32 ? kr_hash64_merge_detail_(ctx->v) : ctx->v[2] + KR_HASH_P64_5_DETAIL_;
+    h += ctx->total;
+    return kr_hash64_finish_detail_(h, ctx->buf, ctx->bufLen);
+}
+
+KR_CONSTEXPR uint64_t kr_hash_mix64(uint64_t x) KR_NOEXCEPT
+{
+    x ^= x >> 33;
+    x *= KR_HASH_P64_2_DETAIL_;
+    x ^= x >> 29;
+    x *= KR_HASH_P64_3_DETAIL_;
+    x ^= x >> 32;
+    return x;
+}
+
+#undef KR_HASH_P64_1_DETAIL_
+#undef KR_HASH_P64_2_DETAIL_
+#undef KR_HASH_P64_3_DETAIL_
+#undef KR_HASH_P64_4_DETAIL_
+#undef KR_HASH_P64_5_DETAIL_
+
+#endif /* defined(UINT64_MAX) */
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRHASH_H) */
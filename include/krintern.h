@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * String interning.
+ *
+ * An interner keeps one copy of every distinct string it is given, so two
+ * interned strings are equal if and only if they are the same pointer.
+ * Copies live in an arena and never move, and a kr_map of their hashes and
+ * lengths finds the existing copy of a string without comparing it against
+ * anything but likely matches.
+ */
+
+#if !defined(KRINTERN_H)
+#define KRINTERN_H
+
+#include "./krconfig.h"
+
+#include "./krarena.h"
+#include "./krbool.h"
+#include "./krmap.h"
+#include "./krstr.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <string.h>
+#endif
+
+/**
+ * @brief An interned string, as stored in the map of an interner.
+ */
+struct kr_intern_entry_s
+{
+    size_t hash;
+    size_t len;
+    const char *str;
+};
+
+/**
+ * @brief A table of unique strings.
+ */
+struct kr_intern_s
+{
+    struct kr_map_s map;
+    struct kr_arena_s arena;
+};
+
+/**
+ * @brief Initialize an empty interner.  No memory is allocated until the
+ *        first string is interned.
+ *
+ * @param intern Interner to initialize.
+ * @param blockSize Size of each block of string storage.
+ */
+KR_INLINE void kr_intern_init(struct kr_intern_s *intern, size_t blockSize);
+
+/**
+ * @brief Free every interned string and leave the interner empty.
+ *
+ * @param intern Interner to free.
+ */
+KR_INLINE void kr_intern_free(struct kr_intern_s *intern);
+
+/**
+ * @brief Forget every interned string, keeping memory for reuse.  Pointers
+ *        returned before are no longer valid.
+ *
+ * @param intern Interner to clear.
+ */
+KR_INLINE void kr_intern_clear(struct kr_intern_s *intern);
+
+/**
+ * @brief Intern a string of a given length, which may contain null
+ *        characters.
+ *
+ * @param intern Interner to modify.
+ * @param str String to intern.  May be NULL if len is 0.
+ * @param len Length of the string.
+ * @return Null-terminated interned copy of the string, or NULL if allocation
+ *         failed.  Valid until the interner is cleared or freed.
+ */
+KR_NODISCARD KR_INLINE const char *kr_intern_strn(struct kr_intern_s *intern, const char *str, size_t len);
+
+/**
+ * @brief Intern a null-terminated string.
+ *
+ * @param intern Interner to modify.
+ * @param str String to intern.
+ * @return Interned copy of the string, or NULL if allocation failed.  Valid
+ *         until the interner is cleared or freed.
+ */
+KR_NODISCARD KR_INLINE const char *kr_intern_str(struct kr_intern_s *intern, const char *str);
+
+/**
+ * @brief Find the interned copy of a string without adding it.
+ *
+ * @param intern Interner to search.
+ * @param str String to find.  May be NULL if len is 0.
+ * @param len Length of the string.
+ * @return Interned copy of the string, or NULL if it has not been interned.
+ */
+KR_INLINE const char *kr_intern_find(const struct kr_intern_s *intern, const char *str, size_t len);
+
+/**
+ * @brief Get the number of distinct strings in an interner.
+ */
+KR_INLINE size_t kr_intern_count(const struct kr_intern_s *intern);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/**
+ * @brief Entries carry their own hash, so the map never rehashes strings.
+ */
+KR_INLINE size_t kr_intern_hash_detail_(const void *key, size_t keySize)
+{
+    (void)keySize;
+    return (KR_CASTS(const struct kr_intern_entry_s *, key))->hash;
+}
+
+KR_INLINE bool kr_intern_equal_detail_(const void *a, const void *b, size_t keySize)
+{
+    const struct kr_intern_entry_s *ea = KR_CASTS(const struct kr_intern_entry_s *, a);
+    const struct kr_intern_entry_s *eb = KR_CASTS(const struct kr_intern_entry_s *, b);
+    (void)keySize;
+    return ea->hash == eb->hash && ea->len == eb->len && (ea->len == 0 || memcmp(ea->str, eb->str, ea->len) == 0);
+}
+
+KR_INLINE void kr_intern_init(struct kr_intern_s *intern, size_t blockSize)
+{
+    kr_map_init(&intern->map, sizeof(struct kr_intern_entry_s), 0, kr_intern_hash_detail_, kr_intern_equal_detail_);
+    kr_arena_init(&intern->arena, blockSize);
+}
+
+KR_INLINE void kr_intern_free(struct kr_intern_s *intern)
+{
+    kr_map_free(&intern->map);
+    kr_arena_destroy(&intern->arena);
+}
+
+KR_INLINE void kr_intern_clear(struct kr_intern_s *intern)
+{
+    kr_map_clear(&intern->map);
+    kr_arena_reset(&intern->arena);
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE const char *kr_intern_strn(struct kr_intern_s *intern, const char *str, size_t len)
+{
+    struct kr_intern_entry_s key;
+    struct kr_intern_entry_s *entry = NULL;
+    char *dup = NULL;
+    bool inserted = false;
+
+    key.hash = kr_map_hash_bytes(str, len);
+    key.len = len;
+    key.str = str;
+
+    entry = KR_CASTS(struct kr_intern_entry_s *, kr_map_insert(&intern->map, &key, &inserted));
+    if (entry == NULL || !inserted)
+    {
+        return entry != NULL ? entry->str : NULL;
+    }
+
+    /* New string, so the entry still points at the caller's copy. */
+    dup = len < SIZE_MAX ? KR_CASTS(char *, kr_arena_alloc_aligned(&intern->arena, len + 1, 1)) : NULL;
+    if (dup == NULL)
+    {
+        kr_map_remove(&intern->map, &key);
+        return NULL;
+    }
+
+    if (len != 0)
+    {
+        memcpy(dup, str, len);
+    }
+    dup[len] = '\0';
+    entry->str = dup;
+    return dup;
+}
+
+KR_NODISCARD KR_INLINE const char *kr_intern_str(struct kr_intern_s *intern, const char *str)
+{
+    return kr_intern_strn(intern, str, kr_strlen(str));
+}
+
+KR_INLINE const char *kr_intern_find(const struct kr_intern_s *intern, const char *str, size_t len)
+{
+    struct kr_intern_entry_s key;
+    const struct kr_intern_entry_s *entry = NULL;
+
+    key.hash = kr_map_hash_bytes(str, len);
+    key.len = len;
+    key.str = str;
+
+    entry = KR_CASTS(const struct kr_intern_entry_s *, kr_map_find(&intern->map, &key));
+    return entry != NULL ? entry->str : NULL;
+}
+
+KR_INLINE size_t kr_intern_count(const struct kr_intern_s *intern)
+{
+    return intern->map.count;
+}
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRINTERN_H) */
@@ -0,0 +1,618 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * Open-addressing hash map, in the style of Abseil's Swiss tables:
+ *  <https://abseil.io/about/design/swisstables>
+ *
+ * Every slot has a control byte that is either empty or holds 7 bits of the
+ * key's hash, kept in an array apart from the slots themselves.  A lookup
+ * compares a whole group of control bytes against the hash at once, with
+ * SSE2 or with SWAR on a 64-bit word, so it usually touches one cache line
+ * of control bytes and one key no matter how long the probe is.
+ *
+ * Unlike Swiss tables, probing is linear, so removing an entry can shift the
+ * entries after it back instead of leaving a tombstone.  Lookups never slow
+ * down as entries come and go, and the table never needs rehashing to clean
+ * up.  Growing reallocates every array with KR_REALLOC and rehashes in
+ * place.  The full hash of every entry is kept in a third array, so neither
+ * shifting nor growing calls the hash function again.
+ *
+ * Keys and values are copied in and out as plain bytes of a fixed size.  A
+ * slot holds a key followed by its value, each aligned as strictly as its
+ * size allows, so a lookup that hits usually touches two cache lines.
+ */
+
+#if !defined(KRMAP_H)
+#define KRMAP_H
+
+#include "./krconfig.h"
+
+#include "./krbltin.h"
+#include "./krbool.h"
+#include "./krhash.h"
+#include "./krint.h"
+#include "./krlib.h"
+#include "./krserial.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <string.h>
+
+#if (KR_SSE2)
+#include <emmintrin.h>
+#endif
+#endif /* (!KR_CONFIG_NOINCLUDE) */
+
+/**
+ * @brief A hash map from fixed-size keys to fixed-size values.
+ */
+struct kr_map_s
+{
+    unsigned char *ctrl;
+    unsigned char *slots;
+    size_t *hashes;
+    size_t keySize;
+    size_t valSize;
+    size_t valOffset;
+    size_t slotSize;
+    size_t cap;
+    size_t count;
+    size_t growth;
+    size_t (*hash)(const void *key, size_t keySize);
+    bool (*equal)(const void *a, const void *b, size_t keySize);
+};
+
+/**
+ * @brief Initialize an empty map.  No memory is allocated until the first
+ *        insertion.
+ *
+ * @param map Map to initialize.
+ * @param keySize Size of each key.  Must not be 0.
+ * @param valSize Size of each value.  Pass 0 for a set.
+ * @param hash Function to hash a key, or NULL for kr_map_hash_bytes.  Both
+ *        the low and the high bits of the hash must be well mixed.
+ * @param equal Function to compare two keys, or NULL to compare their bytes.
+ */
+KR_INLINE void kr_map_init(struct kr_map_s *map, size_t keySize, size_t valSize,
+                           size_t (*hash)(const void *key, size_t keySize),
+                           bool (*equal)(const void *a, const void *b, size_t keySize));
+
+/**
+ * @brief Free any memory owned by a map and leave it empty.
+ *
+ * @param map Map to free.
+ */
+KR_INLINE void kr_map_free(struct kr_map_s *map);
+
+/**
+ * @brief Remove every entry from a map, keeping its memory.
+ *
+ * @param map Map to clear.
+ */
+KR_INLINE void kr_map_clear(struct kr_map_s *map);
+
+/**
+ * @brief Make room for a number of entries, so inserting up to that many
+ *        never allocates.
+ *
+ * @param map Map to grow.
+ * @param n Total number of entries to make room for.
+ * @return true if successful, or false if allocation failed.  The map is
+ *         unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_map_reserve(struct kr_map_s *map, size_t n);
+
+/**
+ * @brief Find the value for a key.
+ *
+ * @param map Map to search.
+ * @param key Key to find.
+ * @return Pointer to the value, or NULL if the key is not in the map.  For a
+ *         set, a pointer to the stored key.  Valid until the next insertion
+ *         or removal.
+ */
+KR_INLINE void *kr_map_find(const struct kr_map_s *map, const void *key);
+
+/**
+ * @brief Find the value for a key, adding the key if it is not there.
+ *
+ * @param map Map to modify.
+ * @param key Key to find or add.
+ * @param inserted Set to true if the key was added, or false if it was
+ *        already there.  May be NULL.
+ * @return Pointer to the value, or NULL if allocation failed.  For a set, a
+ *         pointer to the stored key.  A new value is uninitialized.  Valid
+ *         until the next insertion or removal.
+ */
+KR_NODISCARD KR_INLINE void *kr_map_insert(struct kr_map_s *map, const void *key, bool *inserted);
+
+/**
+ * @brief Remove a key and its value.
+ *
+ * @param map Map to modify.
+ * @param key Key to remove.
+ * @return true if the key was removed, or false if it was not in the map.
+ */
+KR_INLINE bool kr_map_remove(struct kr_map_s *map, const void *key);
+
+/**
+ * @brief Find the next slot in a map with an entry.
+ *
+ * @details To visit every entry, start at 0 and pass one past the last slot
+ *          returned, until map->cap is returned.  Order is unspecified.  Do
+ *          not insert or remove entries while iterating.
+ *
+ * @param map Map to iterate.
+ * @param slot First slot to check.
+ * @return Slot with an entry, or map->cap if there are no more.
+ */
+KR_INLINE size_t kr_map_next(const struct kr_map_s *map, size_t slot);
+
+/**
+ * @brief Get the key in a slot returned by kr_map_next.
+ */
+KR_INLINE void *kr_map_key(const struct kr_map_s *map, size_t slot);
+
+/**
+ * @brief Get the value in a slot returned by kr_map_next.
+ */
+KR_INLINE void *kr_map_value(const struct kr_map_s *map, size_t slot);
+
+/**
+ * @brief Hash the bytes of a key with xxHash.  The default hash function.
+ */
+KR_INLINE size_t kr_map_hash_bytes(const void *key, size_t keySize);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/**
+ * @brief Number of control bytes checked at once, which is also the smallest
+ *        capacity.
+ */
+#if (KR_SSE2)
+#define KR_MAP_GROUP_DETAIL_ (16)
+#elif defined(UINT64_MAX)
+#define KR_MAP_GROUP_DETAIL_ (8)
+#else
+#define KR_MAP_GROUP_DETAIL_ (4)
+#endif
+
+/**
+ * @brief Control byte of an empty slot.  Full slots never set the top bit.
+ */
+#define KR_MAP_EMPTY_DETAIL_ (0x80)
+
+/**
+ * @brief Control byte of a slot waiting to be moved during a rehash.
+ */
+#define KR_MAP_PENDING_DETAIL_ (0xFF)
+
+KR_INLINE size_t kr_map_h2_detail_(size_t hash)
+{
+    return (hash >> (KR_SIZEOF_SIZE_T * 8 - 7)) & 0x7F;
+}
+
+/**
+ * @brief Set the control byte of a slot, along with its copy past the end
+ *        that lets groups at the end of the table wrap around.
+ */
+KR_INLINE void kr_map_set_ctrl_detail_(struct kr_map_s *map, size_t slot, unsigned char c)
+{
+    map->ctrl[slot] = c;
+    if (slot < KR_MAP_GROUP_DETAIL_ - 1)
+    {
+        map->ctrl[map->cap + slot] = c;
+    }
+}
+
+/*
+ * Group matching.  Each returns a mask with bit i set if slot i of the group
+ * matches.  The SWAR versions can report a false match for the byte after a
+ * real one, which only costs an extra key comparison.
+ */
+
+#if (KR_SSE2)
+
+KR_INLINE uint32_t kr_map_match_detail_(const unsigned char *ctrl, size_t h2)
+{
+    const __m128i group = _mm_loadu_si128(KR_CASTR(const __m128i *, ctrl));
+    return KR_CASTS(uint32_t, _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(KR_CASTS(char, h2)))));
+}
+
+KR_INLINE uint32_t kr_map_empty_detail_(const unsigned char *ctrl)
+{
+    return KR_CASTS(uint32_t, _mm_movemask_epi8(_mm_loadu_si128(KR_CASTR(const __m128i *, ctrl))));
+}
+
+#elif defined(UINT64_MAX)
+
+/**
+ * @brief Gather the top bit of each byte into the low 8 bits.
+ */
+KR_INLINE uint32_t kr_map_movemask_detail_(uint64_t x)
+{
+    return KR_CASTS(uint32_t, ((x >> 7) * UINT64_C(0x0102040810204080)) >> 56);
+}
+
+KR_INLINE uint32_t kr_map_match_detail_(const unsigned char *ctrl, size_t h2)
+{
+    const uint64_t x = kr_load_u64le(ctrl) ^ (UINT64_C(0x0101010101010101) * h2);
+    return kr_map_movemask_detail_((x - UINT64_C(0x0101010101010101)) & ~x & UINT64_C(0x8080808080808080));
+}
+
+KR_INLINE uint32_t kr_map_empty_detail_(const unsigned char *ctrl)
+{
+    return kr_map_movemask_detail_(kr_load_u64le(ctrl) & UINT64_C(0x8080808080808080));
+}
+
+#else
+
+KR_INLINE uint32_t kr_map_movemask_detail_(uint32_t x)
+{
+    return ((x >> 7) * UINT32_C(0x01020408)) >> 24;
+}
+
+KR_INLINE uint32_t kr_map_match_detail_(const unsigned char *ctrl, size_t h2)
+{
+    const uint32_t x = kr_load_u32le(ctrl) ^ (UINT32_C(0x01010101) * KR_CASTS(uint32_t, h2));
+    return kr_map_movemask_detail_((x - UINT32_C(0x01010101)) & ~x & UINT32_C(0x80808080));
+}
+
+KR_INLINE uint32_t kr_map_empty_detail_(const unsigned char *ctrl)
+{
+    return kr_map_movemask_detail_(kr_load_u32le(ctrl) & UINT32_C(0x80808080));
+}
+
+#endif
+
+/**
+ * @brief Look for a key.
+ *
+ * @param map Map to search.  Must have a capacity.
+ * @param key Key to find.
+ * @param hash Hash of the key.
+ * @param slot Set to the slot of the key, or if it is not there, to the slot
+ *        it would be inserted into.
+ * @return true if the key was found.
+ */
+KR_INLINE bool kr_map_probe_detail_(const struct kr_map_s *map, const void *key, size_t hash, size_t *slot)
+{
+    const size_t mask = map->cap - 1, h2 = kr_map_h2_detail_(hash);
+    size_t pos = hash & mask, i = 0;
+    uint32_t match = 0, empty = 0;
+
+    for (;;)
+    {
+        match = kr_map_match_detail_(map->ctrl + pos, h2);
+        empty = kr_map_empty_detail_(map->ctrl + pos);
+        if (empty != 0)
+        {
+            /* The key can only be before the first empty slot. */
+            match &= (empty & (0u - empty)) - 1;
+        }
+
+        for (; match != 0; match &= match - 1)
+        {
+            i = (pos + KR_CASTS(size_t, kr_ctz32(match))) & mask;
+            if (map->equal(map->slots + i * map->slotSize, key, map->keySize))
+            {
+                *slot = i;
+                return true;
+            }
+        }
+
+        if (empty != 0)
+        {
+            *slot = (pos + KR_CASTS(size_t, kr_ctz32(empty))) & mask;
+            return false;
+        }
+        pos = (pos + KR_MAP_GROUP_DETAIL_) & mask;
+    }
+}
+
+/**
+ * @brief Copy a slot and its hash to another.
+ */
+KR_INLINE void kr_map_move_detail_(struct kr_map_s *map, size_t dest, size_t src)
+{
+    memcpy(map->slots + dest * map->slotSize, map->slots + src * map->slotSize, map->slotSize);
+    map->hashes[dest] = map->hashes[src];
+}
+
+/**
+ * @brief Move every entry to where it belongs in a table of a new size.
+ *
+ * @details Every full slot is marked pending, then each pending entry goes
+ *          to the first slot after its home that is not yet placed.  If
+ *          that slot is pending too, the two entries swap and the other one
+ *          is placed next.  Placed slots are never moved or emptied, so the
+ *          run of slots from an entry's home to the entry stays full.
+ */
+KR_INLINE void kr_map_rehash_detail_(struct kr_map_s *map, size_t oldCap)
+{
+    const size_t mask = map->cap - 1, scratch = map->cap;
+    size_t i = 0, t = 0, hash = 0;
+
+    for (i = 0; i < oldCap; i++)
+    {
+        map->ctrl[i] = (map->ctrl[i] & KR_MAP_EMPTY_DETAIL_) ? KR_MAP_EMPTY_DETAIL_ : KR_MAP_PENDING_DETAIL_;
+    }
+    memset(map->ctrl + oldCap, KR_MAP_EMPTY_DETAIL_, map->cap - oldCap);
+
+    for (i = 0; i < map->cap; i++)
+    {
+        while (map->ctrl[i] == KR_MAP_PENDING_DETAIL_)
+        {
+            hash = map->hashes[i];
+            for (t = hash & mask; !(map->ctrl[t] & KR_MAP_EMPTY_DETAIL_); t = (t + 1) & mask)
+            {
+            }
+
+            if (t == i)
+            {
+                map->ctrl[i] = KR_CASTS(unsigned char, kr_map_h2_detail_(hash));
+            }
+            else if (map->ctrl[t] == KR_MAP_EMPTY_DETAIL_)
+            {
+                kr_map_move_detail_(map, t, i);
+                map->ctrl[t] = KR_CASTS(unsigned char, kr_map_h2_detail_(hash));
+                map->ctrl[i] = KR_MAP_EMPTY_DETAIL_;
+            }
+            else
+            {
+                kr_map_move_detail_(map, scratch, t);
+                kr_map_move_detail_(map, t, i);
+                kr_map_move_detail_(map, i, scratch);
+                map->ctrl[t] = KR_CASTS(unsigned char, kr_map_h2_detail_(hash));
+            }
+        }
+    }
+
+    memcpy(map->ctrl + map->cap, map->ctrl, KR_MAP_GROUP_DETAIL_ - 1);
+}
+
+/**
+ * @brief Find how many entries fit in a capacity.  At least one slot in
+ *        eight stays empty, and always at least one, so probes stay short
+ *        and always end.
+ */
+KR_INLINE size_t kr_map_max_load_detail_(size_t cap)
+{
+    return cap - (cap / 8 != 0 ? cap / 8 : 1);
+}
+
+/**
+ * @brief Change the capacity of a map, which must be a power of two that
+ *        is larger than the current one.
+ */
+KR_INLINE bool kr_map_resize_detail_(struct kr_map_s *map, size_t cap)
+{
+    const size_t oldCap = map->cap;
+    unsigned char *p = NULL;
+    size_t *hashes = NULL;
+
+    /* A bigger array from realloc is harmless even if another one fails,
+     * since the old capacity is still used until all of them succeed.  There
+     * is one extra slot and hash for swapping. */
+    p = KR_CASTS(unsigned char *, KR_REALLOC(map->ctrl, cap + KR_MAP_GROUP_DETAIL_ - 1));
+    if (p == NULL)
+    {
+        return false;
+    }
+    map->ctrl = p;
+
+    p = KR_CASTS(unsigned char *, kr_reallocarray(map->slots, cap + 1, map->slotSize));
+    if (p == NULL)
+    {
+        return false;
+    }
+    map->slots = p;
+
+    hashes = KR_CASTS(size_t *, kr_reallocarray(map->hashes, cap + 1, sizeof(size_t)));
+    if (hashes == NULL)
+    {
+        return false;
+    }
+    map->hashes = hashes;
+
+    map->cap = cap;
+    map->growth = kr_map_max_load_detail_(cap) - map->count;
+    kr_map_rehash_detail_(map, oldCap);
+    return true;
+}
+
+/**
+ * @brief Find the largest power of two that divides a size, up to 16, which
+ *        is as strict as the alignment of a type that size can be.
+ */
+KR_INLINE size_t kr_map_align_detail_(size_t size)
+{
+    const size_t align = size & (0 - size);
+    return align == 0 ? 1 : (align > 16 ? 16 : align);
+}
+
+KR_INLINE bool kr_map_equal_bytes_detail_(const void *a, const void *b, size_t keySize)
+{
+    return memcmp(a, b, keySize) == 0;
+}
+
+/******************************************************************************/
+
+KR_INLINE void kr_map_init(struct kr_map_s *map, size_t keySize, size_t valSize,
+                           size_t (*hash)(const void *key, size_t keySize),
+                           bool (*equal)(const void *a, const void *b, size_t keySize))
+{
+    const size_t keyAlign = kr_map_align_detail_(keySize), valAlign = kr_map_align_detail_(valSize);
+    const size_t slotAlign = keyAlign > valAlign ? keyAlign : valAlign;
+
+    map->ctrl = NULL;
+    map->slots = NULL;
+    map->hashes = NULL;
+    map->keySize = keySize;
+    map->valSize = valSize;
+    map->valOffset = (keySize + valAlign - 1) / valAlign * valAlign;
+    map->slotSize = (map->valOffset + valSize + slotAlign - 1) / slotAlign * slotAlign;
+    map->cap = 0;
+    map->count = 0;
+    map->growth = 0;
+    map->hash = hash != NULL ? hash : kr_map_hash_bytes;
+    map->equal = equal != NULL ? equal : kr_map_equal_bytes_detail_;
+}
+
+KR_INLINE void kr_map_free(struct kr_map_s *map)
+{
+    KR_FREE(map->ctrl);
+    KR_FREE(map->slots);
+    KR_FREE(map->hashes);
+    kr_map_init(map, map->keySize, map->valSize, map->hash, map->equal);
+}
+
+KR_INLINE void kr_map_clear(struct kr_map_s *map)
+{
+    if (map->cap != 0)
+    {
+        memset(map->ctrl, KR_MAP_EMPTY_DETAIL_, map->cap + KR_MAP_GROUP_DETAIL_ - 1);
+    }
+    map->count = 0;
+    map->growth = map->cap != 0 ? kr_map_max_load_detail_(map->cap) : 0;
+}
+
+KR_NODISCARD KR_INLINE bool kr_map_reserve(struct kr_map_s *map, size_t n)
+{
+    size_t cap = map->cap != 0 ? map->cap : KR_MAP_GROUP_DETAIL_;
+
+    while (kr_map_max_load_detail_(cap) < n)
+    {
+        if (cap > SIZE_MAX / 2)
+        {
+            return false;
+        }
+        cap *= 2;
+    }
+    return cap == map->cap || kr_map_resize_detail_(map, cap);
+}
+
+KR_INLINE void *kr_map_find(const struct kr_map_s *map, const void *key)
+{
+    size_t slot = 0;
+
+    if (map->count == 0 || !kr_map_probe_detail_(map, key, map->hash(key, map->keySize), &slot))
+    {
+        return NULL;
+    }
+    return kr_map_value(map, slot);
+}
+
+KR_NODISCARD KR_INLINE void *kr_map_insert(struct kr_map_s *map, const void *key, bool *inserted)
+{
+    const size_t hash = map->hash(key, map->keySize);
+    size_t slot = 0;
+
+    if (inserted != NULL)
+    {
+        *inserted = false;
+    }
+
+    if (map->cap != 0 && kr_map_probe_detail_(map, key, hash, &slot))
+    {
+        return kr_map_value(map, slot);
+    }
+
+    if (map->growth == 0)
+    {
+        /* The table is as full as it gets, so this doubles it. */
+        if (!kr_map_reserve(map, map->count + 1))
+        {
+            return NULL;
+        }
+        kr_map_probe_detail_(map, key, hash, &slot);
+    }
+
+    kr_map_set_ctrl_detail_(map, slot, KR_CASTS(unsigned char, kr_map_h2_detail_(hash)));
+    memcpy(map->slots + slot * map->slotSize, key, map->keySize);
+    map->hashes[slot] = hash;
+    map->count++;
+    map->growth--;
+
+    if (inserted != NULL)
+    {
+        *inserted = true;
+    }
+    return kr_map_value(map, slot);
+}
+
+KR_INLINE bool kr_map_remove(struct kr_map_s *map, const void *key)
+{
+    const size_t mask = map->cap - 1;
+    size_t hole = 0, j = 0, home = 0;
+
+    if (map->count == 0 || !kr_map_probe_detail_(map, key, map->hash(key, map->keySize), &hole))
+    {
+        return false;
+    }
+
+    /* Shift back every later entry in the run whose home is not between
+     * the hole and the entry, so lookups never cross an empty slot. */
+    for (j = (hole + 1) & mask; !(map->ctrl[j] & KR_MAP_EMPTY_DETAIL_); j = (j + 1) & mask)
+    {
+        home = map->hashes[j] & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            kr_map_move_detail_(map, hole, j);
+            kr_map_set_ctrl_detail_(map, hole, map->ctrl[j]);
+            hole = j;
+        }
+    }
+
+    kr_map_set_ctrl_detail_(map, hole, KR_MAP_EMPTY_DETAIL_);
+    map->count--;
+    map->growth++;
+    return true;
+}
+
+KR_INLINE size_t kr_map_next(const struct kr_map_s *map, size_t slot)
+{
+    for (; slot < map->cap; slot++)
+    {
+        if (!(map->ctrl[slot] & KR_MAP_EMPTY_DETAIL_))
+        {
+            break;
+        }
+    }
+    return slot;
+}
+
+KR_INLINE void *kr_map_key(const struct kr_map_s *map, size_t slot)
+{
+    return map->slots + slot * map->slotSize;
+}
+
+KR_INLINE void *kr_map_value(const struct kr_map_s *map, size_t slot)
+{
+    return map->slots + slot * map->slotSize + (map->valSize != 0 ? map->valOffset : 0);
+}
+
+KR_INLINE size_t kr_map_hash_bytes(const void *key, size_t keySize)
+{
+#if defined(UINT64_MAX) && (KR_SIZEOF_SIZE_T >= 8)
+    return KR_CASTS(size_t, kr_hash64(key, keySize, 0));
+#else
+    return KR_CASTS(size_t, kr_hash32(key, keySize, 0));
+#endif
+}
+
+#undef KR_MAP_GROUP_DETAIL_
+#undef KR_MAP_EMPTY_DETAIL_
+#undef KR_MAP_PENDING_DETAIL_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRMAP_H) */
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#if !defined(KRPOOL_H)
+#define KRPOOL_H
+
+#include "./krconfig.h"
+
+#include "./krbool.h"
+#include "./krint.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <stdlib.h>
+#endif
+
+/**
+ * @brief Alignment of every cell handed out by a pool.
+ */
+#define KR_POOL_ALIGN (KR_MAX_ALIGN)
+
+/**
+ * @brief A free cell, which stores the free list inside itself.
+ */
+struct kr_pool_cell_s
+{
+    struct kr_pool_cell_s *next;
+};
+
+/**
+ * @brief A slab of cells owned by a pool.  Cells follow the header.
+ */
+struct kr_pool_slab_s
+{
+    struct kr_pool_slab_s *next;
+};
+
+/**
+ * @brief A pool of equally-sized cells.
+ *
+ * @details Cells are carved out of large slabs allocated with KR_MALLOC, and
+ *          freed cells go onto an intrusive free list, so allocating and
+ *          freeing are a handful of instructions and never fragment.  Slabs
+ *          are only given back when the pool is destroyed.
+ */
+struct kr_pool_s
+{
+    struct kr_pool_cell_s *free;
+    struct kr_pool_slab_s *first;
+    struct kr_pool_slab_s *slab;
+    unsigned char *carve;
+    unsigned char *carveEnd;
+    size_t cellSize;
+    size_t cellsPerSlab;
+};
+
+/**
+ * @brief A front cache for a pool, meant to be declared KR_THREAD.
+ *
+ * @details Allocating and freeing through a cache only touch the pool once
+ *          every KR_CONFIG_POOL_CACHEBATCH cells, inside
+ *          KR_CONFIG_POOL_LOCK and KR_CONFIG_POOL_UNLOCK, so threads sharing one pool rarely contend on it.
+ *          A zero-initialized cache is empty and ready to use.
+ */
+struct kr_pool_cache_s
+{
+    struct kr_pool_cell_s *free;
+    size_t count;
+};
+
+/**
+ * @brief Initialize an empty pool.  No memory is allocated until the first
+ *        allocation from the pool.
+ *
+ * @param pool Pool to initialize.
+ * @param cellSize Size of each cell.  Rounded up to hold a pointer and to
+ *        a multiple of KR_POOL_ALIGN.
+ * @param cellsPerSlab Number of cells in each slab.
+ * @return true if successful, or false if cellsPerSlab is 0.
+ */
+KR_NODISCARD KR_INLINE bool kr_pool_init(struct kr_pool_s *pool, size_t cellSize, size_t cellsPerSlab);
+
+/**
+ * @brief Free every slab owned by a pool and leave it empty.
+ *
+ * @param pool Pool to destroy.
+ */
+KR_INLINE void kr_pool_destroy(struct kr_pool_s *pool);
+
+/**
+ * @brief Allocate a cell from a pool.
+ *
+ * @param pool Pool to allocate from.
+ * @return Allocated cell, or NULL if allocation failed.
+ */
+KR_NODISCARD KR_INLINE void *kr_pool_alloc(struct kr_pool_s *pool);
+
+/**
+ * @brief Return a cell to a pool.
+ *
+ * @param pool Pool the cell was allocated from.
+ * @param ptr Cell to free.  Passing NULL is a no-op.
+ */
+KR_INLINE void kr_pool_free(struct kr_pool_s *pool, void *ptr);
+
+/**
+ * @brief Free every cell in a pool at once.  Slabs are kept for reuse.
+ *
+ * @param pool Pool to free all cells of.
+ */
+KR_INLINE void kr_pool_freeall(struct kr_pool_s *pool);
+
+/**
+ * @brief Allocate a cell through a front cache.
+ *
+ * @param cache Cache to allocate from.
+ * @param pool Pool that backs the cache.
+ * @return Allocated cell, or NULL if allocation failed.
+ */
+KR_NODISCARD KR_INLINE void *kr_pool_cache_alloc(struct kr_pool_cache_s *cache, struct kr_pool_s *pool);
+
+/**
+ * @brief Free a cell through a front cache.
+ *
+ * @param cache Cache to free to.
+ * @param pool Pool that backs the cache.
+ * @param ptr Cell to free.  Passing NULL is a no-op.
+ */
+KR_INLINE void kr_pool_cache_free(struct kr_pool_cache_s *cache, struct kr_pool_s *pool, void *ptr);
+
+/**
+ * @brief Return every cell in a front cache to its pool.
+ *
+ * @details Call this before a thread with a cache exits.
+ *
+ * @param cache Cache to flush.
+ * @param pool Pool that backs the cache.
+ */
+KR_INLINE void kr_pool_cache_flush(struct kr_pool_cache_s *cache, struct kr_pool_s *pool);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/**
+ * @brief Size of a slab header, padded so the first cell is aligned.
+ */
+#define KR_POOL_HEADER_DETAIL_                                                                                         \
+    ((sizeof(struct kr_pool_slab_s) + KR_POOL_ALIGN - 1) / KR_POOL_ALIGN * KR_POOL_ALIGN)
+
+KR_NODISCARD KR_INLINE bool kr_pool_init(struct kr_pool_s *pool, size_t cellSize, size_t cellsPerSlab)
+{
+    if (cellsPerSlab == 0)
+    {
+        return false;
+    }
+    if (cellSize < sizeof(struct kr_pool_cell_s))
+    {
+        cellSize = sizeof(struct kr_pool_cell_s);
+    }
+
+    pool->free = NULL;
+    pool->first = NULL;
+    pool->slab = NULL;
+    pool->carve = NULL;
+    pool->carveEnd = NULL;
+    pool->cellSize = (cellSize + KR_POOL_ALIGN - 1) / KR_POOL_ALIGN * KR_POOL_ALIGN;
+    pool->cellsPerSlab = cellsPerSlab;
+    return true;
+}
+
+KR_INLINE void kr_pool_destroy(struct kr_pool_s *pool)
+{
+    struct kr_pool_slab_s *slab = pool->first, *next = NULL;
+
+    for (; slab != NULL; slab = next)
+    {
+        next = slab->next;
+        KR_FREE(slab);
+    }
+    pool->free = NULL;
+    pool->first = NULL;
+    kr_pool_freeall(pool);
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE void *kr_pool_alloc(struct kr_pool_s *pool)
+{
+    struct kr_pool_cell_s *cell = pool->free;
+    struct kr_pool_slab_s *slab = NULL;
+
+    if (cell != NULL)
+    {
+        pool->free = cell->next;
+        return cell;
+    }
+
+    if (pool->carve == pool->carveEnd)
+    {
+        /* Carve the next slab, reusing one left over from kr_pool_freeall. */
+        slab = pool->slab != NULL ? pool->slab->next : pool->first;
+        if (slab == NULL)
+        {
+            if (pool->cellsPerSlab > (SIZE_MAX - KR_POOL_HEADER_DETAIL_) / pool->cellSize)
+            {
+                return NULL;
+            }
+
+            slab = KR_CASTS(struct kr_pool_slab_s *,
+                            KR_MALLOC(KR_POOL_HEADER_DETAIL_ + pool->cellSize * pool->cellsPerSlab));
+            if (slab == NULL)
+            {
+                return NULL;
+            }
+
+            slab->next = NULL;
+            if (pool->slab != NULL)
+            {
+                pool->slab->next = slab;
+            }
+            else
+            {
+                pool->first = slab;
+            }
+        }
+
+        pool->slab = slab;
+        pool->carve = KR_CASTR(unsigned char *, slab) + KR_POOL_HEADER_DETAIL_;
+        pool->carveEnd = pool->carve + pool->cellSize * pool->cellsPerSlab;
+    }
+
+    /* Cells are carved one at a time so a new slab is not touched all at
+     * once. */
+    pool->carve += pool->cellSize;
+    return pool->carve - pool->cellSize;
+}
+
+KR_INLINE void kr_pool_free(struct kr_pool_s *pool, void *ptr)
+{
+    struct kr_pool_cell_s *cell = KR_CASTS(struct kr_pool_cell_s *, ptr);
+
+    if (cell == NULL)
+    {
+        return;
+    }
+
+    cell->next = pool->free;
+    pool->free = cell;
+}
+
+KR_INLINE void kr_pool_freeall(struct kr_pool_s *pool)
+{
+    pool->free = NULL;
+    pool->slab = NULL;
+    pool->carve = NULL;
+    pool->carveEnd = NULL;
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE void *kr_pool_cache_alloc(struct kr_pool_cache_s *cache, struct kr_pool_s *pool)
+{
+    struct kr_pool_cell_s *cell = NULL;
+
+    if (cache->free == NULL)
+    {
+        /* Refill a batch at a time to keep trips to the pool rare. */
+        KR_CONFIG_POOL_LOCK(pool);
+        for (; cache->count < KR_CONFIG_POOL_CACHEBATCH; cache->count++)
+        {
+            cell = KR_CASTS(struct kr_pool_cell_s *, kr_pool_alloc(pool));
+            if (cell == NULL)
+            {
+                break;
+            }
+            cell->next = cache->free;
+            cache->free = cell;
+        }
+        KR_CONFIG_POOL_UNLOCK(pool);
+
+        if (cache->free == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    cell = cache->free;
+    cache->free = cell->next;
+    cache->count--;
+    return cell;
+}
+
+KR_INLINE void kr_pool_cache_free(struct kr_pool_cache_s *cache, struct kr_pool_s *pool, void *ptr)
+{
+    struct kr_pool_cell_s *cell = KR_CASTS(struct kr_pool_cell_s *, ptr);
+
+    if (cell == NULL)
+    {
+        return;
+    }
+
+    cell->next = cache->free;
+    cache->free = cell;
+    cache->count++;
+
+    if (cache->count >= KR_CONFIG_POOL_CACHEBATCH * 2)
+    {
+        /* Give back half so a thread that only frees does not hoard. */
+        KR_CONFIG_POOL_LOCK(pool);
+        for (; cache->count > KR_CONFIG_POOL_CACHEBATCH; cache->count--)
+        {
+            cell = cache->free;
+            cache->free = cell->next;
+            kr_pool_free(pool, cell);
+        }
+        KR_CONFIG_POOL_UNLOCK(pool);
+    }
+}
+
+KR_INLINE void kr_pool_cache_flush(struct kr_pool_cache_s *cache, struct kr_pool_s *pool)
+{
+    struct kr_pool_cell_s *cell = NULL;
+
+    KR_CONFIG_POOL_LOCK(pool);
+    while (cache->free != NULL)
+    {
+        cell = cache->free;
+        cache->free = cell->next;
+        kr_pool_free(pool, cell);
+    }
+    KR_CONFIG_POOL_UNLOCK(pool);
+    cache->count = 0;
+}
+
+#undef KR_POOL_HEADER_DETAIL_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRPOOL_H) */
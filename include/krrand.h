@@ -50,10 +50,11 @@ KR_CONSTEXPR uint8_t kr_jsf8_rand(struct kr_jsf8_ctx_s *x);
  * @brief Return a uniformly distributed random number in the half-open range
  *        of [0, upper_bound).
  *
- * @note Discards invalid numbers until we find one we like.  Uses the OpenBSD
- *       "fill from the top" method because it uses one less temporary.
+ * @note Uses Lemire's multiply-shift method, which only needs a division in
+ *       the rare case that a number has to be discarded.  Results are the
+ *       same on every platform.
  *
- * @link https://jacquesheunis.com/post/bounded-random/
+ * @link https://arxiv.org/abs/1805.10941
  */
 KR_CONSTEXPR uint8_t kr_jsf8_rand_uniform(struct kr_jsf8_ctx_s *x, uint8_t upper_bound);
 
@@ -80,10 +81,11 @@ KR_CONSTEXPR uint16_t kr_jsf16_rand(struct kr_jsf16_ctx_s *x);
  * @brief Return a uniformly distributed random number in the half-open range
  *        of [0, upper_bound).
  *
- * @note Discards invalid numbers until we find one we like.  Uses the OpenBSD
- *       "fill from the top" method because it uses one less temporary.
+ * @note Uses Lemire's multiply-shift method, which only needs a division in
+ *       the rare case that a number has to be discarded.  Results are the
+ *       same on every platform.
  *
- * @link https://jacquesheunis.com/post/bounded-random/
+ * @link https://arxiv.org/abs/1805.10941
  */
 KR_CONSTEXPR uint16_t kr_jsf16_rand_uniform(struct kr_jsf16_ctx_s *x, uint16_t upper_bound);
 
@@ -110,13 +112,72 @@ KR_CONSTEXPR uint32_t kr_jsf32_rand(struct kr_jsf32_ctx_s *x);
  * @brief Return a uniformly distributed random number in the half-open range
  *        of [0, upper_bound).
  *
- * @note Discards invalid numbers until we find one we like.  Uses the OpenBSD
- *       "fill from the top" method because it uses one less temporary.
+ * @note Uses Lemire's multiply-shift method, which only needs a division in
+ *       the rare case that a number has to be discarded.  Results are the
+ *       same on every platform.
  *
- * @link https://jacquesheunis.com/post/bounded-random/
+ * @link https://arxiv.org/abs/1805.10941
  */
 KR_CONSTEXPR uint32_t kr_jsf32_rand_uniform(struct kr_jsf32_ctx_s *x, uint32_t upper_bound);
 
+/**
+ * @brief Fill a buffer with random numbers.
+ *
+ * @details Produces the same numbers as calling kr_jsf32_rand n times, but
+ *          keeps the state in registers for the whole loop.
+ */
+KR_CONSTEXPR void kr_jsf32_fill(struct kr_jsf32_ctx_s *x, uint32_t *buf, size_t n);
+
+/**
+ * @brief Seed a child PRNG from a parent PRNG and a stream number.
+ *
+ * @details The child depends only on the current state of the parent and the
+ *          stream number, and the parent is not advanced, so workers can
+ *          derive their own streams in any order and get the same results.
+ *          The seed is a hash of both, and children with different stream
+ *          numbers start at unrelated points in the sequence, so in practice
+ *          they do not overlap.
+ *
+ * @param parent PRNG to split from.
+ * @param child PRNG to seed.
+ * @param stream Stream number, such as a worker or task index.
+ */
+KR_CONSTEXPR void kr_jsf32_split(const struct kr_jsf32_ctx_s *parent, struct kr_jsf32_ctx_s *child,
+                                  uint32_t stream);
+
+/******************************************************************************/
+
+/**
+ * @brief Eight independent 32-bit PRNGs, stored lane by lane so one step of
+ *        every lane can be vectorized.
+ */
+struct kr_jsf32x8_ctx_s
+{
+    uint32_t a[8], b[8], c[8], d[8];
+};
+
+/**
+ * @brief Seed each lane with kr_jsf32_srand.
+ *
+ * @param seeds Eight seeds, one for each lane.
+ */
+KR_CONSTEXPR void kr_jsf32x8_srand(struct kr_jsf32x8_ctx_s *x, const uint32_t *seeds);
+
+/**
+ * @brief Return one random number from every lane.
+ *
+ * @param out Eight outputs, one for each lane.
+ */
+KR_CONSTEXPR void kr_jsf32x8_rand(struct kr_jsf32x8_ctx_s *x, uint32_t *out);
+
+/**
+ * @brief Fill a buffer with random numbers, interleaving the lanes.
+ *
+ * @details If n is not a multiple of 8, the extra numbers from the last step
+ *          are thrown away.
+ */
+KR_CONSTEXPR void kr_jsf32x8_fill(struct kr_jsf32x8_ctx_s *x, uint32_t *buf, size_t n);
+
 /******************************************************************************/
 
 #if defined(UINT64_MAX)
@@ -142,19 +203,167 @@ KR_CONSTEXPR uint64_t kr_jsf64_rand(struct kr_jsf64_ctx_s *x);
  * @brief Return a uniformly distributed random number in the half-open range
  *        of [0, upper_bound).
  *
- * @note Discards invalid numbers until we find one we like.  Uses the OpenBSD
- *       "fill from the top" method because it uses one less temporary.
+ * @note Uses Lemire's multiply-shift method, which only needs a division in
+ *       the rare case that a number has to be discarded.  Results are the
+ *       same on every platform.
  *
- * @link https://jacquesheunis.com/post/bounded-random/
+ * @link https://arxiv.org/abs/1805.10941
  */
 KR_CONSTEXPR uint64_t kr_jsf64_rand_uniform(struct kr_jsf64_ctx_s *x, uint64_t upper_bound);
 
+/**
+ * @brief Fill a buffer with random numbers.
+ *
+ * @details Produces the same numbers as calling kr_jsf64_rand n times, but
+ *          keeps the state in registers for the whole loop.
+ */
+KR_CONSTEXPR void kr_jsf64_fill(struct kr_jsf64_ctx_s *x, uint64_t *buf, size_t n);
+
+/**
+ * @brief Seed a child PRNG from a parent PRNG and a stream number.
+ *
+ * @details The child depends only on the current state of the parent and the
+ *          stream number, and the parent is not advanced, so workers can
+ *          derive their own streams in any order and get the same results.
+ *          The seed is a hash of both, and children with different stream
+ *          numbers start at unrelated points in the sequence, so in practice
+ *          they do not overlap.
+ *
+ * @param parent PRNG to split from.
+ * @param child PRNG to seed.
+ * @param stream Stream number, such as a worker or task index.
+ */
+KR_CONSTEXPR void kr_jsf64_split(const struct kr_jsf64_ctx_s *parent, struct kr_jsf64_ctx_s *child,
+                                  uint64_t stream);
+
+/******************************************************************************/
+
+/**
+ * @brief Four independent 64-bit PRNGs, stored lane by lane so one step of
+ *        every lane can be vectorized.
+ */
+struct kr_jsf64x4_ctx_s
+{
+    uint64_t a[4], b[4], c[4], d[4];
+};
+
+/**
+ * @brief Seed each lane with kr_jsf64_srand.
+ *
+ * @param seeds Four seeds, one for each lane.
+ */
+KR_CONSTEXPR void kr_jsf64x4_srand(struct kr_jsf64x4_ctx_s *x, const uint64_t *seeds);
+
+/**
+ * @brief Return one random number from every lane.
+ *
+ * @param out Four outputs, one for each lane.
+ */
+KR_CONSTEXPR void kr_jsf64x4_rand(struct kr_jsf64x4_ctx_s *x, uint64_t *out);
+
+/**
+ * @brief Fill a buffer with random numbers, interleaving the lanes.
+ *
+ * @details If n is not a multiple of 4, the extra numbers from the last step
+ *          are thrown away.
+ */
+KR_CONSTEXPR void kr_jsf64x4_fill(struct kr_jsf64x4_ctx_s *x, uint64_t *buf, size_t n);
+
 #endif /* defined(UINT64_MAX) */
 
 /******************************************************************************/
 #if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
 /******************************************************************************/
 
+/**
+ * @brief Scramble a 32-bit number, using the MurmurHash3 finalizer.
+ */
+KR_CONSTEXPR uint32_t kr_rand_mix32_detail_(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= UINT32_C(0x85EBCA6B);
+    x ^= x >> 13;
+    x *= UINT32_C(0xC2B2AE35);
+    x ^= x >> 16;
+    return x;
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ * @brief Scramble a 64-bit number, using the SplitMix64 finalizer.
+ */
+KR_CONSTEXPR uint64_t kr_rand_mix64_detail_(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= UINT64_C(0xBF58476D1CE4E5B9);
+    x ^= x >> 27;
+    x *= UINT64_C(0x94D049BB133111EB);
+    x ^= x >> 31;
+    return x;
+}
+
+#endif /* defined(UINT64_MAX) */
+
+/******************************************************************************/
+
+/**
+ * @brief Multiply two 32-bit numbers into a 64-bit product.
+ *
+ * @return High half of the product.  The low half is written to lo.
+ */
+KR_CONSTEXPR uint32_t kr_rand_mul32_detail_(uint32_t a, uint32_t b, uint32_t *lo)
+{
+#if defined(UINT64_MAX)
+    const uint64_t m = KR_CASTS(uint64_t, a) * b;
+    *lo = KR_CASTS(uint32_t, m);
+    return KR_CASTS(uint32_t, m >> 32);
+#else
+    const uint32_t al = a & 0xFFFF, ah = a >> 16, bl = b & 0xFFFF, bh = b >> 16;
+    const uint32_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+    const uint32_t mid = (ll >> 16) + (lh & 0xFFFF) + (hl & 0xFFFF);
+    *lo = (mid << 16) | (ll & 0xFFFF);
+    return hh + (lh >> 16) + (hl >> 16) + (mid >> 16);
+#endif /* defined(UINT64_MAX) */
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ * @brief Multiply two 64-bit numbers into a 128-bit product using only
+ *        64-bit arithmetic.
+ *
+ * @return High half of the product.  The low half is written to lo.
+ */
+KR_CONSTEXPR uint64_t kr_rand_mul64_split_detail_(uint64_t a, uint64_t b, uint64_t *lo)
+{
+    const uint64_t al = a & 0xFFFFFFFF, ah = a >> 32, bl = b & 0xFFFFFFFF, bh = b >> 32;
+    const uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+    const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+    *lo = (mid << 32) | (ll & 0xFFFFFFFF);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+/**
+ * @brief Multiply two 64-bit numbers into a 128-bit product.
+ *
+ * @return High half of the product.  The low half is written to lo.
+ */
+KR_CONSTEXPR uint64_t kr_rand_mul64_detail_(uint64_t a, uint64_t b, uint64_t *lo)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ const unsigned __int128 m = KR_CASTS(unsigned __int128, a) * b;
+    *lo = KR_CASTS(uint64_t, m);
+    return KR_CASTS(uint64_t, m >> 64);
+#else
+    return kr_rand_mul64_split_detail_(a, b, lo);
+#endif /* defined(__SIZEOF_INT128__) */
+}
+
+#endif /* defined(UINT64_MAX) */
+
+/******************************************************************************/
+
 KR_CONSTEXPR void kr_jsf8_srand(struct kr_jsf8_ctx_s *x, uint8_t seed)
 {
     int i = 0;
@@ -178,28 +387,28 @@ KR_CONSTEXPR uint8_t kr_jsf8_rand(struct kr_jsf8_ctx_s *x)
 
 KR_CONSTEXPR uint8_t kr_jsf8_rand_uniform(struct kr_jsf8_ctx_s *x, uint8_t upper_bound)
 {
-    uint8_t i = 0, min = 0;
+    uint32_t m = 0;
+    uint8_t t = 0;
 
     if (upper_bound <= 1)
     {
-        /* Trivial case. */
+        /* Trivial case, which does not use up a number. */
         return 0;
     }
 
-    /* Expand the range where we can "hit" a good random number. */
-    min = (0u - upper_bound) % upper_bound;
-
-    for (;;)
+    m = KR_CASTS(uint32_t, kr_jsf8_rand(x)) * upper_bound;
+    if (KR_CASTS(uint8_t, m) < upper_bound)
     {
-        i = kr_jsf8_rand(x);
-        if (i >= min)
+        /* Only the bottom of the range can be biased, so only pay for the
+         * division when we land there. */
+        t = KR_CASTS(uint8_t, KR_CASTS(uint8_t, 0u - upper_bound) % upper_bound);
+        while (KR_CASTS(uint8_t, m) < t)
         {
-            break;
+            m = KR_CASTS(uint32_t, kr_jsf8_rand(x)) * upper_bound;
         }
     }
 
-    /* Map our random number back to the original bounds. */
-    return i % upper_bound;
+    return KR_CASTS(uint8_t, m >> 8);
 }
 
 /******************************************************************************/
@@ -227,28 +436,28 @@ KR_CONSTEXPR uint16_t kr_jsf16_rand(struct kr_jsf16_ctx_s *x)
 
 KR_CONSTEXPR uint16_t kr_jsf16_rand_uniform(struct kr_jsf16_ctx_s *x, uint16_t upper_bound)
 {
-    uint16_t i = 0, min = 0;
+    uint32_t m = 0;
+    uint16_t t = 0;
 
     if (upper_bound <= 1)
     {
-        /* Trivial case. */
+        /* Trivial case, which does not use up a number. */
         return 0;
     }
 
-    /* Expand the range where we can "hit" a good random number. */
-    min = (0u - upper_bound) % upper_bound;
-
-    for (;;)
+    m = KR_CASTS(uint32_t, kr_jsf16_rand(x)) * upper_bound;
+    if (KR_CASTS(uint16_t, m) < upper_bound)
     {
-        i = kr_jsf16_rand(x);
-        if (i >= min)
+        /* Only the bottom of the range can be biased, so only pay for the
+         * division when we land there. */
+        t = KR_CASTS(uint16_t, KR_CASTS(uint16_t, 0u - upper_bound) % upper_bound);
+        while (KR_CASTS(uint16_t, m) < t)
         {
-            break;
+            m = KR_CASTS(uint32_t, kr_jsf16_rand(x)) * upper_bound;
         }
     }
 
-    /* Map our random number back to the original bounds. */
-    return i % upper_bound;
+    return KR_CASTS(uint16_t, m >> 16);
 }
 
 /******************************************************************************/
@@ -276,28 +485,110 @@ KR_CONSTEXPR uint32_t kr_jsf32_rand(struct kr_jsf32_ctx_s *x)
 
 KR_CONSTEXPR uint32_t kr_jsf32_rand_uniform(struct kr_jsf32_ctx_s *x, uint32_t upper_bound)
 {
-    uint32_t i = 0, min = 0;
+    uint32_t lo = 0, hi = 0, t = 0;
 
     if (upper_bound <= 1)
     {
-        /* Trivial case. */
+        /* Trivial case, which does not use up a number. */
         return 0;
     }
 
-    /* Expand the range where we can "hit" a good random number. */
-    min = (0u - upper_bound) % upper_bound;
-
-    for (;;)
+    hi = kr_rand_mul32_detail_(kr_jsf32_rand(x), upper_bound, &lo);
+    if (lo < upper_bound)
     {
-        i = kr_jsf32_rand(x);
-        if (i >= min)
+        /* Only the bottom of the range can be biased, so only pay for the
+         * division when we land there. */
+        t = (0u - upper_bound) % upper_bound;
+        while (lo < t)
         {
-            break;
+            hi = kr_rand_mul32_detail_(kr_jsf32_rand(x), upper_bound, &lo);
         }
     }
 
-    /* Map our random number back to the original bounds. */
-    return i % upper_bound;
+    return hi;
+}
+
+KR_CONSTEXPR void kr_jsf32_fill(struct kr_jsf32_ctx_s *x, uint32_t *buf, size_t n)
+{
+    uint32_t a = x->a, b = x->b, c = x->c, d = x->d, e = 0;
+    size_t i = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        e = a - kr_rotate_left32(b, 27);
+        a = b ^ kr_rotate_left32(c, 17);
+        b = c + d;
+        c = d + e;
+        d = e + a;
+        buf[i] = d;
+    }
+
+    x->a = a, x->b = b, x->c = c, x->d = d;
+}
+
+KR_CONSTEXPR void kr_jsf32_split(const struct kr_jsf32_ctx_s *parent, struct kr_jsf32_ctx_s *child,
+                                  uint32_t stream)
+{
+    uint32_t seed = kr_rand_mix32_detail_(stream);
+
+    /* Chain the hash through every word so that no two parent states or
+     * stream numbers are likely to share a seed. */
+    seed = kr_rand_mix32_detail_(seed ^ parent->a);
+    seed = kr_rand_mix32_detail_(seed ^ parent->b);
+    seed = kr_rand_mix32_detail_(seed ^ parent->c);
+    seed = kr_rand_mix32_detail_(seed ^ parent->d);
+    kr_jsf32_srand(child, seed);
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR void kr_jsf32x8_srand(struct kr_jsf32x8_ctx_s *x, const uint32_t *seeds)
+{
+    struct kr_jsf32_ctx_s lane = {0, 0, 0, 0};
+    int i = 0;
+
+    for (i = 0; i < 8; i++)
+    {
+        kr_jsf32_srand(&lane, seeds[i]);
+        x->a[i] = lane.a, x->b[i] = lane.b, x->c[i] = lane.c, x->d[i] = lane.d;
+    }
+}
+
+KR_CONSTEXPR void kr_jsf32x8_rand(struct kr_jsf32x8_ctx_s *x, uint32_t *out)
+{
+    uint32_t e = 0;
+    int i = 0;
+
+    /* Every lane does the same operations, so this loop vectorizes. */
+    for (i = 0; i < 8; i++)
+    {
+        e = x->a[i] - kr_rotate_left32(x->b[i], 27);
+        x->a[i] = x->b[i] ^ kr_rotate_left32(x->c[i], 17);
+        x->b[i] = x->c[i] + x->d[i];
+        x->c[i] = x->d[i] + e;
+        x->d[i] = e + x->a[i];
+        out[i] = x->d[i];
+    }
+}
+
+KR_CONSTEXPR void kr_jsf32x8_fill(struct kr_jsf32x8_ctx_s *x, uint32_t *buf, size_t n)
+{
+    uint32_t tail[8] = {0};
+    size_t i = 0, j = 0;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        kr_jsf32x8_rand(x, buf + i);
+    }
+
+    if (i < n)
+    {
+        kr_jsf32x8_rand(x, tail);
+        for (j = 0; j < n % 8; j++)
+        {
+            buf[i + j] = tail[j];
+        }
+    }
 }
 
 /******************************************************************************/
@@ -327,28 +618,110 @@ KR_CONSTEXPR uint64_t kr_jsf64_rand(struct kr_jsf64_ctx_s *x)
 
 KR_CONSTEXPR uint64_t kr_jsf64_rand_uniform(struct kr_jsf64_ctx_s *x, uint64_t upper_bound)
 {
-    uint64_t i = 0, min = 0;
+    uint64_t lo = 0, hi = 0, t = 0;
 
     if (upper_bound <= 1)
     {
-        /* Trivial case. */
+        /* Trivial case, which does not use up a number. */
         return 0;
     }
 
-    /* Expand the range where we can "hit" a good random number. */
-    min = (0u - upper_bound) % upper_bound;
-
-    for (;;)
+    hi = kr_rand_mul64_detail_(kr_jsf64_rand(x), upper_bound, &lo);
+    if (lo < upper_bound)
     {
-        i = kr_jsf64_rand(x);
-        if (i >= min)
+        /* Only the bottom of the range can be biased, so only pay for the
+         * division when we land there. */
+        t = (0u - upper_bound) % upper_bound;
+        while (lo < t)
         {
-            break;
+            hi = kr_rand_mul64_detail_(kr_jsf64_rand(x), upper_bound, &lo);
         }
     }
 
-    /* Map our random number back to the original bounds. */
-    return i % upper_bound;
+    return hi;
+}
+
+KR_CONSTEXPR void kr_jsf64_fill(struct kr_jsf64_ctx_s *x, uint64_t *buf, size_t n)
+{
+    uint64_t a = x->a, b = x->b, c = x->c, d = x->d, e = 0;
+    size_t i = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        e = a - kr_rotate_left64(b, 7);
+        a = b ^ kr_rotate_left64(c, 13);
+        b = c + kr_rotate_left64(d, 37);
+        c = d + e;
+        d = e + a;
+        buf[i] = d;
+    }
+
+    x->a = a, x->b = b, x->c = c, x->d = d;
+}
+
+KR_CONSTEXPR void kr_jsf64_split(const struct kr_jsf64_ctx_s *parent, struct kr_jsf64_ctx_s *child,
+                                  uint64_t stream)
+{
+    uint64_t seed = kr_rand_mix64_detail_(stream);
+
+    /* Chain the hash through every word so that no two parent states or
+     * stream numbers are likely to share a seed. */
+    seed = kr_rand_mix64_detail_(seed ^ parent->a);
+    seed = kr_rand_mix64_detail_(seed ^ parent->b);
+    seed = kr_rand_mix64_detail_(seed ^ parent->c);
+    seed = kr_rand_mix64_detail_(seed ^ parent->d);
+    kr_jsf64_srand(child, seed);
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR void kr_jsf64x4_srand(struct kr_jsf64x4_ctx_s *x, const uint64_t *seeds)
+{
+    struct kr_jsf64_ctx_s lane = {0, 0, 0, 0};
+    int i = 0;
+
+    for (i = 0; i < 4; i++)
+    {
+        kr_jsf64_srand(&lane, seeds[i]);
+        x->a[i] = lane.a, x->b[i] = lane.b, x->c[i] = lane.c, x->d[i] = lane.d;
+    }
+}
+
+KR_CONSTEXPR void kr_jsf64x4_rand(struct kr_jsf64x4_ctx_s *x, uint64_t *out)
+{
+    uint64_t e = 0;
+    int i = 0;
+
+    /* Every lane does the same operations, so this loop vectorizes. */
+    for (i = 0; i < 4; i++)
+    {
+        e = x->a[i] - kr_rotate_left64(x->b[i], 7);
+        x->a[i] = x->b[i] ^ kr_rotate_left64(x->c[i], 13);
+        x->b[i] = x->c[i] + kr_rotate_left64(x->d[i], 37);
+        x->c[i] = x->d[i] + e;
+        x->d[i] = e + x->a[i];
+        out[i] = x->d[i];
+    }
+}
+
+KR_CONSTEXPR void kr_jsf64x4_fill(struct kr_jsf64x4_ctx_s *x, uint64_t *buf, size_t n)
+{
+    uint64_t tail[4] = {0};
+    size_t i = 0, j = 0;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        kr_jsf64x4_rand(x, buf + i);
+    }
+
+    if (i < n)
+    {
+        kr_jsf64x4_rand(x, tail);
+        for (j = 0; j < n % 4; j++)
+        {
+            buf[i + j] = tail[j];
+        }
+    }
 }
 
 #endif /* defined(UINT64_MAX) */
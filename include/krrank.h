@@ -0,0 +1,445 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * Population count, rank and select over bit vectors, the building blocks of
+ * succinct data structures.
+ *
+ * A bit vector is an array of 64-bit words, and bit i is bit (i % 64) of
+ * word (i / 64), counting from the LSB.
+ *
+ * The rank index is Vigna's rank9, which stores two words of counts for
+ * every eight words of bits, and select is answered from a sample of every
+ * 512th set bit:
+ *  <https://vigna.di.unimi.it/ftp/papers/Broadword.pdf>
+ */
+
+#if !defined(KRRANK_H)
+#define KRRANK_H
+
+#include "./krconfig.h"
+
+#include "./krbit.h"
+#include "./krbltin.h"
+#include "./krbool.h"
+#include "./krcpu.h"
+#include "./krint.h"
+#include "./krlib.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <stdlib.h>
+#if (KR_AVX2) || (KR_CPU_DISPATCH)
+#include <immintrin.h>
+#elif (KR_NEON)
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(UINT64_MAX)
+
+/**
+ * @brief An index for answering rank and select over a bit vector.
+ *
+ * @details The index does not own or copy the bit vector, which must not
+ *          change while the index is in use.
+ */
+struct kr_rank_s
+{
+    const uint64_t *words;
+    size_t nbits;
+    uint64_t ones;
+    uint64_t *counts;
+    size_t *samples;
+};
+
+/**
+ * @brief Count the set bits in an array of words.
+ *
+ * @details Uses vector instructions where available, and otherwise a
+ *          Harley-Seal carry-save adder that only needs a population count
+ *          for every 16 words.  With KR_CPU_DISPATCH, the AVX2 and POPCNT
+ *          paths are picked at runtime if the CPU supports them.
+ *
+ * @param words Words to count.
+ * @param n Number of words.
+ * @return Number of set bits.
+ */
+KR_INLINE uint64_t kr_popcount_array(const uint64_t *words, size_t n);
+
+/**
+ * @brief Build a rank and select index over a bit vector.
+ *
+ * @param rs Index to initialize.
+ * @param words Bit vector to index.  Bits past nbits in the last word are
+ *        ignored.
+ * @param nbits Number of bits in the bit vector.
+ * @return true if successful, or false if allocation failed.  The index is
+ *         empty on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_rank_init(struct kr_rank_s *rs, const uint64_t *words, size_t nbits);
+
+/**
+ * @brief Free the memory owned by an index and leave it empty.
+ *
+ * @param rs Index to free.
+ */
+KR_INLINE void kr_rank_free(struct kr_rank_s *rs);
+
+/**
+ * @brief Count the set bits before a position in constant time.
+ *
+ * @param rs Index to query.
+ * @param pos Position to count up to, not including the bit at pos itself.
+ *        Must not be greater than the number of bits.
+ * @return Number of set bits in [0, pos).
+ */
+KR_INLINE uint64_t kr_rank1(const struct kr_rank_s *rs, size_t pos);
+
+/**
+ * @brief Count the clear bits before a position in constant time.
+ *
+ * @param rs Index to query.
+ * @param pos Position to count up to, not including the bit at pos itself.
+ *        Must not be greater than the number of bits.
+ * @return Number of clear bits in [0, pos).
+ */
+KR_INLINE uint64_t kr_rank0(const struct kr_rank_s *rs, size_t pos);
+
+/**
+ * @brief Find the position of the k-th set bit, counting from 0.
+ *
+ * @details Runs in constant time unless set bits are very sparse, in which
+ *          case it takes time logarithmic in the gap between samples.
+ *
+ * @param rs Index to query.
+ * @param k Rank of the set bit to find.
+ * @return Position of the bit, or the number of bits if there are not
+ *         k+1 set bits.
+ */
+KR_INLINE size_t kr_select1(const struct kr_rank_s *rs, uint64_t k);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/**
+ * @brief Get the number of set bits before word j of a block, from the
+ *        second count word of the block.
+ */
+#define KR_RANK_REL_DETAIL_(c, j) ((j) == 0 ? 0 : ((c) >> (9 * ((j) - 1))) & 0x1FF)
+
+/**
+ * @brief Carry-save adder, adds three words bit by bit.
+ */
+KR_INLINE void kr_rank_csa_detail_(uint64_t *h, uint64_t *l, uint64_t a, uint64_t b, uint64_t c)
+{
+    const uint64_t u = a ^ b;
+    *h = (a & b) | (u & c);
+    *l = u ^ c;
+}
+
+#if (KR_AVX2) || (KR_CPU_DISPATCH)
+
+/**
+ * @brief Count the set bits in an array of words with AVX2.
+ *
+ * @details Counts nibbles with a table lookup, summing bytes for up to 8
+ *          vectors before they could overflow.
+ */
+KR_CPU_TARGET("avx2,popcnt") KR_INLINE uint64_t kr_rank_popcount_avx2_detail_(const uint64_t *words, size_t n)
+{
+    const __m256i lookup =
+        _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256(), bytes, v;
+    uint64_t lanes[4];
+    uint64_t total = 0;
+    size_t i = 0, j = 0;
+
+    while (i + 4 <= n)
+    {
+        bytes = _mm256_setzero_si256();
+        for (j = 0; j < 8 && i + 4 <= n; j++, i += 4)
+        {
+            v = _mm256_loadu_si256(KR_CASTR(const __m256i *, words + i));
+            bytes = _mm256_add_epi8(bytes, _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low)));
+            bytes = _mm256_add_epi8(bytes,
+                                    _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+        }
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    _mm256_storeu_si256(KR_CASTR(__m256i *, lanes), acc);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    for (; i < n; i++)
+    {
+        total += KR_CASTS(uint64_t, kr_popcnt64(words[i]));
+    }
+    return total;
+}
+
+#endif /* (KR_AVX2) || (KR_CPU_DISPATCH) */
+
+#if !(KR_AVX2) && (KR_CPU_DISPATCH)
+
+/**
+ * @brief Count the set bits in an array of words with the POPCNT
+ *        instruction, four independent sums at a time.
+ */
+KR_CPU_TARGET("popcnt") KR_INLINE uint64_t kr_rank_popcount_popcnt_detail_(const uint64_t *words, size_t n)
+{
+    uint64_t a = 0, b = 0, c = 0, d = 0;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        a += KR_CASTS(uint64_t, kr_popcnt64(words[i + 0]));
+        b += KR_CASTS(uint64_t, kr_popcnt64(words[i + 1]));
+        c += KR_CASTS(uint64_t, kr_popcnt64(words[i + 2]));
+        d += KR_CASTS(uint64_t, kr_popcnt64(words[i + 3]));
+    }
+    for (; i < n; i++)
+    {
+        a += KR_CASTS(uint64_t, kr_popcnt64(words[i]));
+    }
+    return a + b + c + d;
+}
+
+#endif /* !(KR_AVX2) && (KR_CPU_DISPATCH) */
+
+#if (KR_NEON)
+
+/**
+ * @brief Count the set bits in an array of words with NEON.
+ */
+KR_INLINE uint64_t kr_rank_popcount_neon_detail_(const uint64_t *words, size_t n)
+{
+    uint64x2_t acc = vdupq_n_u64(0);
+    uint64_t total = 0;
+    size_t i = 0;
+
+    for (; i + 2 <= n; i += 2)
+    {
+        const uint8x16_t c = vcntq_u8(vld1q_u8(KR_CASTR(const uint8_t *, words + i)));
+        acc = vpadalq_u32(acc, vpaddlq_u16(vpaddlq_u8(c)));
+    }
+    total = vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+
+    for (; i < n; i++)
+    {
+        total += KR_CASTS(uint64_t, kr_popcnt64(words[i]));
+    }
+    return total;
+}
+
+#endif /* (KR_NEON) */
+
+/**
+ * @brief Count the set bits in an array of words with a Harley-Seal
+ *        carry-save adder.
+ */
+KR_INLINE uint64_t kr_rank_popcount_csa_detail_(const uint64_t *words, size_t n)
+{
+    uint64_t ones = 0, twos = 0, fours = 0, eights = 0, sixteens = 0;
+    uint64_t twosA = 0, twosB = 0, foursA = 0, foursB = 0, eightsA = 0, eightsB = 0;
+    uint64_t total = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        kr_rank_csa_detail_(&twosA, &ones, ones, words[i + 0], words[i + 1]);
+        kr_rank_csa_detail_(&twosB, &ones, ones, words[i + 2], words[i + 3]);
+        kr_rank_csa_detail_(&foursA, &twos, twos, twosA, twosB);
+        kr_rank_csa_detail_(&twosA, &ones, ones, words[i + 4], words[i + 5]);
+        kr_rank_csa_detail_(&twosB, &ones, ones, words[i + 6], words[i + 7]);
+        kr_rank_csa_detail_(&foursB, &twos, twos, twosA, twosB);
+        kr_rank_csa_detail_(&eightsA, &fours, fours, foursA, foursB);
+        kr_rank_csa_detail_(&twosA, &ones, ones, words[i + 8], words[i + 9]);
+        kr_rank_csa_detail_(&twosB, &ones, ones, words[i + 10], words[i + 11]);
+        kr_rank_csa_detail_(&foursA, &twos, twos, twosA, twosB);
+        kr_rank_csa_detail_(&twosA, &ones, ones, words[i + 12], words[i + 13]);
+        kr_rank_csa_detail_(&twosB, &ones, ones, words[i + 14], words[i + 15]);
+        kr_rank_csa_detail_(&foursB, &twos, twos, twosA, twosB);
+        kr_rank_csa_detail_(&eightsB, &fours, fours, foursA, foursB);
+        kr_rank_csa_detail_(&sixteens, &eights, eights, eightsA, eightsB);
+        total += KR_CASTS(uint64_t, kr_popcnt64(sixteens));
+    }
+    total = 16 * total + 8 * KR_CASTS(uint64_t, kr_popcnt64(eights)) + 4 * KR_CASTS(uint64_t, kr_popcnt64(fours)) +
+            2 * KR_CASTS(uint64_t, kr_popcnt64(twos)) + KR_CASTS(uint64_t, kr_popcnt64(ones));
+
+    for (; i < n; i++)
+    {
+        total += KR_CASTS(uint64_t, kr_popcnt64(words[i]));
+    }
+    return total;
+}
+
+KR_INLINE uint64_t kr_popcount_array(const uint64_t *words, size_t n)
+{
+#if (KR_AVX2)
+    return kr_rank_popcount_avx2_detail_(words, n);
+#elif (KR_NEON)
+    return kr_rank_popcount_neon_detail_(words, n);
+#else
+#if (KR_CPU_DISPATCH)
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        return kr_rank_popcount_avx2_detail_(words, n);
+    }
+    else if (kr_cpu_has(KR_CPU_POPCNT))
+    {
+        return kr_rank_popcount_popcnt_detail_(words, n);
+    }
+#endif /* (KR_CPU_DISPATCH) */
+    return kr_rank_popcount_csa_detail_(words, n);
+#endif
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE bool kr_rank_init(struct kr_rank_s *rs, const uint64_t *words, size_t nbits)
+{
+    const size_t nwords = nbits / 64 + (nbits % 64 != 0);
+    const size_t nblocks = nwords / 8 + 1;
+    uint64_t ones = 0, rel = 0, w = 0, end = 0;
+    size_t b = 0, j = 0, s = 0;
+
+    rs->words = words;
+    rs->nbits = nbits;
+    rs->ones = 0;
+    rs->samples = NULL;
+
+    /* Two count words per block of eight words, plus one more block so a
+     * query at the very end needs no special case. */
+    rs->counts = KR_CASTS(uint64_t *, kr_reallocarray(NULL, nblocks, sizeof(uint64_t) * 2));
+    if (rs->counts == NULL)
+    {
+        return false;
+    }
+
+    for (b = 0; b < nblocks; b++)
+    {
+        rs->counts[b * 2] = ones;
+        rel = 0;
+        for (j = 0; j < 8; j++)
+        {
+            if (j != 0)
+            {
+                rel |= (ones - rs->counts[b * 2]) << (9 * (j - 1));
+            }
+            if (b * 8 + j < nwords)
+            {
+                w = words[b * 8 + j];
+                if (b * 8 + j == nwords - 1 && nbits % 64 != 0)
+                {
+                    w &= (UINT64_C(1) << (nbits % 64)) - 1;
+                }
+                ones += KR_CASTS(uint64_t, kr_popcnt64(w));
+            }
+        }
+        rs->counts[b * 2 + 1] = rel;
+    }
+    rs->ones = ones;
+
+    /* Remember which block holds every 512th set bit, with a final entry
+     * past the end to bound the search. */
+    rs->samples = KR_CASTS(size_t *, kr_reallocarray(NULL, KR_CASTS(size_t, ones / 512) + 2, sizeof(size_t)));
+    if (rs->samples == NULL)
+    {
+        kr_rank_free(rs);
+        return false;
+    }
+
+    for (b = 0; b < nblocks; b++)
+    {
+        end = b + 1 < nblocks ? rs->counts[(b + 1) * 2] : ones;
+        for (; s * 512 < end; s++)
+        {
+            rs->samples[s] = b;
+        }
+    }
+    rs->samples[s] = nblocks - 1;
+    return true;
+}
+
+KR_INLINE void kr_rank_free(struct kr_rank_s *rs)
+{
+    KR_FREE(rs->counts);
+    KR_FREE(rs->samples);
+    rs->words = NULL;
+    rs->nbits = 0;
+    rs->ones = 0;
+    rs->counts = NULL;
+    rs->samples = NULL;
+}
+
+/******************************************************************************/
+
+KR_INLINE uint64_t kr_rank1(const struct kr_rank_s *rs, size_t pos)
+{
+    const size_t w = pos / 64, b = w / 8, j = w % 8;
+    uint64_t r = rs->counts[b * 2] + KR_RANK_REL_DETAIL_(rs->counts[b * 2 + 1], j);
+
+    if (pos % 64 != 0)
+    {
+        r += KR_CASTS(uint64_t, kr_popcnt64(rs->words[w] & ((UINT64_C(1) << (pos % 64)) - 1)));
+    }
+    return r;
+}
+
+KR_INLINE uint64_t kr_rank0(const struct kr_rank_s *rs, size_t pos)
+{
+    return pos - kr_rank1(rs, pos);
+}
+
+KR_INLINE size_t kr_select1(const struct kr_rank_s *rs, uint64_t k)
+{
+    size_t lo = 0, hi = 0, mid = 0, j = 0;
+    uint64_t c = 0;
+
+    if (k >= rs->ones)
+    {
+        return rs->nbits;
+    }
+
+    /* Find the last block that starts at or before the k-th set bit. */
+    lo = rs->samples[k / 512];
+    hi = rs->samples[k / 512 + 1];
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo + 1) / 2;
+        if (rs->counts[mid * 2] <= k)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+
+    /* Find the word inside the block, then the bit inside the word. */
+    k -= rs->counts[lo * 2];
+    c = rs->counts[lo * 2 + 1];
+    j = 1;
+    while (j < 8 && KR_RANK_REL_DETAIL_(c, j) <= k)
+    {
+        j++;
+    }
+    j--;
+    return (lo * 8 + j) * 64 + kr_bit_select64(rs->words[lo * 8 + j], KR_CASTS(unsigned, k - KR_RANK_REL_DETAIL_(c, j)));
+}
+
+#undef KR_RANK_REL_DETAIL_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* defined(UINT64_MAX) */
+
+#endif /* !defined(KRRANK_H) */
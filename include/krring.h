@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * Lock-free single-producer, single-consumer ring buffer.
+ *
+ * One thread pushes and one other thread pops, with no locks and no
+ * read-modify-write instructions, only loads and stores of the head and tail
+ * counters with acquire and release ordering.  Each side keeps a private
+ * copy of the other side's counter and only reloads it when the ring looks
+ * full or empty, so in the steady state the two threads rarely touch each
+ * other's cache lines.
+ *
+ * Atomics come from <atomic> in C++11, <stdatomic.h> in C11, and the
+ * __atomic builtins in GCC and Clang otherwise.  Older Visual C++ uses
+ * volatile with an explicit barrier, and any other compiler is an error.
+ *
+ * User configuration settings:
+ *
+ * KR_RING_CACHELINE:
+ *	Distance kept between the head and tail counters, so that the producer
+ *  and consumer do not share a cache line.  Defaults to 64.  Must be at
+ *  least sizeof(void *) + 2 * sizeof(size_t), and the ring is aligned to it
+ *  where the compiler allows.
+ */
+
+#if !defined(KRRING_H)
+#define KRRING_H
+
+#include "./krconfig.h"
+
+#include "./krbit.h"
+#include "./krbool.h"
+#include "./krint.h"
+#include "./krlib.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (KR_CPLUSPLUS >= 201103)
+#include <atomic>
+#elif (KR_STDC_VERSION >= 201112) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#elif (KR_MSC_VER) && !(KR_CLANG)
+#include <intrin.h>
+#endif
+#endif /* (!KR_CONFIG_NOINCLUDE) */
+
+#if !defined(KR_RING_CACHELINE)
+#define KR_RING_CACHELINE (64)
+#endif
+
+/*
+ * Each counter and the fields beside it must fit in one cache line.
+ */
+
+#define KR_RING_CACHELINE_OK_DETAIL_ (KR_RING_CACHELINE >= sizeof(void *) + 2 * sizeof(size_t))
+
+#if (KR_CPLUSPLUS >= 201103)
+static_assert(KR_RING_CACHELINE_OK_DETAIL_, "KR_RING_CACHELINE must be at least sizeof(void *) + 2 * sizeof(size_t)");
+#elif (KR_STDC_VERSION >= 201112)
+_Static_assert(KR_RING_CACHELINE_OK_DETAIL_, "KR_RING_CACHELINE must be at least sizeof(void *) + 2 * sizeof(size_t)");
+#else
+typedef char kr_ring_cacheline_too_small_detail_[KR_RING_CACHELINE_OK_DETAIL_ ? 1 : -1];
+#endif
+
+#undef KR_RING_CACHELINE_OK_DETAIL_
+
+/*
+ * Aligns the first field of the ring, and so the ring itself, to a cache
+ * line.  Older Visual C++ only takes a literal alignment, so it goes without.
+ */
+
+#if (KR_CPLUSPLUS >= 201103)
+#define KR_RING_ALIGN_DETAIL_ alignas(KR_RING_CACHELINE)
+#elif (KR_STDC_VERSION >= 201112)
+#define KR_RING_ALIGN_DETAIL_ _Alignas(KR_RING_CACHELINE)
+#elif (KR_GNUC || KR_CLANG)
+#define KR_RING_ALIGN_DETAIL_ __attribute__((aligned(KR_RING_CACHELINE)))
+#else
+#define KR_RING_ALIGN_DETAIL_
+#endif
+
+/*
+ * An atomic counter, and loads and stores of it with the given ordering.
+ */
+
+#if (KR_CPLUSPLUS >= 201103)
+#define KR_RING_ATOMIC_DETAIL_ std::atomic<size_t>
+#define KR_RING_LOAD_DETAIL_(p, o) ((p)->load(std::memory_order_##o))
+#define KR_RING_STORE_DETAIL_(p, v, o) ((p)->store((v), std::memory_order_##o))
+#elif (KR_STDC_VERSION >= 201112) && !defined(__STDC_NO_ATOMICS__)
+#define KR_RING_ATOMIC_DETAIL_ _Atomic size_t
+#define KR_RING_LOAD_DETAIL_(p, o) (atomic_load_explicit((p), memory_order_##o))
+#define KR_RING_STORE_DETAIL_(p, v, o) (atomic_store_explicit((p), (v), memory_order_##o))
+#elif (KR_GNUC || KR_CLANG)
+#define KR_RING_ATOMIC_DETAIL_ size_t
+#define KR_RING_ORDER_relaxed_DETAIL_ __ATOMIC_RELAXED
+#define KR_RING_ORDER_acquire_DETAIL_ __ATOMIC_ACQUIRE
+#define KR_RING_ORDER_release_DETAIL_ __ATOMIC_RELEASE
+#define KR_RING_LOAD_DETAIL_(p, o) (__atomic_load_n((p), KR_RING_ORDER_##o##_DETAIL_))
+#define KR_RING_STORE_DETAIL_(p, v, o) (__atomic_store_n((p), (v), KR_RING_ORDER_##o##_DETAIL_))
+#elif (KR_MSC_VER)
+#define KR_RING_ATOMIC_DETAIL_ volatile size_t
+#define KR_RING_LOAD_DETAIL_(p, o) (kr_ring_load_detail_(p))
+#define KR_RING_STORE_DETAIL_(p, v, o) (kr_ring_store_detail_((p), (v)))
+
+/*
+ * x86 keeps loads and stores in order by itself, so only the compiler needs
+ * holding back.  ARM needs a real barrier.  Every ordering gets both, which
+ * is at least as strong as asked for.
+ */
+#if defined(_M_ARM64)
+#define KR_RING_BARRIER_DETAIL_() __dmb(_ARM64_BARRIER_ISH)
+#elif defined(_M_ARM)
+#define KR_RING_BARRIER_DETAIL_() __dmb(_ARM_BARRIER_ISH)
+#else
+#define KR_RING_BARRIER_DETAIL_() _ReadWriteBarrier()
+#endif
+#else
+#error "krring.h needs C11 or C++11 atomics, GCC, Clang, or Visual C++"
+#endif
+
+/**
+ * @brief A bounded queue between one producer thread and one consumer
+ *        thread.
+ *
+ * @details head and tail count every element ever popped and pushed, and
+ *          wrap around freely.  Only the consumer writes head and tailCache,
+ *          and only the producer writes tail and headCache, so each pair
+ *          lives on its own cache line.
+ *
+ *          The padding counts from the start of the ring, so the ring is
+ *          over-aligned to KR_RING_CACHELINE where the compiler supports it.
+ *          Rings allocated on the heap, or built by older Visual C++ in C,
+ *          must be placed on a KR_RING_CACHELINE boundary by the caller to
+ *          keep the counters apart.
+ */
+struct kr_ring_s
+{
+    KR_RING_ALIGN_DETAIL_ unsigned char *data;
+    size_t mask;
+    size_t elemSize;
+    char pad0[KR_RING_CACHELINE - sizeof(unsigned char *) - 2 * sizeof(size_t)];
+    KR_RING_ATOMIC_DETAIL_ head;
+    size_t tailCache;
+    char pad1[KR_RING_CACHELINE - sizeof(KR_RING_ATOMIC_DETAIL_) - sizeof(size_t)];
+    KR_RING_ATOMIC_DETAIL_ tail;
+    size_t headCache;
+    char pad2[KR_RING_CACHELINE - sizeof(KR_RING_ATOMIC_DETAIL_) - sizeof(size_t)];
+};
+
+#undef KR_RING_ALIGN_DETAIL_
+
+/**
+ * @brief Initialize an empty ring and allocate its storage.  Not safe to
+ *        call while another thread uses the ring.
+ *
+ * @param ring Ring to initialize.
+ * @param elemSize Size of each element.  Must not be 0.
+ * @param cap Number of elements the ring can hold.  Must be a power of two.
+ * @return true if successful, or false if the capacity is not a power of
+ *         two or allocation failed.  The ring is empty either way.
+ */
+KR_NODISCARD KR_INLINE bool kr_ring_init(struct kr_ring_s *ring, size_t elemSize, uint32_t cap);
+
+/**
+ * @brief Free the storage of a ring and leave it empty.  Not safe to call
+ *        while another thread uses the ring.
+ *
+ * @param ring Ring to free.
+ */
+KR_INLINE void kr_ring_free(struct kr_ring_s *ring);
+
+/**
+ * @brief Add an element to a ring.  Only call from the producer thread.
+ *
+ * @param ring Ring to push to.
+ * @param elem Element to copy.
+ * @return true if successful, or false if the ring is full.
+ */
+KR_NODISCARD KR_INLINE bool kr_ring_push(struct kr_ring_s *KR_RESTRICT ring, const void *KR_RESTRICT elem);
+
+/**
+ * @brief Add as many elements from an array as fit to a ring, making them
+ *        visible to the consumer all at once.  Only call from the producer
+ *        thread.
+ *
+ * @param ring Ring to push to.
+ * @param elems Elements to copy.
+ * @param n Number of elements to copy.
+ * @return Number of elements added, from the start of the array.
+ */
+KR_NODISCARD KR_INLINE size_t kr_ring_push_n(struct kr_ring_s *KR_RESTRICT ring, const void *KR_RESTRICT elems,
+                                             size_t n);
+
+/**
+ * @brief Remove the oldest element from a ring.  Only call from the consumer
+ *        thread.
+ *
+ * @param ring Ring to pop from.
+ * @param elem Set to the removed element.
+ * @return true if successful, or false if the ring is empty.
+ */
+KR_NODISCARD KR_INLINE bool kr_ring_pop(struct kr_ring_s *KR_RESTRICT ring, void *KR_RESTRICT elem);
+
+/**
+ * @brief Remove as many of the oldest elements from a ring as are there, up
+ *        to a limit.  Only call from the consumer thread.
+ *
+ * @param ring Ring to pop from.
+ * @param elems Set to the removed elements, oldest first.
+ * @param n Maximum number of elements to remove.
+ * @return Number of elements removed.
+ */
+KR_NODISCARD KR_INLINE size_t kr_ring_pop_n(struct kr_ring_s *KR_RESTRICT ring, void *KR_RESTRICT elems, size_t n);
+
+/**
+ * @brief Get the number of elements in a ring.  From either thread, the
+ *        answer may already be out of date.
+ */
+KR_INLINE size_t kr_ring_count(const struct kr_ring_s *ring);
+
+/**
+ * @brief Get the number of elements a ring can hold.
+ */
+KR_INLINE size_t kr_ring_capacity(const struct kr_ring_s *ring);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+#if defined(KR_RING_BARRIER_DETAIL_)
+/**
+ * @brief Load a counter with acquire ordering.
+ */
+KR_INLINE size_t kr_ring_load_detail_(const volatile size_t *p)
+{
+    const size_t v = *p;
+    KR_RING_BARRIER_DETAIL_();
+    return v;
+}
+
+/**
+ * @brief Store a counter with release ordering.
+ */
+KR_INLINE void kr_ring_store_detail_(volatile size_t *p, size_t v)
+{
+    KR_RING_BARRIER_DETAIL_();
+    *p = v;
+}
+#endif /* defined(KR_RING_BARRIER_DETAIL_) */
+
+KR_NODISCARD KR_INLINE bool kr_ring_init(struct kr_ring_s *ring, size_t elemSize, uint32_t cap)
+{
+    ring->data = NULL;
+    ring->mask = 0;
+    ring->elemSize = elemSize;
+    KR_RING_STORE_DETAIL_(&ring->head, 0, relaxed);
+    ring->tailCache = 0;
+    KR_RING_STORE_DETAIL_(&ring->tail, 0, relaxed);
+    ring->headCache = 0;
+
+    if (!kr_has_single_bit32(cap))
+    {
+        return false;
+    }
+
+    ring->data = KR_CASTS(unsigned char *, kr_reallocarray(NULL, cap, elemSize));
+    if (ring->data == NULL)
+    {
+        return false;
+    }
+
+    ring->mask = cap - 1;
+    return true;
+}
+
+KR_INLINE void kr_ring_free(struct kr_ring_s *ring)
+{
+    KR_FREE(ring->data);
+    ring->data = NULL;
+    ring->mask = 0;
+    KR_RING_STORE_DETAIL_(&ring->head, 0, relaxed);
+    ring->tailCache = 0;
+    KR_RING_STORE_DETAIL_(&ring->tail, 0, relaxed);
+    ring->headCache = 0;
+}
+
+/******************************************************************************/
+
+/**
+ * @brief Copy elements into the ring starting at a counter, wrapping around
+ *        the end of the storage.
+ */
+KR_INLINE void kr_ring_write_detail_(struct kr_ring_s *ring, size_t pos, const unsigned char *src, size_t n)
+{
+    const size_t i = pos & ring->mask, first = ring->mask + 1 - i < n ? ring->mask + 1 - i : n;
+
+    memcpy(ring->data + i * ring->elemSize, src, first * ring->elemSize);
+    memcpy(ring->data, src + first * ring->elemSize, (n - first) * ring->elemSize);
+}
+
+/**
+ * @brief Copy elements out of the ring starting at a counter, wrapping
+ *        around the end of the storage.
+ */
+KR_INLINE void kr_ring_read_detail_(const struct kr_ring_s *ring, size_t pos, unsigned char *dest, size_t n)
+{
+    const size_t i = pos & ring->mask, first = ring->mask + 1 - i < n ? ring->mask + 1 - i : n;
+
+    memcpy(dest, ring->data + i * ring->elemSize, first * ring->elemSize);
+    memcpy(dest + first * ring->elemSize, ring->data, (n - first) * ring->elemSize);
+}
+
+KR_NODISCARD KR_INLINE bool kr_ring_push(struct kr_ring_s *KR_RESTRICT ring, const void *KR_RESTRICT elem)
+{
+    const size_t tail = KR_RING_LOAD_DETAIL_(&ring->tail, relaxed);
+
+    if (tail - ring->headCache > ring->mask)
+    {
+        /* Looks full, so see how far the consumer has really got. */
+        ring->headCache = KR_RING_LOAD_DETAIL_(&ring->head, acquire);
+        if (tail - ring->headCache > ring->mask)
+        {
+            return false;
+        }
+    }
+
+    memcpy(ring->data + (tail & ring->mask) * ring->elemSize, elem, ring->elemSize);
+    KR_RING_STORE_DETAIL_(&ring->tail, tail + 1, release);
+    return true;
+}
+
+KR_NODISCARD KR_INLINE size_t kr_ring_push_n(struct kr_ring_s *KR_RESTRICT ring, const void *KR_RESTRICT elems,
+                                             size_t n)
+{
+    const size_t tail = KR_RING_LOAD_DETAIL_(&ring->tail, relaxed);
+    size_t space = ring->mask + 1 - (tail - ring->headCache);
+
+    if (space < n)
+    {
+        ring->headCache = KR_RING_LOAD_DETAIL_(&ring->head, acquire);
+        space = ring->mask + 1 - (tail - ring->headCache);
+        n = space < n ? space : n;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    kr_ring_write_detail_(ring, tail, KR_CASTS(const unsigned char *, elems), n);
+    KR_RING_STORE_DETAIL_(&ring->tail, tail + n, release);
+    return n;
+}
+
+KR_NODISCARD KR_INLINE bool kr_ring_pop(struct kr_ring_s *KR_RESTRICT ring, void *KR_RESTRICT elem)
+{
+    const size_t head = KR_RING_LOAD_DETAIL_(&ring->head, relaxed);
+
+    if (head == ring->tailCache)
+    {
+        /* Looks empty, so see how far the producer has really got. */
+        ring->tailCache = KR_RING_LOAD_DETAIL_(&ring->tail, acquire);
+        if (head == ring->tailCache)
+        {
+            return false;
+        }
+    }
+
+    memcpy(elem, ring->data + (head & ring->mask) * ring->elemSize, ring->elemSize);
+    KR_RING_STORE_DETAIL_(&ring->head, head + 1, release);
+    return true;
+}
+
+KR_NODISCARD KR_INLINE size_t kr_ring_pop_n(struct kr_ring_s *KR_RESTRICT ring, void *KR_RESTRICT elems, size_t n)
+{
+    const size_t head = KR_RING_LOAD_DETAIL_(&ring->head, relaxed);
+    size_t avail = ring->tailCache - head;
+
+    if (avail < n)
+    {
+        ring->tailCache = KR_RING_LOAD_DETAIL_(&ring->tail, acquire);
+        avail = ring->tailCache - head;
+        n = avail < n ? avail : n;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    kr_ring_read_detail_(ring, head, KR_CASTS(unsigned char *, elems), n);
+    KR_RING_STORE_DETAIL_(&ring->head, head + n, release);
+    return n;
+}
+
+/******************************************************************************/
+
+KR_INLINE size_t kr_ring_count(const struct kr_ring_s *ring)
+{
+    const size_t head = KR_RING_LOAD_DETAIL_(&ring->head, acquire);
+    const size_t tail = KR_RING_LOAD_DETAIL_(&ring->tail, acquire);
+
+    /* The consumer may have moved on between the two loads, so the tail
+     * can be more than a full ring ahead of the head that was seen. */
+    return tail - head <= ring->mask + 1 ? tail - head : ring->mask + 1;
+}
+
+KR_INLINE size_t kr_ring_capacity(const struct kr_ring_s *ring)
+{
+    return ring->data != NULL ? ring->mask + 1 : 0;
+}
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRRING_H) */
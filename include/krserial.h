@@ -15,19 +15,30 @@
 
 #include "./krconfig.h"
 
-#include "./krbit.h" /* Needed for bswap. */
+#include "./krbltin.h" /* Needed for bswap. */
+#include "./krbool.h"
+#include "./krcpu.h"
+#include "./krint.h"
 
 #if (!KR_CONFIG_NOINCLUDE)
 #include <string.h>
 #endif /* (!KR_CONFIG_NOINCLUDE) */
 
-KR_INLINE uint16_t kr_load_u16le(void *src);
-KR_INLINE uint16_t kr_load_u16be(void *src);
-KR_INLINE uint32_t kr_load_u32le(void *src);
-KR_INLINE uint32_t kr_load_u32be(void *src);
+#if (KR_AVX2) || (KR_CPU_DISPATCH)
+#include <immintrin.h>
+#elif (KR_SSE2)
+#include <emmintrin.h>
+#elif (KR_NEON)
+#include <arm_neon.h>
+#endif
+
+KR_INLINE uint16_t kr_load_u16le(const void *src);
+KR_INLINE uint16_t kr_load_u16be(const void *src);
+KR_INLINE uint32_t kr_load_u32le(const void *src);
+KR_INLINE uint32_t kr_load_u32be(const void *src);
 #if defined(UINT64_MAX)
-KR_INLINE uint64_t kr_load_u64le(void *src);
-KR_INLINE uint64_t kr_load_u64be(void *src);
+KR_INLINE uint64_t kr_load_u64le(const void *src);
+KR_INLINE uint64_t kr_load_u64be(const void *src);
 #endif /* defined(UINT64_MAX) */
 
 KR_INLINE void kr_store_u16le(void *dest, uint16_t src);
@@ -39,11 +50,166 @@ KR_INLINE void kr_store_u64le(void *dest, uint64_t src);
 KR_INLINE void kr_store_u64be(void *dest, uint64_t src);
 #endif /* defined(UINT64_MAX) */
 
+/*
+ * Array versions.  These are a plain memcpy when the byte order already
+ * matches, and otherwise swap a vector at a time where KR_AVX2, KR_SSE2 or
+ * KR_NEON is available.  With KR_CPU_DISPATCH, AVX2 is also used if the
+ * running CPU supports it.
+ */
+
+KR_INLINE void kr_bswap16_array(uint16_t *arr, size_t n);
+KR_INLINE void kr_bswap32_array(uint32_t *arr, size_t n);
+#if defined(UINT64_MAX)
+KR_INLINE void kr_bswap64_array(uint64_t *arr, size_t n);
+#endif /* defined(UINT64_MAX) */
+
+KR_INLINE void kr_load_u16le_array(uint16_t *dest, const void *src, size_t n);
+KR_INLINE void kr_load_u16be_array(uint16_t *dest, const void *src, size_t n);
+KR_INLINE void kr_load_u32le_array(uint32_t *dest, const void *src, size_t n);
+KR_INLINE void kr_load_u32be_array(uint32_t *dest, const void *src, size_t n);
+#if defined(UINT64_MAX)
+KR_INLINE void kr_load_u64le_array(uint64_t *dest, const void *src, size_t n);
+KR_INLINE void kr_load_u64be_array(uint64_t *dest, const void *src, size_t n);
+#endif /* defined(UINT64_MAX) */
+
+KR_INLINE void kr_store_u16le_array(void *dest, const uint16_t *src, size_t n);
+KR_INLINE void kr_store_u16be_array(void *dest, const uint16_t *src, size_t n);
+KR_INLINE void kr_store_u32le_array(void *dest, const uint32_t *src, size_t n);
+KR_INLINE void kr_store_u32be_array(void *dest, const uint32_t *src, size_t n);
+#if defined(UINT64_MAX)
+KR_INLINE void kr_store_u64le_array(void *dest, const uint64_t *src, size_t n);
+KR_INLINE void kr_store_u64be_array(void *dest, const uint64_t *src, size_t n);
+#endif /* defined(UINT64_MAX) */
+
+/*
+ * Cursors.  A reader or writer tracks its position inside a buffer and
+ * latches an error flag instead of reading or writing out of bounds.
+ *
+ * The checked functions can be called back to back and the error flag
+ * checked once at the end, since after an error every read returns 0 and
+ * every write is dropped.  In hot loops, call kr_serial_reader_need or
+ * kr_serial_writer_need once for a whole record, then use the unchecked
+ * functions for its fields.
+ */
+
+struct kr_serial_reader_s
+{
+    const unsigned char *begin;
+    const unsigned char *cur;
+    const unsigned char *end;
+    bool error;
+};
+
+struct kr_serial_writer_s
+{
+    unsigned char *begin;
+    unsigned char *cur;
+    unsigned char *end;
+    bool error;
+};
+
+KR_INLINE void kr_serial_reader_init(struct kr_serial_reader_s *r, const void *data, size_t len);
+KR_INLINE size_t kr_serial_reader_tell(const struct kr_serial_reader_s *r);
+KR_INLINE size_t kr_serial_reader_remaining(const struct kr_serial_reader_s *r);
+KR_INLINE bool kr_serial_reader_need(struct kr_serial_reader_s *r, size_t len);
+KR_INLINE void kr_serial_read_skip(struct kr_serial_reader_s *r, size_t len);
+KR_INLINE void kr_serial_read_bytes(struct kr_serial_reader_s *KR_RESTRICT r, void *KR_RESTRICT dest, size_t len);
+KR_INLINE uint8_t kr_serial_read_u8(struct kr_serial_reader_s *r);
+KR_INLINE uint16_t kr_serial_read_u16le(struct kr_serial_reader_s *r);
+KR_INLINE uint16_t kr_serial_read_u16be(struct kr_serial_reader_s *r);
+KR_INLINE uint32_t kr_serial_read_u32le(struct kr_serial_reader_s *r);
+KR_INLINE uint32_t kr_serial_read_u32be(struct kr_serial_reader_s *r);
+#if defined(UINT64_MAX)
+KR_INLINE uint64_t kr_serial_read_u64le(struct kr_serial_reader_s *r);
+#endif /* defined(UINT64_MAX) */
+#if defined(UINT64_MAX)
+KR_INLINE uint64_t kr_serial_read_u64be(struct kr_serial_reader_s *r);
+#endif /* defined(UINT64_MAX) */
+KR_INLINE uint8_t kr_serial_read_u8_unchecked(struct kr_serial_reader_s *r);
+KR_INLINE uint16_t kr_serial_read_u16le_unchecked(struct kr_serial_reader_s *r);
+KR_INLINE uint16_t kr_serial_read_u16be_unchecked(struct kr_serial_reader_s *r);
+KR_INLINE uint32_t kr_serial_read_u32le_unchecked(struct kr_serial_reader_s *r);
+KR_INLINE uint32_t kr_serial_read_u32be_unchecked(struct kr_serial_reader_s *r);
+#if defined(UINT64_MAX)
+KR_INLINE uint64_t kr_serial_read_u64le_unchecked(struct kr_serial_reader_s *r);
+#endif /* defined(UINT64_MAX) */
+#if defined(UINT64_MAX)
+KR_INLINE uint64_t kr_serial_read_u64be_unchecked(struct kr_serial_reader_s *r);
+#endif /* defined(UINT64_MAX) */
+
+KR_INLINE void kr_serial_writer_init(struct kr_serial_writer_s *w, void *data, size_t len);
+KR_INLINE size_t kr_serial_writer_tell(const struct kr_serial_writer_s *w);
+KR_INLINE size_t kr_serial_writer_remaining(const struct kr_serial_writer_s *w);
+KR_INLINE bool kr_serial_writer_need(struct kr_serial_writer_s *w, size_t len);
+KR_INLINE void kr_serial_write_bytes(struct kr_serial_writer_s *KR_RESTRICT w, const void *KR_RESTRICT src, size_t len);
+KR_INLINE void kr_serial_write_u8(struct kr_serial_writer_s *w, uint8_t src);
+KR_INLINE void kr_serial_write_u16le(struct kr_serial_writer_s *w, uint16_t src);
+KR_INLINE void kr_serial_write_u16be(struct kr_serial_writer_s *w, uint16_t src);
+KR_INLINE void kr_serial_write_u32le(struct kr_serial_writer_s *w, uint32_t src);
+KR_INLINE void kr_serial_write_u32be(struct kr_serial_writer_s *w, uint32_t src);
+#if defined(UINT64_MAX)
+KR_INLINE void kr_serial_write_u64le(struct kr_serial_writer_s *w, uint64_t src);
+#endif /* defined(UINT64_MAX) */
+#if defined(UINT64_MAX)
+KR_INLINE void kr_serial_write_u64be(struct kr_serial_writer_s *w, uint64_t src);
+#endif /* defined(UINT64_MAX) */
+KR_INLINE void kr_serial_write_u8_unchecked(struct kr_serial_writer_s *w, uint8_t src);
+KR_INLINE void kr_serial_write_u16le_unchecked(struct kr_serial_writer_s *w, uint16_t src);
+KR_INLINE void kr_serial_write_u16be_unchecked(struct kr_serial_writer_s *w, uint16_t src);
+KR_INLINE void kr_serial_write_u32le_unchecked(struct kr_serial_writer_s *w, uint32_t src);
+KR_INLINE void kr_serial_write_u32be_unchecked(struct kr_serial_writer_s *w, uint32_t src);
+#if defined(UINT64_MAX)
+KR_INLINE void kr_serial_write_u64le_unchecked(struct kr_serial_writer_s *w, uint64_t src);
+#endif /* defined(UINT64_MAX) */
+#if defined(UINT64_MAX)
+KR_INLINE void kr_serial_write_u64be_unchecked(struct kr_serial_writer_s *w, uint64_t src);
+#endif /* defined(UINT64_MAX) */
+
+/*
+ * Variable-length integers.  Each load takes the number of bytes available
+ * and returns the number of bytes it consumed, or 0 if the input is
+ * truncated or malformed.  Each store needs room for the largest encoding
+ * and returns the number of bytes it wrote.
+ *
+ * LEB128 stores seven bits per byte, low bits first, with the high bit of
+ * each byte set if another byte follows.
+ *
+ * The prefix varint stores the length up front as a run of one bits at the
+ * top of the first byte, so a load finds the length with a single count of
+ * leading zeros and reads the rest without looping over bytes.  Lengths of
+ * 1 to 8 bytes hold 7 bits per byte.  A first byte of 0xFF is followed by
+ * all 64 bits in 8 bytes.
+ *
+ * Zigzag maps signed integers to unsigned ones with small magnitudes kept
+ * small, so they can be stored as an unsigned varint.
+ */
+
+KR_CONSTEXPR uint32_t kr_zigzag_encode32(int32_t x);
+KR_CONSTEXPR int32_t kr_zigzag_decode32(uint32_t x);
+#if defined(UINT64_MAX)
+KR_CONSTEXPR uint64_t kr_zigzag_encode64(int64_t x);
+KR_CONSTEXPR int64_t kr_zigzag_decode64(uint64_t x);
+
+#define KR_LEB128_MAXLEN (10)
+#define KR_PVARINT_MAXLEN (9)
+
+KR_INLINE size_t kr_store_uleb128(void *dest, uint64_t src);
+KR_INLINE size_t kr_store_sleb128(void *dest, int64_t src);
+KR_INLINE size_t kr_store_pvarint(void *dest, uint64_t src);
+
+KR_INLINE size_t kr_load_uleb128(const void *src, size_t len, uint64_t *dest);
+KR_INLINE size_t kr_load_sleb128(const void *src, size_t len, int64_t *dest);
+KR_INLINE size_t kr_load_pvarint(const void *src, size_t len, uint64_t *dest);
+
+KR_INLINE size_t kr_load_uleb128_array(uint64_t *dest, size_t n, const void *src, size_t len, size_t *used);
+KR_INLINE size_t kr_load_pvarint_array(uint64_t *dest, size_t n, const void *src, size_t len, size_t *used);
+#endif /* defined(UINT64_MAX) */
+
 /******************************************************************************/
 #if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
 /******************************************************************************/
 
-KR_INLINE uint16_t kr_load_u16le(void *src)
+KR_INLINE uint16_t kr_load_u16le(const void *src)
 {
     uint16_t rvo;
     memcpy(&rvo, src, sizeof(rvo));
@@ -53,7 +219,7 @@ KR_INLINE uint16_t kr_load_u16le(void *src)
     return rvo;
 }
 
-KR_INLINE uint16_t kr_load_u16be(void *src)
+KR_INLINE uint16_t kr_load_u16be(const void *src)
 {
     uint16_t rvo;
     memcpy(&rvo, src, sizeof(rvo));
@@ -65,7 +231,7 @@ KR_INLINE uint16_t kr_load_u16be(void *src)
 
 /******************************************************************************/
 
-KR_INLINE uint32_t kr_load_u32le(void *src)
+KR_INLINE uint32_t kr_load_u32le(const void *src)
 {
     uint32_t rvo;
     memcpy(&rvo, src, sizeof(rvo));
@@ -75,7 +241,7 @@ KR_INLINE uint32_t kr_load_u32le(void *src)
     return rvo;
 }
 
-KR_INLINE uint32_t kr_load_u32be(void *src)
+KR_INLINE uint32_t kr_load_u32be(const void *src)
 {
     uint32_t rvo;
     memcpy(&rvo, src, sizeof(rvo));
@@ -89,7 +255,7 @@ KR_INLINE uint32_t kr_load_u32be(void *src)
 
 #if defined(UINT64_MAX)
 
-KR_INLINE uint64_t kr_load_u64le(void *src)
+KR_INLINE uint64_t kr_load_u64le(const void *src)
 {
     uint64_t rvo;
     memcpy(&rvo, src, sizeof(rvo));
@@ -99,7 +265,7 @@ KR_INLINE uint64_t kr_load_u64le(void *src)
     return rvo;
 }
 
-KR_INLINE uint64_t kr_load_u64be(void *src)
+KR_INLINE uint64_t kr_load_u64be(const void *src)
 {
     uint64_t rvo;
     memcpy(&rvo, src, sizeof(rvo));
@@ -169,6 +335,868 @@ KR_INLINE void kr_store_u64be(void *dest, uint64_t src)
 
 #endif /* defined(UINT64_MAX) */
 
+/******************************************************************************/
+
+#if (KR_AVX2) || (KR_CPU_DISPATCH)
+
+/**
+ * @brief Byteswap every element of an array 32 bytes at a time with AVX2.
+ *
+ * @param width Size of each element, 2, 4 or 8.
+ * @return Number of elements swapped, which leaves fewer than a vector's
+ *         worth for the caller.
+ */
+KR_CPU_TARGET("avx2") KR_INLINE size_t kr_serial_bswap_avx2_detail_(unsigned char *dest, const unsigned char *src,
+                                                                    size_t n, size_t width)
+{
+    __m256i mask;
+    size_t i = 0;
+
+    if (width == 2)
+    {
+        mask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    }
+    else if (width == 4)
+    {
+        mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    }
+    else
+    {
+        mask = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    }
+
+    for (; i + 32 <= n * width; i += 32)
+    {
+        const __m256i x = _mm256_loadu_si256(KR_CASTR(const __m256i *, src + i));
+        _mm256_storeu_si256(KR_CASTR(__m256i *, dest + i), _mm256_shuffle_epi8(x, mask));
+    }
+    return i / width;
+}
+
+#endif /* (KR_AVX2) || (KR_CPU_DISPATCH) */
+
+/******************************************************************************/
+
+KR_INLINE void kr_bswap16_copy_detail_(unsigned char *dest, const unsigned char *src, size_t n)
+{
+    size_t i = 0;
+    uint16_t v;
+
+#if (KR_AVX2)
+    i = kr_serial_bswap_avx2_detail_(dest, src, n, 2);
+#else
+#if (KR_CPU_DISPATCH)
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        i = kr_serial_bswap_avx2_detail_(dest, src, n, 2);
+    }
+#endif /* (KR_CPU_DISPATCH) */
+#if (KR_SSE2)
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i x = _mm_loadu_si128(KR_CASTR(const __m128i *, src + i * 2));
+        x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+        _mm_storeu_si128(KR_CASTR(__m128i *, dest + i * 2), x);
+    }
+#elif (KR_NEON)
+    for (; i + 8 <= n; i += 8)
+    {
+        vst1q_u8(dest + i * 2, vrev16q_u8(vld1q_u8(src + i * 2)));
+    }
+#endif
+#endif
+
+    for (; i < n; i++)
+    {
+        memcpy(&v, src + i * 2, sizeof(v));
+        v = kr_bswap16(v);
+        memcpy(dest + i * 2, &v, sizeof(v));
+    }
+}
+
+KR_INLINE void kr_bswap16_array(uint16_t *arr, size_t n)
+{
+    kr_bswap16_copy_detail_(KR_CASTR(unsigned char *, arr), KR_CASTR(const unsigned char *, arr), n);
+}
+
+KR_INLINE void kr_load_u16le_array(uint16_t *dest, const void *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_BIG_ENDIAN)
+    kr_bswap16_copy_detail_(KR_CASTR(unsigned char *, dest), KR_CASTS(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*dest));
+#endif
+}
+
+KR_INLINE void kr_load_u16be_array(uint16_t *dest, const void *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_LITTLE_ENDIAN)
+    kr_bswap16_copy_detail_(KR_CASTR(unsigned char *, dest), KR_CASTS(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*dest));
+#endif
+}
+
+KR_INLINE void kr_store_u16le_array(void *dest, const uint16_t *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_BIG_ENDIAN)
+    kr_bswap16_copy_detail_(KR_CASTS(unsigned char *, dest), KR_CASTR(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*src));
+#endif
+}
+
+KR_INLINE void kr_store_u16be_array(void *dest, const uint16_t *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_LITTLE_ENDIAN)
+    kr_bswap16_copy_detail_(KR_CASTS(unsigned char *, dest), KR_CASTR(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*src));
+#endif
+}
+
+/******************************************************************************/
+
+KR_INLINE void kr_bswap32_copy_detail_(unsigned char *dest, const unsigned char *src, size_t n)
+{
+    size_t i = 0;
+    uint32_t v;
+
+#if (KR_AVX2)
+    i = kr_serial_bswap_avx2_detail_(dest, src, n, 4);
+#else
+#if (KR_CPU_DISPATCH)
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        i = kr_serial_bswap_avx2_detail_(dest, src, n, 4);
+    }
+#endif /* (KR_CPU_DISPATCH) */
+#if (KR_SSE2)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i x = _mm_loadu_si128(KR_CASTR(const __m128i *, src + i * 4));
+        x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(KR_CASTR(__m128i *, dest + i * 4), x);
+    }
+#elif (KR_NEON)
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_u8(dest + i * 4, vrev32q_u8(vld1q_u8(src + i * 4)));
+    }
+#endif
+#endif
+
+    for (; i < n; i++)
+    {
+        memcpy(&v, src + i * 4, sizeof(v));
+        v = kr_bswap32(v);
+        memcpy(dest + i * 4, &v, sizeof(v));
+    }
+}
+
+KR_INLINE void kr_bswap32_array(uint32_t *arr, size_t n)
+{
+    kr_bswap32_copy_detail_(KR_CASTR(unsigned char *, arr), KR_CASTR(const unsigned char *, arr), n);
+}
+
+KR_INLINE void kr_load_u32le_array(uint32_t *dest, const void *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_BIG_ENDIAN)
+    kr_bswap32_copy_detail_(KR_CASTR(unsigned char *, dest), KR_CASTS(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*dest));
+#endif
+}
+
+KR_INLINE void kr_load_u32be_array(uint32_t *dest, const void *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_LITTLE_ENDIAN)
+    kr_bswap32_copy_detail_(KR_CASTR(unsigned char *, dest), KR_CASTS(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*dest));
+#endif
+}
+
+KR_INLINE void kr_store_u32le_array(void *dest, const uint32_t *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_BIG_ENDIAN)
+    kr_bswap32_copy_detail_(KR_CASTS(unsigned char *, dest), KR_CASTR(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*src));
+#endif
+}
+
+KR_INLINE void kr_store_u32be_array(void *dest, const uint32_t *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_LITTLE_ENDIAN)
+    kr_bswap32_copy_detail_(KR_CASTS(unsigned char *, dest), KR_CASTR(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*src));
+#endif
+}
+
+/******************************************************************************/
+
+#if defined(UINT64_MAX)
+
+KR_INLINE void kr_bswap64_copy_detail_(unsigned char *dest, const unsigned char *src, size_t n)
+{
+    size_t i = 0;
+    uint64_t v;
+
+#if (KR_AVX2)
+    i = kr_serial_bswap_avx2_detail_(dest, src, n, 8);
+#else
+#if (KR_CPU_DISPATCH)
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        i = kr_serial_bswap_avx2_detail_(dest, src, n, 8);
+    }
+#endif /* (KR_CPU_DISPATCH) */
+#if (KR_SSE2)
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128i x = _mm_loadu_si128(KR_CASTR(const __m128i *, src + i * 8));
+        x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128(KR_CASTR(__m128i *, dest + i * 8), x);
+    }
+#elif (KR_NEON)
+    for (; i + 2 <= n; i += 2)
+    {
+        vst1q_u8(dest + i * 8, vrev64q_u8(vld1q_u8(src + i * 8)));
+    }
+#endif
+#endif
+
+    for (; i < n; i++)
+    {
+        memcpy(&v, src + i * 8, sizeof(v));
+        v = kr_bswap64(v);
+        memcpy(dest + i * 8, &v, sizeof(v));
+    }
+}
+
+KR_INLINE void kr_bswap64_array(uint64_t *arr, size_t n)
+{
+    kr_bswap64_copy_detail_(KR_CASTR(unsigned char *, arr), KR_CASTR(const unsigned char *, arr), n);
+}
+
+KR_INLINE void kr_load_u64le_array(uint64_t *dest, const void *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_BIG_ENDIAN)
+    kr_bswap64_copy_detail_(KR_CASTR(unsigned char *, dest), KR_CASTS(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*dest));
+#endif
+}
+
+KR_INLINE void kr_load_u64be_array(uint64_t *dest, const void *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_LITTLE_ENDIAN)
+    kr_bswap64_copy_detail_(KR_CASTR(unsigned char *, dest), KR_CASTS(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*dest));
+#endif
+}
+
+KR_INLINE void kr_store_u64le_array(void *dest, const uint64_t *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_BIG_ENDIAN)
+    kr_bswap64_copy_detail_(KR_CASTS(unsigned char *, dest), KR_CASTR(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*src));
+#endif
+}
+
+KR_INLINE void kr_store_u64be_array(void *dest, const uint64_t *src, size_t n)
+{
+#if (KR_BYTE_ORDER == KR_ORDER_LITTLE_ENDIAN)
+    kr_bswap64_copy_detail_(KR_CASTS(unsigned char *, dest), KR_CASTR(const unsigned char *, src), n);
+#else
+    memcpy(dest, src, n * sizeof(*src));
+#endif
+}
+
+#endif /* defined(UINT64_MAX) */
+
+/******************************************************************************/
+
+KR_INLINE void kr_serial_reader_init(struct kr_serial_reader_s *r, const void *data, size_t len)
+{
+    r->begin = KR_CASTS(const unsigned char *, data);
+    r->cur = r->begin;
+    r->end = r->begin + len;
+    r->error = false;
+}
+
+KR_INLINE size_t kr_serial_reader_tell(const struct kr_serial_reader_s *r)
+{
+    return KR_CASTS(size_t, r->cur - r->begin);
+}
+
+KR_INLINE size_t kr_serial_reader_remaining(const struct kr_serial_reader_s *r)
+{
+    return KR_CASTS(size_t, r->end - r->cur);
+}
+
+KR_INLINE bool kr_serial_reader_need(struct kr_serial_reader_s *r, size_t len)
+{
+    if (len > KR_CASTS(size_t, r->end - r->cur))
+    {
+        /* Latch the error, and leave nothing left to read. */
+        r->error = true;
+        r->cur = r->end;
+        return false;
+    }
+    return !r->error;
+}
+
+KR_INLINE void kr_serial_read_skip(struct kr_serial_reader_s *r, size_t len)
+{
+    if (kr_serial_reader_need(r, len))
+    {
+        r->cur += len;
+    }
+}
+
+KR_INLINE void kr_serial_read_bytes(struct kr_serial_reader_s *KR_RESTRICT r, void *KR_RESTRICT dest, size_t len)
+{
+    if (!kr_serial_reader_need(r, len))
+    {
+        memset(dest, 0, len);
+        return;
+    }
+    memcpy(dest, r->cur, len);
+    r->cur += len;
+}
+
+KR_INLINE uint8_t kr_serial_read_u8(struct kr_serial_reader_s *r)
+{
+    if (!kr_serial_reader_need(r, 1))
+    {
+        return 0;
+    }
+    return kr_serial_read_u8_unchecked(r);
+}
+
+KR_INLINE uint8_t kr_serial_read_u8_unchecked(struct kr_serial_reader_s *r)
+{
+    const uint8_t rvo = *r->cur;
+    r->cur += 1;
+    return rvo;
+}
+
+KR_INLINE uint16_t kr_serial_read_u16le(struct kr_serial_reader_s *r)
+{
+    if (!kr_serial_reader_need(r, 2))
+    {
+        return 0;
+    }
+    return kr_serial_read_u16le_unchecked(r);
+}
+
+KR_INLINE uint16_t kr_serial_read_u16le_unchecked(struct kr_serial_reader_s *r)
+{
+    const uint16_t rvo = kr_load_u16le(r->cur);
+    r->cur += 2;
+    return rvo;
+}
+
+KR_INLINE uint16_t kr_serial_read_u16be(struct kr_serial_reader_s *r)
+{
+    if (!kr_serial_reader_need(r, 2))
+    {
+        return 0;
+    }
+    return kr_serial_read_u16be_unchecked(r);
+}
+
+KR_INLINE uint16_t kr_serial_read_u16be_unchecked(struct kr_serial_reader_s *r)
+{
+    const uint16_t rvo = kr_load_u16be(r->cur);
+    r->cur += 2;
+    return rvo;
+}
+
+KR_INLINE uint32_t kr_serial_read_u32le(struct kr_serial_reader_s *r)
+{
+    if (!kr_serial_reader_need(r, 4))
+    {
+        return 0;
+    }
+    return kr_serial_read_u32le_unchecked(r);
+}
+
+KR_INLINE uint32_t kr_serial_read_u32le_unchecked(struct kr_serial_reader_s *r)
+{
+    const uint32_t rvo = kr_load_u32le(r->cur);
+    r->cur += 4;
+    return rvo;
+}
+
+KR_INLINE uint32_t kr_serial_read_u32be(struct kr_serial_reader_s *r)
+{
+    if (!kr_serial_reader_need(r, 4))
+    {
+        return 0;
+    }
+    return kr_serial_read_u32be_unchecked(r);
+}
+
+KR_INLINE uint32_t kr_serial_read_u32be_unchecked(struct kr_serial_reader_s *r)
+{
+    const uint32_t rvo = kr_load_u32be(r->cur);
+    r->cur += 4;
+    return rvo;
+}
+
+#if defined(UINT64_MAX)
+
+KR_INLINE uint64_t kr_serial_read_u64le(struct kr_serial_reader_s *r)
+{
+    if (!kr_serial_reader_need(r, 8))
+    {
+        return 0;
+    }
+    return kr_serial_read_u64le_unchecked(r);
+}
+
+KR_INLINE uint64_t kr_serial_read_u64le_unchecked(struct kr_serial_reader_s *r)
+{
+    const uint64_t rvo = kr_load_u64le(r->cur);
+    r->cur += 8;
+    return rvo;
+}
+
+#endif /* defined(UINT64_MAX) */
+
+#if defined(UINT64_MAX)
+
+KR_INLINE uint64_t kr_serial_read_u64be(struct kr_serial_reader_s *r)
+{
+    if (!kr_serial_reader_need(r, 8))
+    {
+        return 0;
+    }
+    return kr_serial_read_u64be_unchecked(r);
+}
+
+KR_INLINE uint64_t kr_serial_read_u64be_unchecked(struct kr_serial_reader_s *r)
+{
+    const uint64_t rvo = kr_load_u64be(r->cur);
+    r->cur += 8;
+    return rvo;
+}
+
+#endif /* defined(UINT64_MAX) */
+
+/******************************************************************************/
+
+KR_INLINE void kr_serial_writer_init(struct kr_serial_writer_s *w, void *data, size_t len)
+{
+    w->begin = KR_CASTS(unsigned char *, data);
+    w->cur = w->begin;
+    w->end = w->begin + len;
+    w->error = false;
+}
+
+KR_INLINE size_t kr_serial_writer_tell(const struct kr_serial_writer_s *w)
+{
+    return KR_CASTS(size_t, w->cur - w->begin);
+}
+
+KR_INLINE size_t kr_serial_writer_remaining(const struct kr_serial_writer_s *w)
+{
+    return KR_CASTS(size_t, w->end - w->cur);
+}
+
+KR_INLINE bool kr_serial_writer_need(struct kr_serial_writer_s *w, size_t len)
+{
+    if (len > KR_CASTS(size_t, w->end - w->cur))
+    {
+        /* Latch the error, and leave no room left to write. */
+        w->error = true;
+        w->cur = w->end;
+        return false;
+    }
+    return !w->error;
+}
+
+KR_INLINE void kr_serial_write_bytes(struct kr_serial_writer_s *KR_RESTRICT w, const void *KR_RESTRICT src, size_t len)
+{
+    if (kr_serial_writer_need(w, len))
+    {
+        memcpy(w->cur, src, len);
+        w->cur += len;
+    }
+}
+
+KR_INLINE void kr_serial_write_u8(struct kr_serial_writer_s *w, uint8_t src)
+{
+    if (kr_serial_writer_need(w, 1))
+    {
+        kr_serial_write_u8_unchecked(w, src);
+    }
+}
+
+KR_INLINE void kr_serial_write_u8_unchecked(struct kr_serial_writer_s *w, uint8_t src)
+{
+    *w->cur = src;
+    w->cur += 1;
+}
+
+KR_INLINE void kr_serial_write_u16le(struct kr_serial_writer_s *w, uint16_t src)
+{
+    if (kr_serial_writer_need(w, 2))
+    {
+        kr_serial_write_u16le_unchecked(w, src);
+    }
+}
+
+KR_INLINE void kr_serial_write_u16le_unchecked(struct kr_serial_writer_s *w, uint16_t src)
+{
+    kr_store_u16le(w->cur, src);
+    w->cur += 2;
+}
+
+KR_INLINE void kr_serial_write_u16be(struct kr_serial_writer_s *w, uint16_t src)
+{
+    if (kr_serial_writer_need(w, 2))
+    {
+        kr_serial_write_u16be_unchecked(w, src);
+    }
+}
+
+KR_INLINE void kr_serial_write_u16be_unchecked(struct kr_serial_writer_s *w, uint16_t src)
+{
+    kr_store_u16be(w->cur, src);
+    w->cur += 2;
+}
+
+KR_INLINE void kr_serial_write_u32le(struct kr_serial_writer_s *w, uint32_t src)
+{
+    if (kr_serial_writer_need(w, 4))
+    {
+        kr_serial_write_u32le_unchecked(w, src);
+    }
+}
+
+KR_INLINE void kr_serial_write_u32le_unchecked(struct kr_serial_writer_s *w, uint32_t src)
+{
+    kr_store_u32le(w->cur, src);
+    w->cur += 4;
+}
+
+KR_INLINE void kr_serial_write_u32be(struct kr_serial_writer_s *w, uint32_t src)
+{
+    if (kr_serial_writer_need(w, 4))
+    {
+        kr_serial_write_u32be_unchecked(w, src);
+    }
+}
+
+KR_INLINE void kr_serial_write_u32be_unchecked(struct kr_serial_writer_s *w, uint32_t src)
+{
+    kr_store_u32be(w->cur, src);
+    w->cur += 4;
+}
+
+#if defined(UINT64_MAX)
+
+KR_INLINE void kr_serial_write_u64le(struct kr_serial_writer_s *w, uint64_t src)
+{
+    if (kr_serial_writer_need(w, 8))
+    {
+        kr_serial_write_u64le_unchecked(w, src);
+    }
+}
+
+KR_INLINE void kr_serial_write_u64le_unchecked(struct kr_serial_writer_s *w, uint64_t src)
+{
+    kr_store_u64le(w->cur, src);
+    w->cur += 8;
+}
+
+#endif /* defined(UINT64_MAX) */
+
+#if defined(UINT64_MAX)
+
+KR_INLINE void kr_serial_write_u64be(struct kr_serial_writer_s *w, uint64_t src)
+{
+    if (kr_serial_writer_need(w, 8))
+    {
+        kr_serial_write_u64be_unchecked(w, src);
+    }
+}
+
+KR_INLINE void kr_serial_write_u64be_unchecked(struct kr_serial_writer_s *w, uint64_t src)
+{
+    kr_store_u64be(w->cur, src);
+    w->cur += 8;
+}
+
+#endif /* defined(UINT64_MAX) */
+
+/******************************************************************************/
+
+KR_CONSTEXPR uint32_t kr_zigzag_encode32(int32_t x)
+{
+    const uint32_t u = KR_CASTS(uint32_t, x);
+    return (u << 1) ^ (0 - (u >> 31));
+}
+
+KR_CONSTEXPR int32_t kr_zigzag_decode32(uint32_t x)
+{
+    return KR_CASTS(int32_t, (x >> 1) ^ (0 - (x & 1)));
+}
+
+#if defined(UINT64_MAX)
+
+KR_CONSTEXPR uint64_t kr_zigzag_encode64(int64_t x)
+{
+    const uint64_t u = KR_CASTS(uint64_t, x);
+    return (u << 1) ^ (0 - (u >> 63));
+}
+
+KR_CONSTEXPR int64_t kr_zigzag_decode64(uint64_t x)
+{
+    return KR_CASTS(int64_t, (x >> 1) ^ (0 - (x & 1)));
+}
+
+/******************************************************************************/
+
+KR_INLINE size_t kr_store_uleb128(void *dest, uint64_t src)
+{
+    unsigned char *out = KR_CASTS(unsigned char *, dest);
+    size_t i = 0;
+
+    for (; src >= 0x80; src >>= 7)
+    {
+        out[i++] = KR_CASTS(unsigned char, src | 0x80);
+    }
+    out[i++] = KR_CASTS(unsigned char, src);
+    return i;
+}
+
+KR_INLINE size_t kr_store_sleb128(void *dest, int64_t src)
+{
+    unsigned char *out = KR_CASTS(unsigned char *, dest);
+    uint64_t u = KR_CASTS(uint64_t, src);
+    const uint64_t sign = src < 0 ? ~(UINT64_MAX >> 7) : 0;
+    unsigned char byte = 0;
+    size_t i = 0;
+
+    for (;;)
+    {
+        /* Shift right, filling with the sign bit. */
+        byte = KR_CASTS(unsigned char, u & 0x7f);
+        u = (u >> 7) | sign;
+        if ((u == 0 && (byte & 0x40) == 0) || (u == UINT64_MAX && (byte & 0x40) != 0))
+        {
+            out[i++] = byte;
+            return i;
+        }
+        out[i++] = KR_CASTS(unsigned char, byte | 0x80);
+    }
+}
+
+KR_INLINE size_t kr_store_pvarint(void *dest, uint64_t src)
+{
+    unsigned char *out = KR_CASTS(unsigned char *, dest);
+    unsigned char tmp[8];
+    const int bits = 64 - kr_clz64(src | 1);
+    const size_t len = KR_CASTS(size_t, (bits - 1) / 7 + 1);
+
+    if (len > 8)
+    {
+        out[0] = 0xFF;
+        kr_store_u64be(out + 1, src);
+        return 9;
+    }
+
+    /* The top len bytes of a big-endian word, with len - 1 one bits and a
+     * zero bit marking the length in front of the value. */
+    src |= ((UINT64_C(0xFF) << (9 - len)) & 0xFF) << (8 * (len - 1));
+    kr_store_u64be(tmp, src << (64 - 8 * len));
+    memcpy(out, tmp, len);
+    return len;
+}
+
+/******************************************************************************/
+
+KR_INLINE size_t kr_load_uleb128(const void *src, size_t len, uint64_t *dest)
+{
+    const unsigned char *in = KR_CASTS(const unsigned char *, src);
+    uint64_t rvo = 0;
+    size_t i = 0;
+
+    for (i = 0; i < len && i < KR_LEB128_MAXLEN; i++)
+    {
+        if (i == KR_LEB128_MAXLEN - 1 && in[i] > 0x01)
+        {
+            /* The last byte only has room for bit 63. */
+            return 0;
+        }
+
+        rvo |= KR_CASTS(uint64_t, in[i] & 0x7f) << (7 * i);
+        if ((in[i] & 0x80) == 0)
+        {
+            *dest = rvo;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+KR_INLINE size_t kr_load_sleb128(const void *src, size_t len, int64_t *dest)
+{
+    const unsigned char *in = KR_CASTS(const unsigned char *, src);
+    uint64_t rvo = 0;
+    size_t i = 0;
+
+    for (i = 0; i < len && i < KR_LEB128_MAXLEN; i++)
+    {
+        if (i == KR_LEB128_MAXLEN - 1 && in[i] != 0x00 && in[i] != 0x7f)
+        {
+            /* The last byte only has room for bit 63, and the bits above it
+             * must be copies of it. */
+            return 0;
+        }
+
+        rvo |= KR_CASTS(uint64_t, in[i] & 0x7f) << (7 * i);
+        if ((in[i] & 0x80) == 0)
+        {
+            if ((in[i] & 0x40) != 0 && i < 9)
+            {
+                /* Sign extend. */
+                rvo |= UINT64_MAX << (7 * (i + 1));
+            }
+            *dest = KR_CASTS(int64_t, rvo);
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+KR_INLINE size_t kr_load_pvarint(const void *src, size_t len, uint64_t *dest)
+{
+    const unsigned char *in = KR_CASTS(const unsigned char *, src);
+    unsigned char tmp[8];
+    size_t need = 0;
+    uint64_t word = 0;
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    /* Leading ones of the first byte are the length, and eight of them
+     * mean a whole word follows. */
+    need = KR_CASTS(size_t, kr_clz32(KR_CASTS(uint32_t, ~in[0] & 0xFF) << 24)) + 1;
+    need = need > 8 ? 9 : need;
+    if (need > len)
+    {
+        return 0;
+    }
+    if (need > 8)
+    {
+        *dest = kr_load_u64be(in + 1);
+        return 9;
+    }
+
+    if (len >= 8)
+    {
+        word = kr_load_u64be(in);
+    }
+    else
+    {
+        memset(tmp, 0, sizeof(tmp));
+        memcpy(tmp, in, need);
+        word = kr_load_u64be(tmp);
+    }
+
+    /* Keep the top need bytes, then drop the length bits. */
+    *dest = (word >> (64 - 8 * need)) & (UINT64_MAX >> (64 - 7 * need));
+    return need;
+}
+
+/******************************************************************************/
+
+KR_INLINE size_t kr_load_uleb128_array(uint64_t *dest, size_t n, const void *src, size_t len, size_t *used)
+{
+    const unsigned char *in = KR_CASTS(const unsigned char *, src);
+    size_t i = 0, pos = 0, res = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        if (pos < len && in[pos] < 0x80)
+        {
+            /* Small values are the common case. */
+            dest[i] = in[pos++];
+            continue;
+        }
+
+        res = kr_load_uleb128(in + pos, len - pos, dest + i);
+        if (res == 0)
+        {
+            break;
+        }
+        pos += res;
+    }
+
+    *used = pos;
+    return i;
+}
+
+KR_INLINE size_t kr_load_pvarint_array(uint64_t *dest, size_t n, const void *src, size_t len, size_t *used)
+{
+    const unsigned char *in = KR_CASTS(const unsigned char *, src);
+    size_t i = 0, pos = 0, need = 0, res = 0;
+
+    /* While a whole word can be read, no length checks are needed. */
+    for (i = 0; i < n && pos + KR_PVARINT_MAXLEN <= len; i++)
+    {
+        if (in[pos] < 0x80)
+        {
+            /* Small values are the common case. */
+            dest[i] = in[pos++];
+            continue;
+        }
+
+        need = KR_CASTS(size_t, kr_clz32(KR_CASTS(uint32_t, ~in[pos] & 0xFF) << 24)) + 1;
+        if (need > 8)
+        {
+            dest[i] = kr_load_u64be(in + pos + 1);
+            pos += 9;
+            continue;
+        }
+        dest[i] = (kr_load_u64be(in + pos) >> (64 - 8 * need)) & (UINT64_MAX >> (64 - 7 * need));
+        pos += need;
+    }
+
+    for (; i < n; i++)
+    {
+        res = kr_load_pvarint(in + pos, len - pos, dest + i);
+        if (res == 0)
+        {
+            break;
+        }
+        pos += res;
+    }
+
+    *used = pos;
+    return i;
+}
+
+#endif /* defined(UINT64_MAX) */
+
 #endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
 
 #endif /* !defined(KRSERIAL_H) */
@@ -0,0 +1,616 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/*
+ * Vectorized string functions.
+ *
+ * These have the same semantics as their counterparts in krstr.h, which
+ * remain the reference implementations.  The instruction set is picked at
+ * compile time using the KR_AVX2, KR_SSE2 and KR_NEON detection in
+ * krconfig.h.  If none are available, kr_simd_strlen and kr_simd_strnlen
+ * scan a word at a time with kr_strlen_swar and kr_strnlen_swar, and the
+ * rest call their krstr.h counterparts.
+ * With KR_CPU_DISPATCH, kr_simd_strlen and kr_simd_strnlen also use AVX2 if
+ * the running CPU supports it.
+ *
+ * Like krbit.h, this header is allowed to break the "no cleverness" rule.
+ * Every kernel is written once against a handful of vector primitives, so
+ * porting to another instruction set only means porting the primitives.
+ *
+ * Functions that scan NUL-terminated strings read whole aligned vectors, so
+ * they may read bytes past the terminator but never past the aligned vector
+ * that contains it, and thus never across a page boundary.
+ */
+
+#if !defined(KRSIMD_H)
+#define KRSIMD_H
+
+#include "./krconfig.h"
+
+#include "./krbltin.h"
+#include "./krcpu.h"
+#include "./krint.h"
+#include "./krstr.h"
+
+#if (KR_AVX2) || (KR_CPU_DISPATCH)
+#include <immintrin.h>
+#elif (KR_SSE2)
+#include <emmintrin.h>
+#elif (KR_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Vectorized kr_strlen.
+ */
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strlen(const char *str);
+
+/**
+ * @brief Vectorized kr_strnlen.
+ *
+ * @details Never reads an aligned vector that does not contain at least
+ *          one byte inside of the first len bytes.
+ */
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strnlen(const char *str, size_t len);
+
+/**
+ * @brief Vectorized kr_strspn.
+ *
+ * @details Compares every vector against every character of `chars`, so
+ *          this falls back to kr_strspn if there are more than 16 of them.
+ */
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strspn(const char *str, const char *chars);
+
+/**
+ * @brief Vectorized kr_strcspn.
+ *
+ * @details Compares every vector against every character of `chars`, so
+ *          this falls back to kr_strcspn if there are more than 16 of them.
+ */
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strcspn(const char *str, const char *chars);
+
+/**
+ * @brief Vectorized kr_memccpy.
+ *
+ * @details Uses unaligned loads and never reads past src + destLen.
+ */
+KR_INLINE void *kr_simd_memccpy(void *KR_RESTRICT dest, const void *KR_RESTRICT src, int ch, size_t destLen);
+
+/**
+ * @brief Vectorized kr_strcmp.
+ *
+ * @details Uses unaligned loads, but compares bytewise whenever a load
+ *          could cross into the next 4KiB page.
+ */
+KR_NOSANITIZE_ADDRESS KR_INLINE int kr_simd_strcmp(const char *lhs, const char *rhs);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/*
+ * Vector primitives.  A bitmask has KR_SIMD_LANEBITS_ bits for every byte of
+ * a vector, lowest address in the lowest bits.
+ */
+
+#if (KR_AVX2)
+
+#define KR_SIMD_WIDTH_ (32)
+#define KR_SIMD_LANEBITS_ (1)
+
+typedef __m256i kr_simd_vec_detail_;
+typedef uint32_t kr_simd_bits_detail_;
+
+KR_NOSANITIZE_ADDRESS KR_INLINE kr_simd_vec_detail_ kr_simd_load_detail_(const void *p)
+{
+    return _mm256_load_si256(KR_CASTS(const __m256i *, p));
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE kr_simd_vec_detail_ kr_simd_loadu_detail_(const void *p)
+{
+    return _mm256_loadu_si256(KR_CASTS(const __m256i *, p));
+}
+
+KR_INLINE void kr_simd_storeu_detail_(void *p, kr_simd_vec_detail_ v)
+{
+    _mm256_storeu_si256(KR_CASTS(__m256i *, p), v);
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_splat_detail_(unsigned char ch)
+{
+    return _mm256_set1_epi8(KR_CASTS(char, ch));
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_eq_detail_(kr_simd_vec_detail_ a, kr_simd_vec_detail_ b)
+{
+    return _mm256_cmpeq_epi8(a, b);
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_or_detail_(kr_simd_vec_detail_ a, kr_simd_vec_detail_ b)
+{
+    return _mm256_or_si256(a, b);
+}
+
+KR_INLINE kr_simd_bits_detail_ kr_simd_mask_detail_(kr_simd_vec_detail_ v)
+{
+    return KR_CASTS(uint32_t, _mm256_movemask_epi8(v));
+}
+
+KR_INLINE size_t kr_simd_index_detail_(kr_simd_bits_detail_ m)
+{
+    return KR_CASTS(size_t, kr_ctz32(m));
+}
+
+#elif (KR_SSE2)
+
+#define KR_SIMD_WIDTH_ (16)
+#define KR_SIMD_LANEBITS_ (1)
+
+typedef __m128i kr_simd_vec_detail_;
+typedef uint32_t kr_simd_bits_detail_;
+
+KR_NOSANITIZE_ADDRESS KR_INLINE kr_simd_vec_detail_ kr_simd_load_detail_(const void *p)
+{
+    return _mm_load_si128(KR_CASTS(const __m128i *, p));
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE kr_simd_vec_detail_ kr_simd_loadu_detail_(const void *p)
+{
+    return _mm_loadu_si128(KR_CASTS(const __m128i *, p));
+}
+
+KR_INLINE void kr_simd_storeu_detail_(void *p, kr_simd_vec_detail_ v)
+{
+    _mm_storeu_si128(KR_CASTS(__m128i *, p), v);
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_splat_detail_(unsigned char ch)
+{
+    return _mm_set1_epi8(KR_CASTS(char, ch));
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_eq_detail_(kr_simd_vec_detail_ a, kr_simd_vec_detail_ b)
+{
+    return _mm_cmpeq_epi8(a, b);
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_or_detail_(kr_simd_vec_detail_ a, kr_simd_vec_detail_ b)
+{
+    return _mm_or_si128(a, b);
+}
+
+KR_INLINE kr_simd_bits_detail_ kr_simd_mask_detail_(kr_simd_vec_detail_ v)
+{
+    return KR_CASTS(uint32_t, _mm_movemask_epi8(v));
+}
+
+KR_INLINE size_t kr_simd_index_detail_(kr_simd_bits_detail_ m)
+{
+    return KR_CASTS(size_t, kr_ctz32(m));
+}
+
+#elif (KR_NEON)
+
+#define KR_SIMD_WIDTH_ (16)
+#define KR_SIMD_LANEBITS_ (4)
+
+typedef uint8x16_t kr_simd_vec_detail_;
+typedef uint64_t kr_simd_bits_detail_;
+
+KR_NOSANITIZE_ADDRESS KR_INLINE kr_simd_vec_detail_ kr_simd_load_detail_(const void *p)
+{
+    return vld1q_u8(KR_CASTS(const uint8_t *, p));
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE kr_simd_vec_detail_ kr_simd_loadu_detail_(const void *p)
+{
+    return vld1q_u8(KR_CASTS(const uint8_t *, p));
+}
+
+KR_INLINE void kr_simd_storeu_detail_(void *p, kr_simd_vec_detail_ v)
+{
+    vst1q_u8(KR_CASTS(uint8_t *, p), v);
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_splat_detail_(unsigned char ch)
+{
+    return vdupq_n_u8(ch);
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_eq_detail_(kr_simd_vec_detail_ a, kr_simd_vec_detail_ b)
+{
+    return vceqq_u8(a, b);
+}
+
+KR_INLINE kr_simd_vec_detail_ kr_simd_or_detail_(kr_simd_vec_detail_ a, kr_simd_vec_detail_ b)
+{
+    return vorrq_u8(a, b);
+}
+
+/*
+ * NEON has no movemask, but narrowing every 16-bit lane by four bits
+ * leaves a nibble per byte that fits inside of a 64-bit scalar.
+ *
+ * https://community.arm.com/arm-community-blogs/b/infrastructure-solutions-blog/posts/porting-x86-vector-bitmask-optimizations-to-arm-neon
+ */
+KR_INLINE kr_simd_bits_detail_ kr_simd_mask_detail_(kr_simd_vec_detail_ v)
+{
+    uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+}
+
+KR_INLINE size_t kr_simd_index_detail_(kr_simd_bits_detail_ m)
+{
+    return KR_CASTS(size_t, kr_ctz64(m)) >> 2;
+}
+
+#endif
+
+/******************************************************************************/
+
+#if !(KR_AVX2) && (KR_CPU_DISPATCH)
+
+/*
+ * AVX2 versions of the length functions for runtime dispatch, for when the
+ * vector primitives above were picked for an older instruction set.
+ */
+
+KR_CPU_TARGET("avx2") KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strlen_avx2_detail_(const char *str)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const size_t skip = KR_CASTR(uintptr_t, str) % 32;
+    const char *p = str - skip;
+    uint32_t mask = 0;
+
+    mask = KR_CASTS(uint32_t, _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(KR_CASTR(const __m256i *, p)),
+                                                                      zero)));
+    mask >>= skip;
+    if (mask != 0)
+    {
+        return KR_CASTS(size_t, kr_ctz32(mask));
+    }
+
+    for (;;)
+    {
+        p += 32;
+        mask = KR_CASTS(uint32_t,
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(KR_CASTR(const __m256i *, p)), zero)));
+        if (mask != 0)
+        {
+            return KR_CASTS(size_t, p - str) + KR_CASTS(size_t, kr_ctz32(mask));
+        }
+    }
+}
+
+KR_CPU_TARGET("avx2") KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strnlen_avx2_detail_(const char *str, size_t len)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const size_t skip = KR_CASTR(uintptr_t, str) % 32;
+    const char *p = str - skip;
+    uint32_t mask = 0;
+    size_t pos = 0;
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    mask = KR_CASTS(uint32_t, _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(KR_CASTR(const __m256i *, p)),
+                                                                      zero)));
+    mask >>= skip;
+    if (mask != 0)
+    {
+        pos = KR_CASTS(size_t, kr_ctz32(mask));
+        return pos < len ? pos : len;
+    }
+
+    for (p += 32; KR_CASTS(size_t, p - str) < len; p += 32)
+    {
+        mask = KR_CASTS(uint32_t,
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(KR_CASTR(const __m256i *, p)), zero)));
+        if (mask != 0)
+        {
+            pos = KR_CASTS(size_t, p - str) + KR_CASTS(size_t, kr_ctz32(mask));
+            return pos < len ? pos : len;
+        }
+    }
+
+    return len;
+}
+
+#endif /* !(KR_AVX2) && (KR_CPU_DISPATCH) */
+
+/******************************************************************************/
+
+#if defined(KR_SIMD_WIDTH_)
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strlen(const char *str)
+{
+    const kr_simd_vec_detail_ zero = kr_simd_splat_detail_(0);
+    const size_t skip = KR_CASTR(uintptr_t, str) % KR_SIMD_WIDTH_;
+    const char *p = str - skip;
+    kr_simd_bits_detail_ mask = 0;
+
+#if !(KR_AVX2) && (KR_CPU_DISPATCH)
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        return kr_simd_strlen_avx2_detail_(str);
+    }
+#endif
+
+    /* The first aligned vector can contain bytes from before the string. */
+    mask = kr_simd_mask_detail_(kr_simd_eq_detail_(kr_simd_load_detail_(p), zero));
+    mask >>= skip * KR_SIMD_LANEBITS_;
+    if (mask != 0)
+    {
+        return kr_simd_index_detail_(mask);
+    }
+
+    for (;;)
+    {
+        p += KR_SIMD_WIDTH_;
+        mask = kr_simd_mask_detail_(kr_simd_eq_detail_(kr_simd_load_detail_(p), zero));
+        if (mask != 0)
+        {
+            return KR_CASTS(size_t, p - str) + kr_simd_index_detail_(mask);
+        }
+    }
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strnlen(const char *str, size_t len)
+{
+    const kr_simd_vec_detail_ zero = kr_simd_splat_detail_(0);
+    const size_t skip = KR_CASTR(uintptr_t, str) % KR_SIMD_WIDTH_;
+    const char *p = str - skip;
+    kr_simd_bits_detail_ mask = 0;
+    size_t pos = 0;
+
+#if !(KR_AVX2) && (KR_CPU_DISPATCH)
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        return kr_simd_strnlen_avx2_detail_(str, len);
+    }
+#endif
+
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    /* The first aligned vector can contain bytes from before the string. */
+    mask = kr_simd_mask_detail_(kr_simd_eq_detail_(kr_simd_load_detail_(p), zero));
+    mask >>= skip * KR_SIMD_LANEBITS_;
+    if (mask != 0)
+    {
+        pos = kr_simd_index_detail_(mask);
+        return pos < len ? pos : len;
+    }
+
+    /* Only load vectors that start inside of the first len bytes. */
+    for (p += KR_SIMD_WIDTH_; KR_CASTS(size_t, p - str) < len; p += KR_SIMD_WIDTH_)
+    {
+        mask = kr_simd_mask_detail_(kr_simd_eq_detail_(kr_simd_load_detail_(p), zero));
+        if (mask != 0)
+        {
+            pos = KR_CASTS(size_t, p - str) + kr_simd_index_detail_(mask);
+            return pos < len ? pos : len;
+        }
+    }
+
+    return len;
+}
+
+/******************************************************************************/
+
+/*
+ * Both span functions build a mask of bytes that are in `chars`, then look
+ * for the first byte that stops the span.  The null terminator can never be
+ * in `chars`, so it stops kr_simd_strspn for free.
+ */
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strspn(const char *str, const char *chars)
+{
+    const kr_simd_vec_detail_ zero = kr_simd_splat_detail_(0);
+    size_t skip = KR_CASTR(uintptr_t, str) % KR_SIMD_WIDTH_;
+    const char *p = str - skip;
+    kr_simd_vec_detail_ set[16];
+    kr_simd_vec_detail_ v, found;
+    kr_simd_bits_detail_ mask = 0;
+    size_t count = kr_strnlen(chars, 17);
+    size_t i = 0;
+
+    if (count > 16)
+    {
+        return kr_strspn(str, chars);
+    }
+    else if (count == 0)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        set[i] = kr_simd_splat_detail_(KR_CASTS(unsigned char, chars[i]));
+    }
+
+    for (;; p += KR_SIMD_WIDTH_, skip = 0)
+    {
+        v = kr_simd_load_detail_(p);
+        found = kr_simd_eq_detail_(v, set[0]);
+        for (i = 1; i < count; i++)
+        {
+            found = kr_simd_or_detail_(found, kr_simd_eq_detail_(v, set[i]));
+        }
+
+        /* The first aligned vector can contain bytes from before the string. */
+        mask = kr_simd_mask_detail_(kr_simd_eq_detail_(found, zero)) >> (skip * KR_SIMD_LANEBITS_);
+        if (mask != 0)
+        {
+            return KR_CASTS(size_t, p + skip - str) + kr_simd_index_detail_(mask);
+        }
+    }
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strcspn(const char *str, const char *chars)
+{
+    const kr_simd_vec_detail_ zero = kr_simd_splat_detail_(0);
+    size_t skip = KR_CASTR(uintptr_t, str) % KR_SIMD_WIDTH_;
+    const char *p = str - skip;
+    kr_simd_vec_detail_ set[16];
+    kr_simd_vec_detail_ v, found;
+    kr_simd_bits_detail_ mask = 0;
+    size_t count = kr_strnlen(chars, 17);
+    size_t i = 0;
+
+    if (count > 16)
+    {
+        return kr_strcspn(str, chars);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        set[i] = kr_simd_splat_detail_(KR_CASTS(unsigned char, chars[i]));
+    }
+
+    for (;; p += KR_SIMD_WIDTH_, skip = 0)
+    {
+        v = kr_simd_load_detail_(p);
+        found = kr_simd_eq_detail_(v, zero);
+        for (i = 0; i < count; i++)
+        {
+            found = kr_simd_or_detail_(found, kr_simd_eq_detail_(v, set[i]));
+        }
+
+        /* The first aligned vector can contain bytes from before the string. */
+        mask = kr_simd_mask_detail_(found) >> (skip * KR_SIMD_LANEBITS_);
+        if (mask != 0)
+        {
+            return KR_CASTS(size_t, p + skip - str) + kr_simd_index_detail_(mask);
+        }
+    }
+}
+
+/******************************************************************************/
+
+KR_INLINE void *kr_simd_memccpy(void *KR_RESTRICT dest, const void *KR_RESTRICT src, int ch, size_t destLen)
+{
+    const kr_simd_vec_detail_ needle = kr_simd_splat_detail_(KR_CASTS(unsigned char, ch));
+    unsigned char *destCh = KR_CASTS(unsigned char *, dest);
+    const unsigned char *curCh = KR_CASTS(const unsigned char *, src);
+    kr_simd_vec_detail_ v;
+    kr_simd_bits_detail_ mask = 0;
+    size_t i = 0;
+
+    for (; destLen >= KR_SIMD_WIDTH_; destCh += KR_SIMD_WIDTH_, curCh += KR_SIMD_WIDTH_, destLen -= KR_SIMD_WIDTH_)
+    {
+        v = kr_simd_loadu_detail_(curCh);
+        mask = kr_simd_mask_detail_(kr_simd_eq_detail_(v, needle));
+        if (mask != 0)
+        {
+            i = kr_simd_index_detail_(mask) + 1;
+            memcpy(destCh, curCh, i);
+            return KR_CASTS(void *, destCh + i);
+        }
+        kr_simd_storeu_detail_(destCh, v);
+    }
+
+    return kr_memccpy(destCh, curCh, ch, destLen);
+}
+
+/******************************************************************************/
+
+KR_NOSANITIZE_ADDRESS KR_INLINE int kr_simd_strcmp(const char *lhs, const char *rhs)
+{
+    const kr_simd_vec_detail_ zero = kr_simd_splat_detail_(0);
+    const size_t lastLoad = 4096 - KR_SIMD_WIDTH_;
+    kr_simd_vec_detail_ l, r, stop;
+    kr_simd_bits_detail_ mask = 0;
+    size_t i = 0;
+
+    for (;; lhs += KR_SIMD_WIDTH_, rhs += KR_SIMD_WIDTH_)
+    {
+        if (KR_CASTR(uintptr_t, lhs) % 4096 > lastLoad || KR_CASTR(uintptr_t, rhs) % 4096 > lastLoad)
+        {
+            /* A load could cross a page, compare this stretch bytewise. */
+            for (i = 0; i < KR_SIMD_WIDTH_; i++)
+            {
+                if (lhs[i] != rhs[i] || lhs[i] == '\0')
+                {
+                    return KR_CASTS(unsigned char, lhs[i]) - KR_CASTS(unsigned char, rhs[i]);
+                }
+            }
+            continue;
+        }
+
+        /* Stop at the first byte that differs or ends the string. */
+        l = kr_simd_loadu_detail_(lhs);
+        r = kr_simd_loadu_detail_(rhs);
+        stop = kr_simd_or_detail_(kr_simd_eq_detail_(kr_simd_eq_detail_(l, r), zero), kr_simd_eq_detail_(l, zero));
+        mask = kr_simd_mask_detail_(stop);
+        if (mask != 0)
+        {
+            i = kr_simd_index_detail_(mask);
+            return KR_CASTS(unsigned char, lhs[i]) - KR_CASTS(unsigned char, rhs[i]);
+        }
+    }
+}
+
+#else /* defined(KR_SIMD_WIDTH_) */
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strlen(const char *str)
+{
+#if !(KR_AVX2) && (KR_CPU_DISPATCH)
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        return kr_simd_strlen_avx2_detail_(str);
+    }
+#endif
+
+    return kr_strlen_swar(str);
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strnlen(const char *str, size_t len)
+{
+#if !(KR_AVX2) && (KR_CPU_DISPATCH)
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        return kr_simd_strnlen_avx2_detail_(str, len);
+    }
+#endif
+
+    return kr_strnlen_swar(str, len);
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strspn(const char *str, const char *chars)
+{
+    return kr_strspn(str, chars);
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_simd_strcspn(const char *str, const char *chars)
+{
+    return kr_strcspn(str, chars);
+}
+
+KR_INLINE void *kr_simd_memccpy(void *KR_RESTRICT dest, const void *KR_RESTRICT src, int ch, size_t destLen)
+{
+    return kr_memccpy(dest, src, ch, destLen);
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE int kr_simd_strcmp(const char *lhs, const char *rhs)
+{
+    return kr_strcmp(lhs, rhs);
+}
+
+#endif /* defined(KR_SIMD_WIDTH_) */
+
+#undef KR_SIMD_WIDTH_
+#undef KR_SIMD_LANEBITS_
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRSIMD_H) */
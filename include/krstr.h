@@ -11,6 +11,9 @@
 
 #include "./krconfig.h"
 
+#include "./krbool.h"
+#include "./krint.h"
+
 #if (!KR_CONFIG_NOINCLUDE)
 #include <stddef.h>
 #include <stdlib.h>
@@ -35,6 +38,35 @@ KR_CONSTEXPR size_t kr_strlen(const char *str);
  */
 KR_CONSTEXPR size_t kr_strnlen(const char *str, size_t len);
 
+/**
+ * @brief Get length of string, scanning a machine word at a time.
+ *
+ * @details Exists because a bytewise loop is several times slower than libc
+ *          on long strings.  Reads whole aligned words, so it may touch
+ *          bytes past the terminator, but never past the aligned word that
+ *          contains it.  kr_strlen calls this if KR_CONFIG_SWARSTR is set.
+ *
+ * @link https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
+ *
+ * @param str String to calculate length of.
+ * @return Number of characters in string, not including the null terminator.
+ */
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_strlen_swar(const char *str);
+
+/**
+ * @brief Get length of string up to a certain length, scanning a machine
+ *        word at a time.
+ *
+ * @details See kr_strlen_swar.  Never reads an aligned word that does not
+ *          contain at least one byte inside of the first len bytes.
+ *
+ * @param str String to calculate length of.
+ * @param len Number of bytes to check.
+ * @return Number of characters in string, or len if null terminator was
+ *         not found.
+ */
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_strnlen_swar(const char *str, size_t len);
+
 /**
  * @brief Compare strings lexographically.
  *
@@ -144,6 +176,214 @@ KR_CONSTEXPR size_t kr_strcspn(const char *str, const char *chars);
  */
 KR_CONSTEXPR char *kr_strtok_r(char *KR_RESTRICT str, const char *KR_RESTRICT delim, char **KR_RESTRICT ptr);
 
+/**
+ * @brief A set of characters, one bit per possible value of unsigned char.
+ *
+ * @details Checking a character against a set takes constant time no matter
+ *          how many characters are in it, unlike passing a string of
+ *          characters to kr_strspn and friends.
+ */
+struct kr_charset_s
+{
+    unsigned char bits[(UCHAR_MAX + 1) / CHAR_BIT];
+};
+
+/**
+ * @brief Remove all characters from a set.
+ *
+ * @param set Set to clear.
+ */
+KR_CONSTEXPR void kr_charset_clear(struct kr_charset_s *set);
+
+/**
+ * @brief Add a single character to a set.
+ *
+ * @param set Set to add to.
+ * @param ch Character to add.
+ */
+KR_CONSTEXPR void kr_charset_add(struct kr_charset_s *set, char ch);
+
+/**
+ * @brief Add every character in a string to a set.
+ *
+ * @param set Set to add to.
+ * @param chars Characters to add.  The null terminator is not added.
+ */
+KR_CONSTEXPR void kr_charset_addstr(struct kr_charset_s *set, const char *chars);
+
+/**
+ * @brief Create a set containing every character in a string.
+ *
+ * @details Can build a set at compile time when KR_CONSTEXPR is constexpr,
+ *          for example: `static constexpr kr_charset_s s = kr_charset_make(",;");`
+ *
+ * @param chars Characters to add.  The null terminator is not added.
+ * @return A new set.
+ */
+KR_CONSTEXPR struct kr_charset_s kr_charset_make(const char *chars);
+
+/**
+ * @brief Check if a character is in a set.
+ *
+ * @param set Set to check.
+ * @param ch Character to check for.
+ * @return true if the character is in the set, otherwise false.
+ */
+KR_CONSTEXPR bool kr_charset_has(const struct kr_charset_s *set, char ch);
+
+/**
+ * @brief kr_strspn, but with a precomputed set of characters.
+ *
+ * @param str String to check.
+ * @param set Characters to check for.
+ * @return Length of substring that consists only of `set` characters.
+ */
+KR_CONSTEXPR size_t kr_strspn_set(const char *str, const struct kr_charset_s *set);
+
+/**
+ * @brief kr_strcspn, but with a precomputed set of characters.
+ *
+ * @param str String to check.
+ * @param set Characters to check for.
+ * @return Length of substring that does not consist of `set` characters.
+ */
+KR_CONSTEXPR size_t kr_strcspn_set(const char *str, const struct kr_charset_s *set);
+
+/**
+ * @brief kr_strtok_r, but with a precomputed set of delimiters.
+ *
+ * @param str String to start the scan inside.  Must be NULL on all calls
+ *            after the first if multiple tokens are desired.
+ * @param delim A set of characters that split tokens.
+ * @param ptr Pointer to context pointer.  If multiple tokens are desired,
+ *            this parameter must not change across multiple calls.
+ * @return A token found inside the scanned string, or NULL if no more tokens
+ *         were found.
+ */
+KR_CONSTEXPR char *kr_strtok_set_r(char *KR_RESTRICT str, const struct kr_charset_s *KR_RESTRICT delim,
+                                   char **KR_RESTRICT ptr);
+
+/**
+ * @brief A non-owning view of a string with a known length.
+ *
+ * @details A view does not need to be null-terminated, so it can point at a
+ *          slice of a larger buffer without patching in a terminator, and
+ *          functions that take a view never have to measure it.
+ */
+struct kr_strview_s
+{
+    const char *data;
+    size_t len;
+};
+
+/**
+ * @brief Create a view from a pointer and length.
+ *
+ * @param data Start of string.  Does not need to be null-terminated.
+ * @param len Length of string.
+ * @return A new view.
+ */
+KR_CONSTEXPR struct kr_strview_s kr_strview_make(const char *data, size_t len);
+
+/**
+ * @brief Create a view of an entire null-terminated string.
+ *
+ * @param str String to view.
+ * @return A new view, not including the null terminator.
+ */
+KR_CONSTEXPR struct kr_strview_s kr_strview_from(const char *str);
+
+/**
+ * @brief Create a view of part of another view.
+ *
+ * @param view View to slice.
+ * @param pos Starting position.  Clamped to the length of the view.
+ * @param len Maximum length of the result.  Clamped to the end of the view.
+ * @return A new view.
+ */
+KR_CONSTEXPR struct kr_strview_s kr_strview_sub(struct kr_strview_s view, size_t pos, size_t len);
+
+/**
+ * @brief Compare views lexographically.
+ *
+ * @param lhs First view to compare.
+ * @param rhs Second view to compare.
+ * @return 0 if identical, <0 if lhs comes before rhs, >0 if rhs comes before
+ *         lhs.  A view that is a prefix of another view comes first.
+ */
+KR_CONSTEXPR int kr_strview_cmp(struct kr_strview_s lhs, struct kr_strview_s rhs);
+
+/**
+ * @brief Check if two views contain the same characters.
+ *
+ * @param lhs First view to compare.
+ * @param rhs Second view to compare.
+ * @return true if views are identical, otherwise false.
+ */
+KR_CONSTEXPR bool kr_strview_eq(struct kr_strview_s lhs, struct kr_strview_s rhs);
+
+/**
+ * @brief Find the first occurrence of a character inside a view.
+ *
+ * @param view View to search.
+ * @param ch Character to search for.
+ * @return Position of the character, or <0 if it was not found.
+ */
+KR_CONSTEXPR ptrdiff_t kr_strview_findchr(struct kr_strview_s view, char ch);
+
+/**
+ * @brief Find the first occurrence of a substring inside a view.
+ *
+ * @param view View to search.
+ * @param needle Substring to search for.  An empty needle is found at 0.
+ * @return Position of the substring, or <0 if it was not found.
+ */
+KR_CONSTEXPR ptrdiff_t kr_strview_find(struct kr_strview_s view, struct kr_strview_s needle);
+
+/**
+ * @brief Return the length (span) of the start of a view that consists only
+ *        of characters in the passed set.
+ *
+ * @param view View to check.
+ * @param set Characters to check for.
+ * @return Length of span that consists only of `set` characters.
+ */
+KR_CONSTEXPR size_t kr_strview_spn(struct kr_strview_s view, const struct kr_charset_s *set);
+
+/**
+ * @brief Return the length (span) of the start of a view that does not
+ *        contain any characters in the passed set.
+ *
+ * @param view View to check.
+ * @param set Characters to check for.
+ * @return Length of span that does not contain `set` characters.
+ */
+KR_CONSTEXPR size_t kr_strview_cspn(struct kr_strview_s view, const struct kr_charset_s *set);
+
+/**
+ * @brief Scan a view for a token that is split by one of the characters in
+ *        the passed set.
+ *
+ * @details Unlike kr_strtok_r, the scanned string is never modified.
+ *
+ * @param rest Remaining view to scan.  Advanced past the returned token.
+ * @param delim A set of characters that split tokens.
+ * @param tok Output view of the token found.
+ * @return true if a token was found, or false if there are no more tokens.
+ */
+KR_CONSTEXPR bool kr_strview_tok(struct kr_strview_s *KR_RESTRICT rest, const struct kr_charset_s *KR_RESTRICT delim,
+                                 struct kr_strview_s *KR_RESTRICT tok);
+
+/**
+ * @brief Copy view into a destination buffer as a null-terminated string.
+ *
+ * @param dest Destination buffer to copy to.
+ * @param src Source view to copy.
+ * @param destLen Destination buffer size.
+ * @return Length of resulting string, or <0 if truncation occurred.
+ */
+KR_CONSTEXPR ptrdiff_t kr_strview_copy(char *KR_RESTRICT dest, struct kr_strview_s src, size_t destLen);
+
 /**
  * @brief Duplicate string with malloc().
  *
@@ -182,6 +422,13 @@ KR_CONSTEXPR size_t kr_strlen(const char *str)
 {
     size_t i = 0;
 
+#if (KR_CONFIG_SWARSTR)
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_strlen_swar(str);
+    }
+#endif /* (KR_CONFIG_SWARSTR) */
+
     for (i = 0;; i++)
     {
         if (str[i] == '\0')
@@ -195,6 +442,13 @@ KR_CONSTEXPR size_t kr_strnlen(const char *str, size_t len)
 {
     size_t i = 0;
 
+#if (KR_CONFIG_SWARSTR)
+    if (!KR_IS_CONSTANT_EVALUATED())
+    {
+        return kr_strnlen_swar(str, len);
+    }
+#endif /* (KR_CONFIG_SWARSTR) */
+
     for (i = 0; i < len; i++)
     {
         if (str[i] == '\0')
@@ -207,6 +461,86 @@ KR_CONSTEXPR size_t kr_strnlen(const char *str, size_t len)
 
 /******************************************************************************/
 
+/*
+ * A word has a zero byte if subtracting one from every byte borrows into
+ * the high bit of a byte that did not have its high bit set to begin with.
+ * Dividing the all-ones word by UCHAR_MAX gives us 0x0101...01 for any
+ * width of size_t.
+ */
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_strlen_swar(const char *str)
+{
+    const size_t lo = KR_CASTS(size_t, -1) / UCHAR_MAX;
+    const size_t hi = lo * (UCHAR_MAX / 2 + 1);
+    const char *s = str;
+    size_t word = 0;
+
+    /* Walk bytes until we reach a word boundary. */
+    for (; KR_CASTR(uintptr_t, s) % sizeof(word) != 0; s++)
+    {
+        if (*s == '\0')
+        {
+            return KR_CASTS(size_t, s - str);
+        }
+    }
+
+    /* Walk aligned words until one of them contains a zero byte. */
+    for (;; s += sizeof(word))
+    {
+        memcpy(&word, s, sizeof(word));
+        if (((word - lo) & ~word & hi) != 0)
+        {
+            break;
+        }
+    }
+
+    /* Find the zero byte inside the word. */
+    for (; *s != '\0'; s++)
+    {
+    }
+    return KR_CASTS(size_t, s - str);
+}
+
+KR_NOSANITIZE_ADDRESS KR_INLINE size_t kr_strnlen_swar(const char *str, size_t len)
+{
+    const size_t lo = KR_CASTS(size_t, -1) / UCHAR_MAX;
+    const size_t hi = lo * (UCHAR_MAX / 2 + 1);
+    const char *s = str;
+    size_t remain = len;
+    size_t word = 0;
+
+    /* Walk bytes until we reach a word boundary. */
+    for (; remain > 0 && KR_CASTR(uintptr_t, s) % sizeof(word) != 0; s++, remain--)
+    {
+        if (*s == '\0')
+        {
+            return KR_CASTS(size_t, s - str);
+        }
+    }
+
+    /* Walk whole aligned words until one of them contains a zero byte. */
+    for (; remain >= sizeof(word); s += sizeof(word), remain -= sizeof(word))
+    {
+        memcpy(&word, s, sizeof(word));
+        if (((word - lo) & ~word & hi) != 0)
+        {
+            break;
+        }
+    }
+
+    /* Find the zero byte inside the word, or in the remaining bytes. */
+    for (; remain > 0; s++, remain--)
+    {
+        if (*s == '\0')
+        {
+            return KR_CASTS(size_t, s - str);
+        }
+    }
+    return len;
+}
+
+/******************************************************************************/
+
 KR_CONSTEXPR int kr_strcmp(const char *lhs, const char *rhs)
 {
     for (;; lhs++, rhs++)
@@ -329,57 +663,89 @@ KR_CONSTEXPR char *kr_stpecpy(char *dest, char *destEnd, const char *KR_RESTRICT
 
 KR_CONSTEXPR size_t kr_strspn(const char *str, const char *chars)
 {
-    const char *s = str;
-    const char *ch = NULL;
+    const struct kr_charset_s set = kr_charset_make(chars);
+    return kr_strspn_set(str, &set);
+}
 
-    for (; *s != '\0'; s++)
+KR_CONSTEXPR size_t kr_strcspn(const char *str, const char *chars)
+{
+    const struct kr_charset_s set = kr_charset_make(chars);
+    return kr_strcspn_set(str, &set);
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR char *kr_strtok_r(char *KR_RESTRICT str, const char *KR_RESTRICT delim, char **KR_RESTRICT ptr)
+{
+    const struct kr_charset_s set = kr_charset_make(delim);
+    return kr_strtok_set_r(str, &set, ptr);
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR void kr_charset_clear(struct kr_charset_s *set)
+{
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(set->bits); i++)
     {
-        bool found = false;
-        for (ch = chars; *ch != '\0'; ch++)
-        {
-            if (*s == *ch)
-            {
-                found = true;
-                break;
-            }
-        }
-        if (!found)
-        {
-            return KR_CASTS(size_t, s - str);
-        }
+        set->bits[i] = 0;
     }
+}
 
-    return KR_CASTS(size_t, s - str);
+KR_CONSTEXPR void kr_charset_add(struct kr_charset_s *set, char ch)
+{
+    const unsigned char uch = KR_CASTS(unsigned char, ch);
+    set->bits[uch / CHAR_BIT] |= KR_CASTS(unsigned char, 1u << (uch % CHAR_BIT));
 }
 
-KR_CONSTEXPR size_t kr_strcspn(const char *str, const char *chars)
+KR_CONSTEXPR void kr_charset_addstr(struct kr_charset_s *set, const char *chars)
+{
+    for (; *chars != '\0'; chars++)
+    {
+        kr_charset_add(set, *chars);
+    }
+}
+
+KR_CONSTEXPR struct kr_charset_s kr_charset_make(const char *chars)
+{
+    struct kr_charset_s set = {{0}};
+    kr_charset_addstr(&set, chars);
+    return set;
+}
+
+KR_CONSTEXPR bool kr_charset_has(const struct kr_charset_s *set, char ch)
+{
+    const unsigned char uch = KR_CASTS(unsigned char, ch);
+    return ((set->bits[uch / CHAR_BIT] >> (uch % CHAR_BIT)) & 1u) != 0;
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR size_t kr_strspn_set(const char *str, const struct kr_charset_s *set)
 {
     const char *s = str;
-    const char *ch = NULL;
 
-    for (; *s != '\0'; s++)
+    for (; *s != '\0' && kr_charset_has(set, *s); s++)
     {
-        bool found = false;
-        for (ch = chars; *ch != '\0'; ch++)
-        {
-            if (*s == *ch)
-            {
-                found = true;
-                break;
-            }
-        }
-        if (found)
-        {
-            return KR_CASTS(size_t, s - str);
-        }
     }
+    return KR_CASTS(size_t, s - str);
+}
+
+KR_CONSTEXPR size_t kr_strcspn_set(const char *str, const struct kr_charset_s *set)
+{
+    const char *s = str;
 
+    for (; *s != '\0' && !kr_charset_has(set, *s); s++)
+    {
+    }
     return KR_CASTS(size_t, s - str);
 }
 
 /******************************************************************************/
 
-KR_CONSTEXPR char *kr_strtok_r(char *KR_RESTRICT str, const char *KR_RESTRICT delim, char **KR_RESTRICT ptr)
+KR_CONSTEXPR char *kr_strtok_set_r(char *KR_RESTRICT str, const struct kr_charset_s *KR_RESTRICT delim,
+                                   char **KR_RESTRICT ptr)
 {
     char *tok = NULL;
 
@@ -395,7 +761,7 @@ KR_CONSTEXPR char *kr_strtok_r(char *KR_RESTRICT str, const char *KR_RESTRICT de
     }
 
     /* First, munch all delim chars. */
-    str += kr_strspn(str, delim);
+    str += kr_strspn_set(str, delim);
     if (*str == '\0')
     {
         /* Could not find another token. */
@@ -404,7 +770,7 @@ KR_CONSTEXPR char *kr_strtok_r(char *KR_RESTRICT str, const char *KR_RESTRICT de
 
     /* Munch a token. */
     tok = str;
-    str += kr_strcspn(str, delim);
+    str += kr_strcspn_set(str, delim);
     if (*str == '\0')
     {
         /* Found the last token. */
@@ -420,6 +786,168 @@ KR_CONSTEXPR char *kr_strtok_r(char *KR_RESTRICT str, const char *KR_RESTRICT de
 
 /******************************************************************************/
 
+KR_CONSTEXPR struct kr_strview_s kr_strview_make(const char *data, size_t len)
+{
+    struct kr_strview_s view = {NULL, 0};
+    view.data = data;
+    view.len = len;
+    return view;
+}
+
+KR_CONSTEXPR struct kr_strview_s kr_strview_from(const char *str)
+{
+    return kr_strview_make(str, kr_strlen(str));
+}
+
+KR_CONSTEXPR struct kr_strview_s kr_strview_sub(struct kr_strview_s view, size_t pos, size_t len)
+{
+    if (pos > view.len)
+    {
+        pos = view.len;
+    }
+    if (len > view.len - pos)
+    {
+        len = view.len - pos;
+    }
+    return kr_strview_make(view.data + pos, len);
+}
+
+KR_CONSTEXPR int kr_strview_cmp(struct kr_strview_s lhs, struct kr_strview_s rhs)
+{
+    const size_t len = lhs.len < rhs.len ? lhs.len : rhs.len;
+    size_t i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        if (lhs.data[i] != rhs.data[i])
+        {
+            return KR_CASTS(unsigned char, lhs.data[i]) - KR_CASTS(unsigned char, rhs.data[i]);
+        }
+    }
+
+    if (lhs.len == rhs.len)
+    {
+        return 0;
+    }
+    return lhs.len < rhs.len ? -1 : 1;
+}
+
+KR_CONSTEXPR bool kr_strview_eq(struct kr_strview_s lhs, struct kr_strview_s rhs)
+{
+    return lhs.len == rhs.len && kr_strview_cmp(lhs, rhs) == 0;
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR ptrdiff_t kr_strview_findchr(struct kr_strview_s view, char ch)
+{
+    size_t i = 0;
+
+    for (i = 0; i < view.len; i++)
+    {
+        if (view.data[i] == ch)
+        {
+            return KR_CASTS(ptrdiff_t, i);
+        }
+    }
+    return -1;
+}
+
+KR_CONSTEXPR ptrdiff_t kr_strview_find(struct kr_strview_s view, struct kr_strview_s needle)
+{
+    size_t i = 0, j = 0;
+
+    if (needle.len == 0)
+    {
+        return 0;
+    }
+    if (needle.len > view.len)
+    {
+        return -1;
+    }
+
+    for (i = 0; i <= view.len - needle.len; i++)
+    {
+        /* Cheap check on the first character before comparing the rest. */
+        if (view.data[i] != needle.data[0])
+        {
+            continue;
+        }
+        for (j = 1; j < needle.len && view.data[i + j] == needle.data[j]; j++)
+        {
+        }
+        if (j == needle.len)
+        {
+            return KR_CASTS(ptrdiff_t, i);
+        }
+    }
+    return -1;
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR size_t kr_strview_spn(struct kr_strview_s view, const struct kr_charset_s *set)
+{
+    size_t i = 0;
+
+    for (; i < view.len && kr_charset_has(set, view.data[i]); i++)
+    {
+    }
+    return i;
+}
+
+KR_CONSTEXPR size_t kr_strview_cspn(struct kr_strview_s view, const struct kr_charset_s *set)
+{
+    size_t i = 0;
+
+    for (; i < view.len && !kr_charset_has(set, view.data[i]); i++)
+    {
+    }
+    return i;
+}
+
+KR_CONSTEXPR bool kr_strview_tok(struct kr_strview_s *KR_RESTRICT rest, const struct kr_charset_s *KR_RESTRICT delim,
+                                 struct kr_strview_s *KR_RESTRICT tok)
+{
+    size_t len = 0;
+
+    /* First, munch all delim chars. */
+    *rest = kr_strview_sub(*rest, kr_strview_spn(*rest, delim), rest->len);
+    if (rest->len == 0)
+    {
+        /* Could not find another token. */
+        return false;
+    }
+
+    /* Munch a token, then skip the delimiter that ended it. */
+    len = kr_strview_cspn(*rest, delim);
+    *tok = kr_strview_make(rest->data, len);
+    *rest = kr_strview_sub(*rest, len + (len < rest->len ? 1 : 0), rest->len);
+    return true;
+}
+
+/******************************************************************************/
+
+KR_CONSTEXPR ptrdiff_t kr_strview_copy(char *KR_RESTRICT dest, struct kr_strview_s src, size_t destLen)
+{
+    size_t i = 0, len = 0;
+
+    if (destLen == 0)
+    {
+        return -1;
+    }
+
+    len = src.len < destLen - 1 ? src.len : destLen - 1;
+    for (i = 0; i < len; i++)
+    {
+        dest[i] = src.data[i];
+    }
+    dest[len] = '\0';
+    return len == src.len ? KR_CASTS(ptrdiff_t, len) : -1;
+}
+
+/******************************************************************************/
+
 KR_NODISCARD char *kr_strdup(const char *str)
 {
     size_t strl = kr_strlen(str);
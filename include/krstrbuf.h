@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#if !defined(KRSTRBUF_H)
+#define KRSTRBUF_H
+
+#include "./krconfig.h"
+
+#include "./krbool.h"
+#include "./krint.h"
+#include "./krlib.h"
+#include "./krstr.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+/**
+ * @brief A growable string builder.
+ *
+ * @details Strings shorter than KR_CONFIG_STRBUFSMALL are stored inside the
+ *          builder itself and never touch the heap.  Longer strings move to
+ *          a heap buffer that doubles in size when it runs out of room, so
+ *          appending is amortized constant time per character.
+ *
+ *          The builder contains no pointers to itself, so it can be copied
+ *          or returned by value while it is small, but only one copy may be
+ *          used after it has moved to the heap.
+ *
+ *          The append functions accept a source that points into the
+ *          builder's own contents, even if appending moves them.
+ */
+struct kr_strbuf_s
+{
+    char *heap;
+    size_t len;
+    size_t cap;
+    char small[KR_CONFIG_STRBUFSMALL];
+};
+
+/**
+ * @brief Initialize an empty builder.
+ *
+ * @param buf Builder to initialize.
+ */
+KR_INLINE void kr_strbuf_init(struct kr_strbuf_s *buf);
+
+/**
+ * @brief Free any memory owned by a builder and leave it empty.
+ *
+ * @param buf Builder to free.
+ */
+KR_INLINE void kr_strbuf_free(struct kr_strbuf_s *buf);
+
+/**
+ * @brief Empty a builder without giving back its memory.
+ *
+ * @details Lets one builder be reused for many strings without allocating.
+ *
+ * @param buf Builder to clear.
+ */
+KR_INLINE void kr_strbuf_clear(struct kr_strbuf_s *buf);
+
+/**
+ * @brief Get the contents of a builder as a null-terminated string.
+ *
+ * @param buf Builder to read.
+ * @return Contents of the builder.  Invalidated by any call that modifies
+ *         the builder.
+ */
+KR_INLINE const char *kr_strbuf_cstr(const struct kr_strbuf_s *buf);
+
+/**
+ * @brief Make sure a builder can hold a string of a given length without
+ *        allocating again.
+ *
+ * @param buf Builder to grow.
+ * @param len Length of string to make room for, not including the null
+ *        terminator.
+ * @return true if the builder has enough room, or false if allocation
+ *         failed.  The builder is unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_strbuf_reserve(struct kr_strbuf_s *buf, size_t len);
+
+/**
+ * @brief Append a string to the end of a builder.
+ *
+ * @param buf Builder to append to.
+ * @param str String to append.
+ * @return true if successful, or false if allocation failed.  The builder
+ *         is unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_strbuf_append(struct kr_strbuf_s *buf, const char *str);
+
+/**
+ * @brief Append up to len characters of a string to the end of a builder.
+ *
+ * @param buf Builder to append to.
+ * @param str String to append.  Stops early at a null terminator.
+ * @param len Maximum number of characters to append.
+ * @return true if successful, or false if allocation failed.  The builder
+ *         is unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_strbuf_appendn(struct kr_strbuf_s *buf, const char *str, size_t len);
+
+/**
+ * @brief Append a string view to the end of a builder.
+ *
+ * @param buf Builder to append to.
+ * @param view View to append.  Null characters inside the view are copied.
+ * @return true if successful, or false if allocation failed.  The builder
+ *         is unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_strbuf_appendview(struct kr_strbuf_s *buf, struct kr_strview_s view);
+
+/**
+ * @brief Append a single character to the end of a builder.
+ *
+ * @param buf Builder to append to.
+ * @param ch Character to append.
+ * @return true if successful, or false if allocation failed.  The builder
+ *         is unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_strbuf_appendch(struct kr_strbuf_s *buf, char ch);
+
+/**
+ * @brief Take ownership of the contents of a builder and leave it empty.
+ *
+ * @details If the contents are on the heap they are handed over without
+ *          copying.  Otherwise they are copied into a fresh allocation.
+ *
+ * @param buf Builder to detach from.
+ * @return Allocated string that can be freed with KR_FREE, or NULL if
+ *         allocation failed.  The builder is unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE char *kr_strbuf_detach(struct kr_strbuf_s *buf);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+KR_INLINE void kr_strbuf_init(struct kr_strbuf_s *buf)
+{
+    buf->heap = NULL;
+    buf->len = 0;
+    buf->cap = sizeof(buf->small);
+    buf->small[0] = '\0';
+}
+
+KR_INLINE void kr_strbuf_free(struct kr_strbuf_s *buf)
+{
+    KR_FREE(buf->heap);
+    kr_strbuf_init(buf);
+}
+
+KR_INLINE void kr_strbuf_clear(struct kr_strbuf_s *buf)
+{
+    buf->len = 0;
+    (buf->heap != NULL ? buf->heap : buf->small)[0] = '\0';
+}
+
+KR_INLINE const char *kr_strbuf_cstr(const struct kr_strbuf_s *buf)
+{
+    return buf->heap != NULL ? buf->heap : buf->small;
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE bool kr_strbuf_reserve(struct kr_strbuf_s *buf, size_t len)
+{
+    size_t cap = 0;
+    char *heap = NULL;
+
+    if (len < buf->cap)
+    {
+        return true;
+    }
+    if (len == SIZE_MAX)
+    {
+        return false;
+    }
+
+    /* Grow geometrically so a run of appends reallocates O(log n) times. */
+    cap = buf->cap;
+    while (cap <= len)
+    {
+        cap = cap <= SIZE_MAX / 2 ? cap * 2 : len + 1;
+    }
+
+    heap = KR_CASTS(char *, kr_reallocarray(buf->heap, cap, sizeof(char)));
+    if (heap == NULL)
+    {
+        return false;
+    }
+
+    if (buf->heap == NULL)
+    {
+        memcpy(heap, buf->small, buf->len + 1);
+    }
+    buf->heap = heap;
+    buf->cap = cap;
+    return true;
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE bool kr_strbuf_append(struct kr_strbuf_s *buf, const char *str)
+{
+    return kr_strbuf_appendview(buf, kr_strview_from(str));
+}
+
+KR_NODISCARD KR_INLINE bool kr_strbuf_appendn(struct kr_strbuf_s *buf, const char *str, size_t len)
+{
+    return kr_strbuf_appendview(buf, kr_strview_make(str, kr_strnlen(str, len)));
+}
+
+KR_NODISCARD KR_INLINE bool kr_strbuf_appendview(struct kr_strbuf_s *buf, struct kr_strview_s view)
+{
+    char *data = buf->heap != NULL ? buf->heap : buf->small;
+    const uintptr_t start = KR_CASTR(uintptr_t, data);
+    const uintptr_t src = KR_CASTR(uintptr_t, view.data);
+
+    if (view.len > SIZE_MAX - buf->len || !kr_strbuf_reserve(buf, buf->len + view.len))
+    {
+        return false;
+    }
+
+    data = buf->heap != NULL ? buf->heap : buf->small;
+    if (src >= start && src < start + buf->len)
+    {
+        /* Appending part of itself, which may have just moved. */
+        view.data = data + (src - start);
+    }
+    memcpy(data + buf->len, view.data, view.len);
+    buf->len += view.len;
+    data[buf->len] = '\0';
+    return true;
+}
+
+KR_NODISCARD KR_INLINE bool kr_strbuf_appendch(struct kr_strbuf_s *buf, char ch)
+{
+    char *data = NULL;
+
+    if (buf->len + 1 >= buf->cap && !kr_strbuf_reserve(buf, buf->len + 1))
+    {
+        return false;
+    }
+
+    data = buf->heap != NULL ? buf->heap : buf->small;
+    data[buf->len++] = ch;
+    data[buf->len] = '\0';
+    return true;
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE char *kr_strbuf_detach(struct kr_strbuf_s *buf)
+{
+    char *str = buf->heap;
+
+    if (str == NULL)
+    {
+        str = KR_CASTS(char *, KR_MALLOC(buf->len + 1));
+        if (str == NULL)
+        {
+            return NULL;
+        }
+        memcpy(str, buf->small, buf->len + 1);
+    }
+
+    kr_strbuf_init(buf);
+    return str;
+}
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRSTRBUF_H) */
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#if !defined(KRVEC_H)
+#define KRVEC_H
+
+#include "./krconfig.h"
+
+#include "./krbit.h"
+#include "./krbool.h"
+#include "./krint.h"
+#include "./krlib.h"
+
+#if (!KR_CONFIG_NOINCLUDE)
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+/**
+ * @brief A growable array of fixed-size elements.
+ *
+ * @details Growing rounds the capacity up to a power of two, so a run of
+ *          pushes reallocates O(log n) times and each push is amortized
+ *          constant time.  kr_vec_shrink trims it to the length, which need
+ *          not be a power of two.
+ *          Elements are copied in and out as plain bytes, and are contiguous
+ *          in data so they can be accessed with KR_VEC_AT.
+ */
+struct kr_vec_s
+{
+    void *data;
+    size_t len;
+    size_t cap;
+    size_t elemSize;
+};
+
+/**
+ * @brief Get the elements of a vector as a pointer to type t.
+ */
+#define KR_VEC_DATA(t, vec) (KR_CASTS(t *, (vec)->data))
+
+/**
+ * @brief Get element i of a vector of type t as an lvalue.
+ */
+#define KR_VEC_AT(t, vec, i) (KR_VEC_DATA(t, vec)[(i)])
+
+/**
+ * @brief Initialize an empty vector.  No memory is allocated until the first
+ *        element is added.
+ *
+ * @param vec Vector to initialize.
+ * @param elemSize Size of each element.  Must not be 0.
+ */
+KR_INLINE void kr_vec_init(struct kr_vec_s *vec, size_t elemSize);
+
+/**
+ * @brief Free any memory owned by a vector and leave it empty.
+ *
+ * @param vec Vector to free.
+ */
+KR_INLINE void kr_vec_free(struct kr_vec_s *vec);
+
+/**
+ * @brief Remove every element from a vector, keeping its memory.
+ *
+ * @param vec Vector to clear.
+ */
+KR_INLINE void kr_vec_clear(struct kr_vec_s *vec);
+
+/**
+ * @brief Make sure a vector can hold a number of elements without
+ *        allocating again.
+ *
+ * @param vec Vector to grow.
+ * @param n Total number of elements to make room for.  Capacity is rounded
+ *        up to a power of two.
+ * @return true if the vector has enough room, or false if allocation failed.
+ *         The vector is unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_vec_reserve(struct kr_vec_s *vec, size_t n);
+
+/**
+ * @brief Give back any capacity a vector is not using.
+ *
+ * @param vec Vector to shrink.
+ * @return true if successful, or false if allocation failed.  The vector is
+ *         unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_vec_shrink(struct kr_vec_s *vec);
+
+/**
+ * @brief Add an element to the end of a vector.
+ *
+ * @param vec Vector to append to.
+ * @param elem Element to copy, or NULL to leave the new element
+ *        uninitialized.
+ * @return Pointer to the new element, or NULL if allocation failed.  Valid
+ *         until the vector is next resized.
+ */
+KR_NODISCARD KR_INLINE void *kr_vec_push(struct kr_vec_s *vec, const void *elem);
+
+/**
+ * @brief Remove the element at the end of a vector.
+ *
+ * @param vec Vector to modify.
+ * @param elem Set to the removed element.  May be NULL.
+ * @return true if an element was removed, or false if the vector is empty.
+ */
+KR_INLINE bool kr_vec_pop(struct kr_vec_s *vec, void *elem);
+
+/**
+ * @brief Add an array of elements to the end of a vector.
+ *
+ * @param vec Vector to append to.
+ * @param elems Elements to copy.  Must not point into the vector.
+ * @param n Number of elements to copy.
+ * @return true if successful, or false if allocation failed.  The vector is
+ *         unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_vec_append(struct kr_vec_s *KR_RESTRICT vec, const void *KR_RESTRICT elems, size_t n);
+
+/**
+ * @brief Insert an array of elements in the middle of a vector, moving the
+ *        elements after them up.
+ *
+ * @param vec Vector to insert into.
+ * @param index Position of the first inserted element.  Must not be greater
+ *        than the length of the vector.
+ * @param elems Elements to copy, or NULL to leave the new elements
+ *        uninitialized.  Must not point into the vector.
+ * @param n Number of elements to insert.
+ * @return true if successful, or false if allocation failed.  The vector is
+ *         unchanged on failure.
+ */
+KR_NODISCARD KR_INLINE bool kr_vec_insert(struct kr_vec_s *KR_RESTRICT vec, size_t index,
+                                          const void *KR_RESTRICT elems, size_t n);
+
+/**
+ * @brief Remove a range of elements from a vector, moving the elements after
+ *        them down.
+ *
+ * @param vec Vector to modify.
+ * @param index Position of the first element to remove.
+ * @param n Number of elements to remove.  The range must be inside the
+ *        vector.
+ */
+KR_INLINE void kr_vec_erase(struct kr_vec_s *vec, size_t index, size_t n);
+
+/**
+ * @brief Get a pointer to an element of a vector.
+ *
+ * @param vec Vector to read.
+ * @param index Position of the element.  Must be less than the length of
+ *        the vector.
+ */
+KR_INLINE void *kr_vec_at(const struct kr_vec_s *vec, size_t index);
+
+/******************************************************************************/
+#if !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION)
+/******************************************************************************/
+
+/**
+ * @brief Round a capacity up to a power of two, or leave it alone if the
+ *        power of two does not fit.
+ */
+KR_INLINE size_t kr_vec_ceil_detail_(size_t n)
+{
+#if defined(UINT64_MAX) && (KR_SIZEOF_SIZE_T > 4)
+    const size_t cap = KR_CASTS(size_t, kr_bit_ceil64(KR_CASTS(uint64_t, n)));
+#else
+    const size_t cap = KR_CASTS(size_t, kr_bit_ceil32(KR_CASTS(uint32_t, n)));
+#endif
+    return cap >= n ? cap : n;
+}
+
+/**
+ * @brief Get a pointer to the byte that starts an element.
+ */
+KR_INLINE unsigned char *kr_vec_ptr_detail_(const struct kr_vec_s *vec, size_t index)
+{
+    return KR_CASTS(unsigned char *, vec->data) + index * vec->elemSize;
+}
+
+KR_INLINE void kr_vec_init(struct kr_vec_s *vec, size_t elemSize)
+{
+    vec->data = NULL;
+    vec->len = 0;
+    vec->cap = 0;
+    vec->elemSize = elemSize;
+}
+
+KR_INLINE void kr_vec_free(struct kr_vec_s *vec)
+{
+    KR_FREE(vec->data);
+    kr_vec_init(vec, vec->elemSize);
+}
+
+KR_INLINE void kr_vec_clear(struct kr_vec_s *vec)
+{
+    vec->len = 0;
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE bool kr_vec_reserve(struct kr_vec_s *vec, size_t n)
+{
+    size_t cap = 0;
+    void *data = NULL;
+
+    if (n <= vec->cap)
+    {
+        return true;
+    }
+
+    cap = kr_vec_ceil_detail_(n);
+    data = kr_reallocarray(vec->data, cap, vec->elemSize);
+    if (data == NULL)
+    {
+        return false;
+    }
+
+    vec->data = data;
+    vec->cap = cap;
+    return true;
+}
+
+KR_NODISCARD KR_INLINE bool kr_vec_shrink(struct kr_vec_s *vec)
+{
+    void *data = NULL;
+
+    if (vec->len == vec->cap)
+    {
+        return true;
+    }
+    if (vec->len == 0)
+    {
+        kr_vec_free(vec);
+        return true;
+    }
+
+    data = kr_reallocarray(vec->data, vec->len, vec->elemSize);
+    if (data == NULL)
+    {
+        return false;
+    }
+
+    vec->data = data;
+    vec->cap = vec->len;
+    return true;
+}
+
+/******************************************************************************/
+
+KR_NODISCARD KR_INLINE void *kr_vec_push(struct kr_vec_s *vec, const void *elem)
+{
+    unsigned char *ptr = NULL;
+
+    if (vec->len == vec->cap && (vec->len == SIZE_MAX || !kr_vec_reserve(vec, vec->len + 1)))
+    {
+        return NULL;
+    }
+
+    ptr = kr_vec_ptr_detail_(vec, vec->len++);
+    if (elem != NULL)
+    {
+        memcpy(ptr, elem, vec->elemSize);
+    }
+    return ptr;
+}
+
+KR_INLINE bool kr_vec_pop(struct kr_vec_s *vec, void *elem)
+{
+    if (vec->len == 0)
+    {
+        return false;
+    }
+
+    vec->len -= 1;
+    if (elem != NULL)
+    {
+        memcpy(elem, kr_vec_ptr_detail_(vec, vec->len), vec->elemSize);
+    }
+    return true;
+}
+
+KR_NODISCARD KR_INLINE bool kr_vec_append(struct kr_vec_s *KR_RESTRICT vec, const void *KR_RESTRICT elems, size_t n)
+{
+    return kr_vec_insert(vec, vec->len, elems, n);
+}
+
+KR_NODISCARD KR_INLINE bool kr_vec_insert(struct kr_vec_s *KR_RESTRICT vec, size_t index,
+                                          const void *KR_RESTRICT elems, size_t n)
+{
+    unsigned char *ptr = NULL;
+
+    if (n == 0)
+    {
+        return true;
+    }
+    if (n > vec->cap - vec->len && (n > SIZE_MAX - vec->len || !kr_vec_reserve(vec, vec->len + n)))
+    {
+        return false;
+    }
+
+    ptr = kr_vec_ptr_detail_(vec, index);
+    memmove(ptr + n * vec->elemSize, ptr, (vec->len - index) * vec->elemSize);
+    if (elems != NULL)
+    {
+        memcpy(ptr, elems, n * vec->elemSize);
+    }
+    vec->len += n;
+    return true;
+}
+
+KR_INLINE void kr_vec_erase(struct kr_vec_s *vec, size_t index, size_t n)
+{
+    unsigned char *ptr = NULL;
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    ptr = kr_vec_ptr_detail_(vec, index);
+    memmove(ptr, ptr + n * vec->elemSize, (vec->len - index - n) * vec->elemSize);
+    vec->len -= n;
+}
+
+KR_INLINE void *kr_vec_at(const struct kr_vec_s *vec, size_t index)
+{
+    return kr_vec_ptr_detail_(vec, index);
+}
+
+#endif /* !(KRUFT_CONFIG_USEIMPLEMENTATION) || defined(KRUFT_IMPLEMENTATION) */
+
+#endif /* !defined(KRVEC_H) */
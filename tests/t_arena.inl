@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krarena.h"
+
+TEST(arena, kr_arena_alloc)
+{
+    struct kr_arena_s arena;
+    unsigned char *ptr1 = NULL, *ptr2 = NULL, *ptr3 = NULL;
+
+    kr_arena_init(&arena, 64);
+
+    ptr1 = KR_CASTS(unsigned char *, kr_arena_alloc(&arena, 3));
+    ptr2 = KR_CASTS(unsigned char *, kr_arena_alloc(&arena, 5));
+    EXPECT_TRUE(ptr1 != NULL);
+    EXPECT_TRUE(ptr2 != NULL);
+    EXPECT_UINTEQ(0, KR_CASTR(uintptr_t, ptr1) % KR_ARENA_ALIGN);
+    EXPECT_UINTEQ(0, KR_CASTR(uintptr_t, ptr2) % KR_ARENA_ALIGN);
+    EXPECT_TRUE(ptr2 >= ptr1 + 3);
+
+    ptr3 = KR_CASTS(unsigned char *, kr_arena_alloc_aligned(&arena, 1, 32));
+    EXPECT_TRUE(ptr3 != NULL);
+    EXPECT_UINTEQ(0, KR_CASTR(uintptr_t, ptr3) % 32);
+
+    /* Allocations bigger than a block get a block of their own. */
+    ptr3 = KR_CASTS(unsigned char *, kr_arena_alloc(&arena, 1000));
+    EXPECT_TRUE(ptr3 != NULL);
+    memset(ptr3, 0xAA, 1000);
+
+    EXPECT_TRUE(kr_arena_alloc(&arena, SIZE_MAX) == NULL);
+    EXPECT_TRUE(kr_arena_alloc(&arena, SIZE_MAX - KR_ARENA_ALIGN) == NULL);
+
+    kr_arena_destroy(&arena);
+}
+
+TEST(arena, kr_arena_rewind)
+{
+    struct kr_arena_s arena;
+    struct kr_arena_mark_s mark;
+    void *ptr1 = NULL, *ptr2 = NULL, *ptr3 = NULL;
+    int i = 0;
+
+    kr_arena_init(&arena, 64);
+
+    /* Rewinding before anything was allocated acts like a reset. */
+    mark = kr_arena_mark(&arena);
+    ptr1 = kr_arena_alloc(&arena, 16);
+    kr_arena_rewind(&arena, mark);
+    EXPECT_TRUE(kr_arena_alloc(&arena, 16) == ptr1);
+
+    /* Rewinding across blocks reuses the same memory. */
+    mark = kr_arena_mark(&arena);
+    ptr2 = kr_arena_alloc(&arena, 16);
+    for (i = 0; i < 10; i++)
+    {
+        EXPECT_TRUE(kr_arena_alloc(&arena, 48) != NULL);
+    }
+    kr_arena_rewind(&arena, mark);
+    EXPECT_TRUE(kr_arena_alloc(&arena, 16) == ptr2);
+
+    /* Resetting releases everything, but keeps the blocks. */
+    kr_arena_reset(&arena);
+    EXPECT_TRUE(kr_arena_alloc(&arena, 16) == ptr1);
+    ptr3 = kr_arena_alloc(&arena, 1000);
+    EXPECT_TRUE(ptr3 != NULL);
+    kr_arena_reset(&arena);
+    EXPECT_TRUE(kr_arena_alloc(&arena, 16) == ptr1);
+
+    kr_arena_destroy(&arena);
+}
+
+TEST(arena, kr_arena_reallocarray)
+{
+    struct kr_arena_s arena;
+    int *ptr1 = NULL, *ptr2 = NULL;
+    int i = 0;
+
+    kr_arena_init(&arena, 256);
+
+    ptr1 = KR_CASTS(int *, kr_arena_reallocarray(&arena, NULL, 0, 4, sizeof(int)));
+    EXPECT_TRUE(ptr1 != NULL);
+    for (i = 0; i < 4; i++)
+    {
+        ptr1[i] = i;
+    }
+
+    /* The most recent allocation grows in place. */
+    ptr2 = KR_CASTS(int *, kr_arena_reallocarray(&arena, ptr1, 4, 8, sizeof(int)));
+    EXPECT_TRUE(ptr1 == ptr2);
+
+    /* Growing past the end of the block copies. */
+    ptr2 = KR_CASTS(int *, kr_arena_reallocarray(&arena, ptr1, 8, 128, sizeof(int)));
+    EXPECT_TRUE(ptr2 != NULL);
+    EXPECT_TRUE(ptr1 != ptr2);
+    for (i = 0; i < 4; i++)
+    {
+        EXPECT_INTEQ(i, ptr2[i]);
+    }
+
+    EXPECT_TRUE(kr_arena_reallocarray(&arena, ptr2, 128, SIZE_MAX, 8) == NULL);
+    EXPECT_TRUE(kr_arena_reallocarray(&arena, ptr2, 128, 8, SIZE_MAX) == NULL);
+
+    kr_arena_destroy(&arena);
+}
+
+TEST(arena, kr_arena_strdup)
+{
+    struct kr_arena_s arena;
+    char *str = NULL;
+
+    kr_arena_init(&arena, 64);
+
+    str = kr_arena_strdup(&arena, "xyzzy");
+    EXPECT_STREQ("xyzzy", str);
+
+    str = kr_arena_strndup(&arena, "plugh", 3);
+    EXPECT_STREQ("plu", str);
+
+    str = kr_arena_strndup(&arena, "plugh", 10);
+    EXPECT_STREQ("plugh", str);
+
+    kr_arena_destroy(&arena);
+}
+
+SUITE(arena)
+{
+    SUITE_TEST(arena, kr_arena_alloc);
+    SUITE_TEST(arena, kr_arena_rewind);
+    SUITE_TEST(arena, kr_arena_reallocarray);
+    SUITE_TEST(arena, kr_arena_strdup);
+}
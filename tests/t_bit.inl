@@ -486,6 +486,104 @@ TEST(bit, kr_count_ones64)
 #endif /* !defined(UINT64_MAX) */
 }
 
+TEST(bit, kr_bit_deposit32)
+{
+    EXPECT_UINTEQ(0x50, kr_bit_deposit32(0x5, 0xF0));
+    EXPECT_UINTEQ(0x12005600, kr_bit_deposit32(0x1256, 0xFF00FF00));
+    EXPECT_UINTEQ(0x55555555, kr_bit_deposit32(0xFFFF, 0x55555555));
+    EXPECT_UINTEQ(0x80000001, kr_bit_deposit32(0x3, 0x80000001));
+    EXPECT_UINTEQ(0, kr_bit_deposit32(0xFFFFFFFF, 0));
+    EXPECT_UINTEQ(0x12345678, kr_bit_deposit32(0x12345678, 0xFFFFFFFF));
+}
+
+TEST(bit, kr_bit_extract32)
+{
+    EXPECT_UINTEQ(0x5, kr_bit_extract32(0x50, 0xF0));
+    EXPECT_UINTEQ(0x1256, kr_bit_extract32(0x12345678, 0xFF00FF00));
+    EXPECT_UINTEQ(0xFFFF, kr_bit_extract32(0x55555555, 0x55555555));
+    EXPECT_UINTEQ(0x3, kr_bit_extract32(0x80000001, 0x80000001));
+    EXPECT_UINTEQ(0, kr_bit_extract32(0xFFFFFFFF, 0));
+    EXPECT_UINTEQ(0x12345678, kr_bit_extract32(0x12345678, 0xFFFFFFFF));
+}
+
+TEST(bit, kr_bit_select64)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    uint64_t x = UINT64_C(0x9E3779B97F4A7C15);
+    unsigned i = 0, k = 0;
+
+    EXPECT_UINTEQ(0, kr_bit_select64(0x04c7, 0));
+    EXPECT_UINTEQ(2, kr_bit_select64(0x04c7, 2));
+    EXPECT_UINTEQ(10, kr_bit_select64(0x04c7, 5));
+    EXPECT_UINTEQ(64, kr_bit_select64(0x04c7, 6));
+    EXPECT_UINTEQ(63, kr_bit_select64(UINT64_C(0x8000000000000000), 0));
+    EXPECT_UINTEQ(63, kr_bit_select64(UINT64_C(0xFFFFFFFFFFFFFFFF), 63));
+    EXPECT_UINTEQ(64, kr_bit_select64(0, 0));
+
+    /* Every set bit of an irregular pattern. */
+    for (i = 0; i < 64; i++)
+    {
+        if ((x >> i) & 1)
+        {
+            EXPECT_UINTEQ(i, kr_bit_select64(x, k++));
+        }
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(bit, kr_bit_deposit64)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    uint64_t x = UINT64_C(0x9E3779B97F4A7C15), mask = UINT64_C(0xD1B54A32D192ED03);
+    uint64_t expected = 0;
+    unsigned i = 0, k = 0;
+
+    EXPECT_UINTEQ(UINT64_C(0x5555555555555555), kr_bit_deposit64(0xFFFFFFFF, UINT64_C(0x5555555555555555)));
+    EXPECT_UINTEQ(UINT64_C(0x8000000000000001), kr_bit_deposit64(0x3, UINT64_C(0x8000000000000001)));
+    EXPECT_UINTEQ(x, kr_bit_deposit64(x, UINT64_C(0xFFFFFFFFFFFFFFFF)));
+
+    /* Compare against depositing one bit at a time. */
+    for (i = 0; i < 64; i++)
+    {
+        if ((mask >> i) & 1)
+        {
+            expected |= ((x >> k++) & 1) << i;
+        }
+    }
+    EXPECT_UINTEQ(expected, kr_bit_deposit64(x, mask));
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(bit, kr_bit_extract64)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    uint64_t x = UINT64_C(0x9E3779B97F4A7C15), mask = UINT64_C(0xD1B54A32D192ED03);
+    uint64_t expected = 0;
+    unsigned i = 0, k = 0;
+
+    EXPECT_UINTEQ(0xFFFFFFFF, kr_bit_extract64(UINT64_C(0x5555555555555555), UINT64_C(0x5555555555555555)));
+    EXPECT_UINTEQ(0x3, kr_bit_extract64(UINT64_C(0x8000000000000001), UINT64_C(0x8000000000000001)));
+    EXPECT_UINTEQ(x, kr_bit_extract64(x, UINT64_C(0xFFFFFFFFFFFFFFFF)));
+
+    /* Compare against extracting one bit at a time, and round trip. */
+    for (i = 0; i < 64; i++)
+    {
+        if ((mask >> i) & 1)
+        {
+            expected |= ((x >> i) & 1) << k++;
+        }
+    }
+    EXPECT_UINTEQ(expected, kr_bit_extract64(x, mask));
+    EXPECT_UINTEQ(x & mask, kr_bit_deposit64(kr_bit_extract64(x, mask), mask));
+#endif /* !defined(UINT64_MAX) */
+}
+
 /******************************************************************************/
 
 SUITE(bit)
@@ -541,6 +639,11 @@ SUITE(bit)
     SUITE_TEST(bit, kr_count_ones16);
     SUITE_TEST(bit, kr_count_ones32);
     SUITE_TEST(bit, kr_count_ones64);
+    SUITE_TEST(bit, kr_bit_deposit32);
+    SUITE_TEST(bit, kr_bit_extract32);
+    SUITE_TEST(bit, kr_bit_select64);
+    SUITE_TEST(bit, kr_bit_deposit64);
+    SUITE_TEST(bit, kr_bit_extract64);
 }
 
 #pragma warning(pop)
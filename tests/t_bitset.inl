@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krbitset.h"
+
+TEST(bitset, kr_bitset_set)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    struct kr_bitset_s bs;
+
+    kr_bitset_init(&bs);
+    EXPECT_TRUE(kr_bitset_resize(&bs, 130));
+    EXPECT_UINTEQ(0, kr_bitset_count(&bs));
+
+    kr_bitset_set(&bs, 0);
+    kr_bitset_set(&bs, 63);
+    kr_bitset_set(&bs, 64);
+    kr_bitset_set(&bs, 129);
+    EXPECT_TRUE(kr_bitset_test(&bs, 0));
+    EXPECT_FALSE(kr_bitset_test(&bs, 1));
+    EXPECT_TRUE(kr_bitset_test(&bs, 63));
+    EXPECT_TRUE(kr_bitset_test(&bs, 64));
+    EXPECT_TRUE(kr_bitset_test(&bs, 129));
+    EXPECT_UINTEQ(4, kr_bitset_count(&bs));
+
+    kr_bitset_clear(&bs, 63);
+    EXPECT_FALSE(kr_bitset_test(&bs, 63));
+    EXPECT_UINTEQ(3, kr_bitset_count(&bs));
+
+    kr_bitset_setall(&bs);
+    EXPECT_UINTEQ(130, kr_bitset_count(&bs));
+    kr_bitset_clearall(&bs);
+    EXPECT_UINTEQ(0, kr_bitset_count(&bs));
+
+    kr_bitset_free(&bs);
+    EXPECT_TRUE(bs.words == NULL);
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(bitset, kr_bitset_resize)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    struct kr_bitset_s bs;
+    uint64_t buffer[2] = {UINT64_C(0xFFFFFFFFFFFFFFFF), UINT64_C(0xFFFFFFFFFFFFFFFF)};
+
+    /* A caller buffer is used as-is, and bits past the end are ignored. */
+    kr_bitset_init_buffer(&bs, buffer, 100);
+    EXPECT_UINTEQ(100, kr_bitset_count(&bs));
+
+    /* Shrinking and growing again brings back clear bits, not old ones. */
+    EXPECT_TRUE(kr_bitset_resize(&bs, 70));
+    EXPECT_TRUE(kr_bitset_resize(&bs, 128));
+    EXPECT_UINTEQ(70, kr_bitset_count(&bs));
+    EXPECT_TRUE(bs.words == buffer);
+
+    /* Growing past the buffer moves to the heap. */
+    EXPECT_TRUE(kr_bitset_resize(&bs, 1000));
+    EXPECT_TRUE(bs.words != buffer);
+    EXPECT_UINTEQ(70, kr_bitset_count(&bs));
+    EXPECT_TRUE(kr_bitset_test(&bs, 69));
+    EXPECT_FALSE(kr_bitset_test(&bs, 70));
+    EXPECT_FALSE(kr_bitset_test(&bs, 999));
+
+    EXPECT_TRUE(kr_bitset_resize(&bs, 0));
+    EXPECT_UINTEQ(0, kr_bitset_count(&bs));
+    kr_bitset_free(&bs);
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(bitset, kr_bitset_next)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    struct kr_bitset_s bs;
+    uint64_t buffer[4] = {0, 0, 0, 0};
+
+    kr_bitset_init_buffer(&bs, buffer, 200);
+    EXPECT_UINTEQ(200, kr_bitset_next_set(&bs, 0));
+    EXPECT_UINTEQ(0, kr_bitset_next_clear(&bs, 0));
+
+    kr_bitset_set(&bs, 5);
+    kr_bitset_set(&bs, 150);
+    EXPECT_UINTEQ(5, kr_bitset_next_set(&bs, 0));
+    EXPECT_UINTEQ(5, kr_bitset_next_set(&bs, 5));
+    EXPECT_UINTEQ(150, kr_bitset_next_set(&bs, 6));
+    EXPECT_UINTEQ(200, kr_bitset_next_set(&bs, 151));
+    EXPECT_UINTEQ(200, kr_bitset_next_set(&bs, 500));
+
+    kr_bitset_setall(&bs);
+    kr_bitset_clear(&bs, 130);
+    EXPECT_UINTEQ(130, kr_bitset_next_clear(&bs, 0));
+    EXPECT_UINTEQ(200, kr_bitset_next_clear(&bs, 131));
+
+    /* Bits past the end of the set do not count, even if they are set. */
+    kr_bitset_clearall(&bs);
+    buffer[3] = UINT64_C(0xFFFFFFFFFFFFFF00);
+    EXPECT_UINTEQ(200, kr_bitset_next_set(&bs, 0));
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(bitset, kr_bitset_iter)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    static const size_t expected[6] = {0, 1, 63, 64, 127, 192};
+    struct kr_bitset_s bs;
+    struct kr_bitset_iter_s it;
+    uint64_t buffer[4] = {0, 0, 0, 0};
+    size_t pos = 0, i = 0;
+
+    kr_bitset_init_buffer(&bs, buffer, 193);
+    kr_bitset_iter_init(&it, &bs);
+    EXPECT_FALSE(kr_bitset_iter_next(&it, &pos));
+
+    for (i = 0; i < 6; i++)
+    {
+        kr_bitset_set(&bs, expected[i]);
+    }
+    buffer[3] |= UINT64_C(0x8000000000000000);
+
+    i = 0;
+    kr_bitset_iter_init(&it, &bs);
+    while (kr_bitset_iter_next(&it, &pos))
+    {
+        EXPECT_UINTGT(6, i);
+        EXPECT_UINTEQ(expected[i], pos);
+        i++;
+    }
+    EXPECT_UINTEQ(6, i);
+
+    /* Small sets are masked too. */
+    kr_bitset_init_buffer(&bs, buffer, 10);
+    i = 0;
+    kr_bitset_iter_init(&it, &bs);
+    while (kr_bitset_iter_next(&it, &pos))
+    {
+        i++;
+    }
+    EXPECT_UINTEQ(2, i);
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(bitset, kr_bitset_words)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    uint64_t a[3] = {UINT64_C(0xFF00FF00FF00FF00), 0, UINT64_C(0xFFFFFFFFFFFFFFFF)};
+    uint64_t b[3] = {UINT64_C(0x0FF00FF00FF00FF0), 1, 0};
+
+    kr_bitset_and_words(a, b, 3);
+    EXPECT_XINTEQ(UINT64_C(0x0F000F000F000F00), a[0]);
+    EXPECT_XINTEQ(0, a[1]);
+    EXPECT_XINTEQ(0, a[2]);
+
+    kr_bitset_or_words(a, b, 3);
+    EXPECT_XINTEQ(UINT64_C(0x0FF00FF00FF00FF0), a[0]);
+    EXPECT_XINTEQ(1, a[1]);
+
+    kr_bitset_xor_words(a, b, 2);
+    EXPECT_XINTEQ(0, a[0]);
+    EXPECT_XINTEQ(0, a[1]);
+
+    a[0] = UINT64_C(0xFFFFFFFFFFFFFFFF);
+    kr_bitset_andnot_words(a, b, 1);
+    EXPECT_XINTEQ(UINT64_C(0xF00FF00FF00FF00F), a[0]);
+
+    kr_bitset_andnot_words(a, a, 1);
+    EXPECT_XINTEQ(0, a[0]);
+#endif /* !defined(UINT64_MAX) */
+}
+
+SUITE(bitset)
+{
+    SUITE_TEST(bitset, kr_bitset_set);
+    SUITE_TEST(bitset, kr_bitset_resize);
+    SUITE_TEST(bitset, kr_bitset_next);
+    SUITE_TEST(bitset, kr_bitset_iter);
+    SUITE_TEST(bitset, kr_bitset_words);
+}
@@ -241,6 +241,38 @@ TEST(bltin, kr_popcnt64_MACRO)
 #endif /* !defined(UINT64_MAX) */
 }
 
+TEST(bltin, kr_pdep32_MACRO)
+{
+    EXPECT_UINTEQ(0x12005600, kr_pdep32(0x1256, 0xFF00FF00));
+    EXPECT_UINTEQ(0x55555555, kr_pdep32(0xFFFF, 0x55555555));
+}
+
+TEST(bltin, kr_pdep64_MACRO)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    EXPECT_UINTEQ(UINT64_C(0x5555555555555555), kr_pdep64(0xFFFFFFFF, UINT64_C(0x5555555555555555)));
+    EXPECT_UINTEQ(UINT64_C(0x8000000000000001), kr_pdep64(0x3, UINT64_C(0x8000000000000001)));
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(bltin, kr_pext32_MACRO)
+{
+    EXPECT_UINTEQ(0x1256, kr_pext32(0x12345678, 0xFF00FF00));
+    EXPECT_UINTEQ(0xFFFF, kr_pext32(0x55555555, 0x55555555));
+}
+
+TEST(bltin, kr_pext64_MACRO)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    EXPECT_UINTEQ(0xFFFFFFFF, kr_pext64(UINT64_C(0x5555555555555555), UINT64_C(0x5555555555555555)));
+    EXPECT_UINTEQ(0x3, kr_pext64(UINT64_C(0x8000000000000001), UINT64_C(0x8000000000000001)));
+#endif /* !defined(UINT64_MAX) */
+}
+
 /******************************************************************************/
 
 SUITE(bltin)
@@ -271,4 +303,8 @@ SUITE(bltin)
     SUITE_TEST(bltin, kr_popcnt16_MACRO);
     SUITE_TEST(bltin, kr_popcnt32_MACRO);
     SUITE_TEST(bltin, kr_popcnt64_MACRO);
+    SUITE_TEST(bltin, kr_pdep32_MACRO);
+    SUITE_TEST(bltin, kr_pdep64_MACRO);
+    SUITE_TEST(bltin, kr_pext32_MACRO);
+    SUITE_TEST(bltin, kr_pext64_MACRO);
 }
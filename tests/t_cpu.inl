@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krcpu.h"
+#include "krrank.h"
+#include "krserial.h"
+#include "krsimd.h"
+
+TEST(cpu, kr_cpu_features)
+{
+    const unsigned long features = kr_cpu_features();
+
+    /* Detection is cached and repeatable. */
+    EXPECT_UINTEQ(features, kr_cpu_features());
+    EXPECT_UINTEQ(kr_cpu_detect(), features & ~0x80000000UL);
+    EXPECT_TRUE(kr_cpu_has(0));
+
+    /* The CPU must support whatever the compiler targeted. */
+#if (KR_AVX2)
+    EXPECT_TRUE(kr_cpu_has(KR_CPU_AVX2));
+#endif
+#if (KR_NEON)
+    EXPECT_TRUE(kr_cpu_has(KR_CPU_NEON));
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+    EXPECT_TRUE(kr_cpu_has(KR_CPU_SSE2));
+#endif
+
+    /* AVX2 needs the OS to save AVX state. */
+    if (kr_cpu_has(KR_CPU_AVX2))
+    {
+        EXPECT_TRUE(kr_cpu_has(KR_CPU_AVX));
+    }
+}
+
+TEST(cpu, kr_cpu_set_features)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    const unsigned long features = kr_cpu_features();
+    uint64_t words[37];
+    uint32_t swapped[37];
+    char str[100];
+    uint64_t expected = 0;
+    size_t i = 0;
+
+    for (i = 0; i < 37; i++)
+    {
+        words[i] = UINT64_C(0x0123456789ABCDEF) * (i + 1);
+        swapped[i] = KR_CASTS(uint32_t, words[i]);
+        expected += KR_CASTS(uint64_t, kr_count_ones64(words[i]));
+    }
+    memset(str, 'x', sizeof(str) - 1);
+    str[sizeof(str) - 1] = '\0';
+
+    /* Every kernel must give the same answer with no features at all. */
+    kr_cpu_set_features(0);
+    EXPECT_UINTEQ(0, kr_cpu_features() & KR_CPU_AVX2);
+    EXPECT_UINTEQ(expected, kr_popcount_array(words, 37));
+    kr_bswap32_array(swapped, 37);
+    EXPECT_UINTEQ(kr_byteswap32(KR_CASTS(uint32_t, words[36])), swapped[36]);
+    EXPECT_UINTEQ(99, kr_simd_strlen(str));
+    EXPECT_UINTEQ(50, kr_simd_strnlen(str, 50));
+
+    kr_cpu_set_features(features);
+    EXPECT_UINTEQ(features, kr_cpu_features());
+    EXPECT_UINTEQ(expected, kr_popcount_array(words, 37));
+    kr_bswap32_array(swapped, 37);
+    EXPECT_UINTEQ(KR_CASTS(uint32_t, words[36]), swapped[36]);
+    EXPECT_UINTEQ(99, kr_simd_strlen(str));
+    EXPECT_UINTEQ(50, kr_simd_strnlen(str, 50));
+#endif
+}
+
+SUITE(cpu)
+{
+    SUITE_TEST(cpu, kr_cpu_features);
+    SUITE_TEST(cpu, kr_cpu_set_features);
+}
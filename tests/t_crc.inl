@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krcpu.h"
+#include "krcrc.h"
+
+/* Bit-at-a-time CRC to check the fast paths against. */
+static uint32_t crc_bitwise(uint32_t poly, const unsigned char *p, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    size_t i = 0, j = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        crc ^= p[i];
+        for (j = 0; j < 8; j++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+/* Fill a buffer with bytes that are not all the same. */
+static void crc_fill(unsigned char *buf, size_t len)
+{
+    size_t i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = KR_CASTS(unsigned char, (i * 2654435761u) >> 24);
+    }
+}
+
+/******************************************************************************/
+
+TEST(crc, kr_crc32)
+{
+    unsigned char buf[300];
+    size_t len = 0, off = 0;
+    crc_fill(buf, sizeof(buf));
+
+    EXPECT_UINTEQ(0, kr_crc32(0, "", 0));
+    EXPECT_UINTEQ(0xCBF43926u, kr_crc32(0, "123456789", 9));
+    EXPECT_UINTEQ(0x414FA339u, kr_crc32(0, "The quick brown fox jumps over the lazy dog", 43));
+
+    /* Every length and alignment around the 8-byte slices. */
+    for (off = 0; off < 8; off++)
+    {
+        for (len = 0; len <= 40; len++)
+        {
+            EXPECT_UINTEQ(crc_bitwise(0xEDB88320u, buf + off, len), kr_crc32(0, buf + off, len));
+        }
+    }
+    EXPECT_UINTEQ(crc_bitwise(0xEDB88320u, buf, sizeof(buf)), kr_crc32(kr_crc32(0, buf, 123), buf + 123, 177));
+}
+
+TEST(crc, kr_crc32c)
+{
+    unsigned char buf[300];
+    const unsigned long features = kr_cpu_features();
+    size_t len = 0, off = 0;
+    crc_fill(buf, sizeof(buf));
+
+    EXPECT_UINTEQ(0, kr_crc32c(0, "", 0));
+    EXPECT_UINTEQ(0xE3069283u, kr_crc32c(0, "123456789", 9));
+
+    for (off = 0; off < 8; off++)
+    {
+        for (len = 0; len <= 40; len++)
+        {
+            EXPECT_UINTEQ(crc_bitwise(0x82F63B78u, buf + off, len), kr_crc32c(0, buf + off, len));
+        }
+    }
+    EXPECT_UINTEQ(crc_bitwise(0x82F63B78u, buf, sizeof(buf)), kr_crc32c(kr_crc32c(0, buf, 123), buf + 123, 177));
+
+    /* The portable path must match the hardware one. */
+    kr_cpu_set_features(0);
+    EXPECT_UINTEQ(0xE3069283u, kr_crc32c(0, "123456789", 9));
+    EXPECT_UINTEQ(crc_bitwise(0x82F63B78u, buf + 3, 257), kr_crc32c(0, buf + 3, 257));
+    kr_cpu_set_features(features);
+}
+
+TEST(crc, kr_crc32_combine)
+{
+    unsigned char buf[300];
+    size_t split = 0;
+    crc_fill(buf, sizeof(buf));
+
+    for (split = 0; split <= sizeof(buf); split += 13)
+    {
+        EXPECT_UINTEQ(kr_crc32(0, buf, sizeof(buf)),
+                      kr_crc32_combine(kr_crc32(0, buf, split), kr_crc32(0, buf + split, sizeof(buf) - split),
+                                       sizeof(buf) - split));
+        EXPECT_UINTEQ(kr_crc32c(0, buf, sizeof(buf)),
+                      kr_crc32c_combine(kr_crc32c(0, buf, split), kr_crc32c(0, buf + split, sizeof(buf) - split),
+                                        sizeof(buf) - split));
+    }
+    EXPECT_UINTEQ(0xCBF43926u, kr_crc32_combine(0xCBF43926u, 0, 0));
+}
+
+TEST(crc, kr_adler32)
+{
+    unsigned char buf[12000];
+    uint32_t a = 1, b = 0;
+    size_t i = 0;
+    memset(buf, 0xFF, sizeof(buf));
+
+    EXPECT_UINTEQ(1, kr_adler32(1, "", 0));
+    EXPECT_UINTEQ(0x11E60398u, kr_adler32(1, "Wikipedia", 9));
+
+    /* All 0xFF is the worst case for overflow between modulos. */
+    for (i = 0; i < sizeof(buf); i++)
+    {
+        a = (a + buf[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    EXPECT_UINTEQ(a | (b << 16), kr_adler32(1, buf, sizeof(buf)));
+    EXPECT_UINTEQ(a | (b << 16), kr_adler32(kr_adler32(1, buf, 7001), buf + 7001, sizeof(buf) - 7001));
+}
+
+TEST(crc, kr_adler32_combine)
+{
+    unsigned char buf[300];
+    size_t split = 0;
+    crc_fill(buf, sizeof(buf));
+
+    for (split = 0; split <= sizeof(buf); split += 13)
+    {
+        EXPECT_UINTEQ(kr_adler32(1, buf, sizeof(buf)),
+                      kr_adler32_combine(kr_adler32(1, buf, split), kr_adler32(1, buf + split, sizeof(buf) - split),
+                                         sizeof(buf) - split));
+    }
+}
+
+SUITE(crc)
+{
+    SUITE_TEST(crc, kr_crc32);
+    SUITE_TEST(crc, kr_crc32c);
+    SUITE_TEST(crc, kr_crc32_combine);
+    SUITE_TEST(crc, kr_adler32);
+    SUITE_TEST(crc, kr_adler32_combine);
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krbit.h"
+#include "krcurve.h"
+
+/******************************************************************************/
+
+TEST(curve, kr_morton2_encode32)
+{
+    uint16_t x = 0, y = 0;
+    uint32_t i = 0, v = 0;
+
+    EXPECT_UINTEQ(0x9u, kr_morton2_encode32(1, 2));
+    EXPECT_UINTEQ(0x55555555u, kr_morton2_encode32(0xFFFF, 0));
+    EXPECT_UINTEQ(0xAAAAAAAAu, kr_morton2_encode32(0, 0xFFFF));
+    EXPECT_UINTEQ(0x36u, kr_morton2_encode16(6, 5));
+
+    for (i = 0; i < 1000; i++)
+    {
+        v = i * 2654435761u;
+        EXPECT_UINTEQ(kr_bit_deposit32(v & 0xFFFF, 0x55555555u) | kr_bit_deposit32(v >> 16, 0xAAAAAAAAu),
+                      kr_morton2_encode32(KR_CASTS(uint16_t, v), KR_CASTS(uint16_t, v >> 16)));
+        EXPECT_UINTEQ(kr_morton2_encode32(KR_CASTS(uint16_t, v), KR_CASTS(uint16_t, v >> 16)),
+                      kr_morton2_encode32_table(KR_CASTS(uint16_t, v), KR_CASTS(uint16_t, v >> 16)));
+        EXPECT_UINTEQ(kr_morton2_encode16(KR_CASTS(uint8_t, v), KR_CASTS(uint8_t, v >> 8)),
+                      kr_morton2_encode16_table(KR_CASTS(uint8_t, v), KR_CASTS(uint8_t, v >> 8)));
+
+        kr_morton2_decode32(v, &x, &y);
+        EXPECT_UINTEQ(v, kr_morton2_encode32(x, y));
+    }
+
+#if (KR_CPLUSPLUS >= 201402)
+    static_assert(kr_morton2_encode32(1, 2) == 0x9, "morton must be constexpr");
+    static_assert(kr_morton2_encode32_table(1, 2) == 0x9, "morton table must be constexpr");
+#endif
+}
+
+TEST(curve, kr_morton2_decode16)
+{
+    uint8_t x = 0, y = 0;
+
+    kr_morton2_decode16(0x36, &x, &y);
+    EXPECT_UINTEQ(6, x);
+    EXPECT_UINTEQ(5, y);
+    kr_morton2_decode16(0xFFFF, &x, &y);
+    EXPECT_UINTEQ(0xFF, x);
+    EXPECT_UINTEQ(0xFF, y);
+}
+
+TEST(curve, kr_morton3_encode32)
+{
+    uint16_t x = 0, y = 0, z = 0;
+    uint8_t sx = 0, sy = 0, sz = 0;
+    uint32_t i = 0, v = 0;
+
+    EXPECT_UINTEQ(0x111u, kr_morton3_encode32(1, 2, 4));
+    EXPECT_UINTEQ(0x09249249u, kr_morton3_encode32(0xFFFF, 0, 0));
+    EXPECT_UINTEQ(0x7FFFu, kr_morton3_encode16(0xFF, 0xFF, 0xFF));
+
+    for (i = 0; i < 1000; i++)
+    {
+        v = (i * 2654435761u) & 0x3FFFFFFFu;
+        x = KR_CASTS(uint16_t, v & 0x3FF);
+        y = KR_CASTS(uint16_t, (v >> 10) & 0x3FF);
+        z = KR_CASTS(uint16_t, v >> 20);
+        EXPECT_UINTEQ(kr_bit_deposit32(x, 0x09249249u) | kr_bit_deposit32(y, 0x12492492u) |
+                          kr_bit_deposit32(z, 0x24924924u),
+                      kr_morton3_encode32(x, y, z));
+        EXPECT_UINTEQ(kr_morton3_encode32(x, y, z), kr_morton3_encode32_table(x, y, z));
+        EXPECT_UINTEQ(kr_morton3_encode16(KR_CASTS(uint8_t, x), KR_CASTS(uint8_t, y), KR_CASTS(uint8_t, z)),
+                      kr_morton3_encode16_table(KR_CASTS(uint8_t, x), KR_CASTS(uint8_t, y), KR_CASTS(uint8_t, z)));
+
+        kr_morton3_decode32(v, &x, &y, &z);
+        EXPECT_UINTEQ(v, kr_morton3_encode32(x, y, z));
+        kr_morton3_decode16(KR_CASTS(uint16_t, v & 0x7FFF), &sx, &sy, &sz);
+        EXPECT_UINTEQ(v & 0x7FFF, kr_morton3_encode16(sx, sy, sz));
+    }
+
+#if (KR_CPLUSPLUS >= 201402)
+    static_assert(kr_morton3_encode32(1, 2, 4) == 0x111, "morton must be constexpr");
+    static_assert(kr_morton3_encode32_table(1, 2, 4) == 0x111, "morton table must be constexpr");
+#endif
+}
+
+TEST(curve, kr_morton64)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    uint32_t x = 0, y = 0, z = 0;
+    uint64_t i = 0, v = 0;
+
+    EXPECT_UINTEQ(UINT64_C(0x5555555555555555), kr_morton2_encode64(0xFFFFFFFF, 0));
+    EXPECT_UINTEQ(UINT64_C(0x1249249249249249), kr_morton3_encode64(0xFFFFFFFF, 0, 0));
+    EXPECT_UINTEQ(UINT64_C(0x7FFFFFFFFFFFFFFF), kr_morton3_encode64(0x1FFFFF, 0x1FFFFF, 0x1FFFFF));
+
+    for (i = 0; i < 1000; i++)
+    {
+        v = (i + 1) * UINT64_C(0x9E3779B97F4A7C15);
+        x = KR_CASTS(uint32_t, v);
+        y = KR_CASTS(uint32_t, v >> 32);
+        EXPECT_UINTEQ(kr_bit_deposit64(x, UINT64_C(0x5555555555555555)) |
+                          kr_bit_deposit64(y, UINT64_C(0xAAAAAAAAAAAAAAAA)),
+                      kr_morton2_encode64(x, y));
+        EXPECT_UINTEQ(kr_morton2_encode64(x, y), kr_morton2_encode64_table(x, y));
+        kr_morton2_decode64(v, &x, &y);
+        EXPECT_UINTEQ(v, kr_morton2_encode64(x, y));
+
+        v &= UINT64_C(0x7FFFFFFFFFFFFFFF);
+        x = KR_CASTS(uint32_t, v & 0x1FFFFF);
+        y = KR_CASTS(uint32_t, (v >> 21) & 0x1FFFFF);
+        z = KR_CASTS(uint32_t, v >> 42);
+        EXPECT_UINTEQ(kr_bit_deposit64(x, UINT64_C(0x1249249249249249)) |
+                          kr_bit_deposit64(y, UINT64_C(0x2492492492492492)) |
+                          kr_bit_deposit64(z, UINT64_C(0x4924924924924924)),
+                      kr_morton3_encode64(x, y, z));
+        EXPECT_UINTEQ(kr_morton3_encode64(x, y, z), kr_morton3_encode64_table(x, y, z));
+        kr_morton3_decode64(v, &x, &y, &z);
+        EXPECT_UINTEQ(v, kr_morton3_encode64(x, y, z));
+    }
+
+#if (KR_CPLUSPLUS >= 201402)
+    static_assert(kr_morton3_encode64(0xFFFFFFFF, 0, 0) == UINT64_C(0x1249249249249249), "morton must be constexpr");
+#endif
+#endif /* !defined(UINT64_MAX) */
+}
+
+/******************************************************************************/
+
+TEST(curve, kr_hilbert2_encode32)
+{
+    uint16_t x = 0, y = 0, px = 0, py = 0;
+    uint32_t i = 0;
+    unsigned order = 0;
+
+    /* Order 1 is a U from (0, 0) up and over to (1, 0). */
+    EXPECT_UINTEQ(0, kr_hilbert2_encode32(0, 0, 1));
+    EXPECT_UINTEQ(1, kr_hilbert2_encode32(0, 1, 1));
+    EXPECT_UINTEQ(2, kr_hilbert2_encode32(1, 1, 1));
+    EXPECT_UINTEQ(3, kr_hilbert2_encode32(1, 0, 1));
+
+    EXPECT_UINTEQ(15, kr_hilbert2_encode32(3, 0, 2));
+    EXPECT_UINTEQ(7, kr_hilbert2_encode32(1, 2, 2));
+    EXPECT_UINTEQ(8, kr_hilbert2_encode32(2, 2, 2));
+    EXPECT_UINTEQ(28272, kr_hilbert2_encode32(100, 200, 8));
+    EXPECT_UINTEQ(1555040834u, kr_hilbert2_encode32(12345, 54321, 16));
+
+    /* Every step along the curve moves to a neighboring cell. */
+    for (order = 1; order <= 5; order++)
+    {
+        for (i = 0; i < (1u << (2 * order)); i++)
+        {
+            kr_hilbert2_decode32(i, order, &x, &y);
+            EXPECT_UINTEQ(i, kr_hilbert2_encode32(x, y, order));
+            if (i > 0)
+            {
+                EXPECT_UINTEQ(1, KR_CASTS(unsigned, (x > px ? x - px : px - x) + (y > py ? y - py : py - y)));
+            }
+            px = x;
+            py = y;
+        }
+    }
+
+    for (i = 0; i < 1000; i++)
+    {
+        kr_hilbert2_decode32(i * 2654435761u, 16, &x, &y);
+        EXPECT_UINTEQ(i * 2654435761u, kr_hilbert2_encode32(x, y, 16));
+    }
+
+#if (KR_CPLUSPLUS >= 201402)
+    static_assert(kr_hilbert2_encode32(12345, 54321, 16) == 1555040834u, "hilbert must be constexpr");
+#endif
+}
+
+TEST(curve, kr_hilbert2_encode64)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    uint32_t x = 0, y = 0;
+    uint64_t i = 0, v = 0;
+    unsigned order = 0;
+
+    EXPECT_UINTEQ(28272, kr_hilbert2_encode64(100, 200, 8));
+    EXPECT_UINTEQ(1555040834u, kr_hilbert2_encode64(12345, 54321, 16));
+    EXPECT_UINTEQ(UINT64_C(0xFFFFFFFFFFFFFFFF), kr_hilbert2_encode64(0xFFFFFFFF, 0, 32));
+
+    for (order = 1; order <= 32; order++)
+    {
+        for (i = 0; i < 100; i++)
+        {
+            v = ((i + 1) * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - 2 * order);
+            kr_hilbert2_decode64(v, order, &x, &y);
+            EXPECT_UINTEQ(v, kr_hilbert2_encode64(x, y, order));
+            if (order <= 16)
+            {
+                EXPECT_UINTEQ(v, kr_hilbert2_encode32(KR_CASTS(uint16_t, x), KR_CASTS(uint16_t, y), order));
+            }
+        }
+    }
+
+#if (KR_CPLUSPLUS >= 201402)
+    static_assert(kr_hilbert2_encode64(12345, 54321, 16) == 1555040834u, "hilbert must be constexpr");
+#endif
+#endif /* !defined(UINT64_MAX) */
+}
+
+SUITE(curve)
+{
+    SUITE_TEST(curve, kr_morton2_encode32);
+    SUITE_TEST(curve, kr_morton2_decode16);
+    SUITE_TEST(curve, kr_morton3_encode32);
+    SUITE_TEST(curve, kr_morton64);
+    SUITE_TEST(curve, kr_hilbert2_encode32);
+    SUITE_TEST(curve, kr_hilbert2_encode64);
+}
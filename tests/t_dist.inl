@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krdist.h"
+
+TEST(dist, kr_dist_double)
+{
+    struct kr_jsf32_ctx_s ctx;
+    double d = 0.0;
+    float f = 0.0f;
+    int i = 0;
+
+    kr_jsf32_srand(&ctx, 1993);
+
+    /* Results must be identical on every platform. */
+    EXPECT_UINTEQ(UINT32_C(1323812269) >> 8, KR_CASTS(uint32_t, kr_dist_float(&ctx) * 16777216.0f));
+    d = kr_dist_double(&ctx);
+    EXPECT_TRUE(d == ((UINT32_C(1220648136) >> 5) * 67108864.0 + (UINT32_C(3832904144) >> 6)) / 9007199254740992.0);
+
+    for (i = 0; i < 1000; i++)
+    {
+        d = kr_dist_double(&ctx);
+        EXPECT_TRUE(d >= 0.0 && d < 1.0);
+        f = kr_dist_float(&ctx);
+        EXPECT_TRUE(f >= 0.0f && f < 1.0f);
+    }
+}
+
+TEST(dist, kr_dist_normal)
+{
+    struct kr_jsf32_ctx_s ctx;
+    double v = 0.0, sum = 0.0, sumsq = 0.0;
+    int i = 0, outside = 0;
+
+    kr_jsf32_srand(&ctx, 1993);
+    EXPECT_TRUE(kr_dist_normal(&ctx) == -0.39357442074585774);
+    EXPECT_TRUE(kr_dist_exponential(&ctx) == 0.81605384004568893);
+
+    /* Loose checks on the moments, and that the tail gets sampled. */
+    for (i = 0; i < 100000; i++)
+    {
+        v = kr_dist_normal(&ctx);
+        sum += v;
+        sumsq += v * v;
+        outside += v < -3.5 || v > 3.5;
+    }
+    EXPECT_TRUE(sum / 100000 > -0.02 && sum / 100000 < 0.02);
+    EXPECT_TRUE(sumsq / 100000 > 0.98 && sumsq / 100000 < 1.02);
+    EXPECT_INTGT(outside, 0);
+
+    sum = 0.0;
+    for (i = 0; i < 100000; i++)
+    {
+        v = kr_dist_exponential(&ctx);
+        EXPECT_TRUE(v >= 0.0);
+        sum += v;
+        outside += v > 8.0;
+    }
+    EXPECT_TRUE(sum / 100000 > 0.98 && sum / 100000 < 1.02);
+    EXPECT_INTGT(outside, 0);
+}
+
+TEST(dist, kr_dist_alias)
+{
+    static const double weights[5] = {1.0, 0.0, 2.0, 0.5, 0.5};
+    static const double bad[3] = {1.0, -1.0, 1.0};
+    struct kr_dist_alias_s alias;
+    struct kr_jsf32_ctx_s ctx;
+    unsigned counts[5] = {0, 0, 0, 0, 0};
+    uint32_t pick = 0;
+    int i = 0;
+
+    EXPECT_FALSE(kr_dist_alias_init(&alias, bad, 3));
+    EXPECT_FALSE(kr_dist_alias_init(&alias, weights + 1, 1));
+    EXPECT_FALSE(kr_dist_alias_init(&alias, weights, 0));
+    EXPECT_TRUE(alias.prob == NULL);
+
+    EXPECT_TRUE(kr_dist_alias_init(&alias, weights, 5));
+    kr_jsf32_srand(&ctx, 1993);
+    for (i = 0; i < 40000; i++)
+    {
+        pick = kr_dist_alias_sample(&alias, &ctx);
+        EXPECT_UINTGT(5, pick);
+        counts[pick]++;
+    }
+
+    /* Expect 10000, 0, 20000, 5000 and 5000. */
+    EXPECT_UINTGT(counts[0], 9500);
+    EXPECT_UINTLT(counts[0], 10500);
+    EXPECT_UINTEQ(0, counts[1]);
+    EXPECT_UINTGT(counts[2], 19500);
+    EXPECT_UINTLT(counts[2], 20500);
+    EXPECT_UINTGT(counts[3], 4500);
+    EXPECT_UINTGT(counts[4], 4500);
+
+    kr_dist_alias_free(&alias);
+    EXPECT_TRUE(alias.prob == NULL);
+}
+
+TEST(dist, kr_dist_shuffle)
+{
+    struct kr_jsf32_ctx_s ctx;
+    char str[] = "abcdefghijklmnopqrstuvwxyz";
+    char sorted[sizeof(str)];
+    struct
+    {
+        uint32_t key;
+        char pad[100];
+    } big[10];
+    int i = 0, j = 0;
+
+    kr_jsf32_srand(&ctx, 1993);
+    kr_dist_shuffle(&ctx, str, 26, 1);
+    EXPECT_STRNE("abcdefghijklmnopqrstuvwxyz", str);
+
+    /* Still a permutation. */
+    memset(sorted, 0, sizeof(sorted));
+    for (i = 0; i < 26; i++)
+    {
+        sorted[str[i] - 'a'] = str[i];
+    }
+    EXPECT_STREQ("abcdefghijklmnopqrstuvwxyz", sorted);
+
+    /* Elements bigger than the swap buffer move intact. */
+    for (i = 0; i < 10; i++)
+    {
+        big[i].key = KR_CASTS(uint32_t, i);
+        memset(big[i].pad, 'a' + i, sizeof(big[i].pad));
+    }
+    kr_dist_shuffle(&ctx, big, 10, sizeof(big[0]));
+    for (i = 0; i < 10; i++)
+    {
+        for (j = 0; j < KR_CASTS(int, sizeof(big[i].pad)); j++)
+        {
+            EXPECT_CHAREQ(KR_CASTS(char, 'a' + big[i].key), big[i].pad[j]);
+        }
+    }
+
+    kr_dist_shuffle(&ctx, str, 0, 1);
+    kr_dist_shuffle(&ctx, str, 1, 1);
+}
+
+TEST(dist, kr_dist_reservoir)
+{
+    struct kr_jsf32_ctx_s ctx;
+    uint32_t sample[4], slot = 0, i = 0;
+    unsigned counts[20];
+    int run = 0;
+
+    memset(counts, 0, sizeof(counts));
+    kr_jsf32_srand(&ctx, 1993);
+
+    /* Every item of the stream should land in the sample equally often. */
+    for (run = 0; run < 5000; run++)
+    {
+        for (i = 0; i < 20; i++)
+        {
+            slot = kr_dist_reservoir(&ctx, i, 4);
+            if (i < 4)
+            {
+                EXPECT_UINTEQ(i, slot);
+            }
+            if (slot < 4)
+            {
+                sample[slot] = i;
+            }
+        }
+        for (i = 0; i < 4; i++)
+        {
+            counts[sample[i]]++;
+        }
+    }
+
+    for (i = 0; i < 20; i++)
+    {
+        EXPECT_UINTGT(counts[i], 850);
+        EXPECT_UINTLT(counts[i], 1150);
+    }
+}
+
+SUITE(dist)
+{
+    SUITE_TEST(dist, kr_dist_double);
+    SUITE_TEST(dist, kr_dist_normal);
+    SUITE_TEST(dist, kr_dist_alias);
+    SUITE_TEST(dist, kr_dist_shuffle);
+    SUITE_TEST(dist, kr_dist_reservoir);
+}
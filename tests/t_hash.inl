@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krhash.h"
+
+/* Fill a buffer the same way as the xxHash sanity check. */
+static void hash_sanity_buffer(unsigned char *buf, size_t len)
+{
+#if defined(UINT64_MAX)
+    uint64_t gen = UINT64_C(2654435761);
+    size_t i = 0;
+
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = KR_CASTS(unsigned char, gen >> 56);
+        gen *= UINT64_C(11400714785074694797);
+    }
+#else
+    memset(buf, 0, len);
+#endif
+}
+
+/******************************************************************************/
+
+TEST(hash, kr_hash32)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    unsigned char buf[222];
+    hash_sanity_buffer(buf, sizeof(buf));
+
+    EXPECT_UINTEQ(0x02CC5D05u, kr_hash32(buf, 0, 0));
+    EXPECT_UINTEQ(0x36B78AE7u, kr_hash32(buf, 0, 2654435761u));
+    EXPECT_UINTEQ(0xCF65B03Eu, kr_hash32(buf, 1, 0));
+    EXPECT_UINTEQ(0xB4545AA4u, kr_hash32(buf, 1, 2654435761u));
+    EXPECT_UINTEQ(0x1208E7E2u, kr_hash32(buf, 14, 0));
+    EXPECT_UINTEQ(0x6AF1D1FEu, kr_hash32(buf, 14, 2654435761u));
+    EXPECT_UINTEQ(0x5BD11DBDu, kr_hash32(buf, 222, 0));
+    EXPECT_UINTEQ(0x58803C5Fu, kr_hash32(buf, 222, 2654435761u));
+    EXPECT_UINTEQ(0x32D153FFu, kr_hash32("abc", 3, 0));
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(hash, kr_hash32_update)
+{
+    unsigned char buf[222];
+    struct kr_hash32_ctx_s ctx;
+    size_t len = 0, step = 0, i = 0;
+    hash_sanity_buffer(buf, sizeof(buf));
+
+    /* Every split of the input must match hashing it all at once. */
+    for (len = 0; len <= sizeof(buf); len += 17)
+    {
+        for (step = 1; step <= 40; step += 3)
+        {
+            kr_hash32_init(&ctx, 1234);
+            for (i = 0; i < len; i += step)
+            {
+                kr_hash32_update(&ctx, buf + i, (len - i < step) ? len - i : step);
+            }
+            EXPECT_UINTEQ(kr_hash32(buf, len, 1234), kr_hash32_final(&ctx));
+        }
+    }
+
+    kr_hash32_init(&ctx, 0);
+    kr_hash32_update(&ctx, "ab", 2);
+    kr_hash32_update(&ctx, "", 0);
+    EXPECT_UINTEQ(kr_hash32("ab", 2, 0), kr_hash32_final(&ctx));
+    kr_hash32_update(&ctx, "c", 1);
+    EXPECT_UINTEQ(0x32D153FFu, kr_hash32_final(&ctx));
+}
+
+TEST(hash, kr_hash64)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    unsigned char buf[222];
+    hash_sanity_buffer(buf, sizeof(buf));
+
+    EXPECT_UINTEQ(UINT64_C(0xEF46DB3751D8E999), kr_hash64(buf, 0, 0));
+    EXPECT_UINTEQ(UINT64_C(0xAC75FDA2929B17EF), kr_hash64(buf, 0, 2654435761u));
+    EXPECT_UINTEQ(UINT64_C(0xE934A84ADB052768), kr_hash64(buf, 1, 0));
+    EXPECT_UINTEQ(UINT64_C(0x5014607643A9B4C3), kr_hash64(buf, 1, 2654435761u));
+    EXPECT_UINTEQ(UINT64_C(0x8282DCC4994E35C8), kr_hash64(buf, 14, 0));
+    EXPECT_UINTEQ(UINT64_C(0xC3BD6BF63DEB6DF0), kr_hash64(buf, 14, 2654435761u));
+    EXPECT_UINTEQ(UINT64_C(0xB641AE8CB691C174), kr_hash64(buf, 222, 0));
+    EXPECT_UINTEQ(UINT64_C(0x20CB8AB7AE10C14A), kr_hash64(buf, 222, 2654435761u));
+    EXPECT_UINTEQ(UINT64_C(0x44BC2CF5AD770999), kr_hash64("abc", 3, 0));
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(hash, kr_hash64_update)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else  /* !defined(UINT64_MAX) */
+    unsigned char buf[222];
+    struct kr_hash64_ctx_s ctx;
+    size_t len = 0, step = 0, i = 0;
+    hash_sanity_buffer(buf, sizeof(buf));
+
+    for (len = 0; len <= sizeof(buf); len += 17)
+    {
+        for (step = 1; step <= 70; step += 3)
+        {
+            kr_hash64_init(&ctx, 1234);
+            for (i = 0; i < len; i += step)
+            {
+                kr_hash64_update(&ctx, buf + i, (len - i < step) ? len - i : step);
+            }
+            EXPECT_UINTEQ(kr_hash64(buf, len, 1234), kr_hash64_final(&ctx));
+        }
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(hash, kr_hash_mix)
+{
+    EXPECT_UINTEQ(0, kr_hash_mix32(0));
+    EXPECT_UINTNE(kr_hash_mix32(1), kr_hash_mix32(2));
+#if defined(UINT64_MAX)
+    EXPECT_UINTEQ(0, kr_hash_mix64(0));
+    EXPECT_UINTNE(kr_hash_mix64(1), kr_hash_mix64(2));
+#endif
+
+#if (KR_CPLUSPLUS >= 201402)
+    static_assert(kr_hash_mix32(0) == 0, "mix must be constexpr");
+    static_assert(kr_hash_mix64(0) == 0, "mix must be constexpr");
+#endif
+}
+
+SUITE(hash)
+{
+    SUITE_TEST(hash, kr_hash32);
+    SUITE_TEST(hash, kr_hash32_update);
+    SUITE_TEST(hash, kr_hash64);
+    SUITE_TEST(hash, kr_hash64_update);
+    SUITE_TEST(hash, kr_hash_mix);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krintern.h"
+
+/* Write "label" followed by the decimal digits of n. */
+static void intern_label(char *buf, size_t n)
+{
+    char digits[24];
+    size_t len = 0;
+
+    do
+    {
+        digits[len++] = KR_CASTS(char, '0' + n % 10);
+        n /= 10;
+    } while (n != 0);
+
+    memcpy(buf, "label", 5);
+    buf += 5;
+    while (len != 0)
+    {
+        *buf++ = digits[--len];
+    }
+    *buf = '\0';
+}
+
+TEST(intern, kr_intern_str)
+{
+    struct kr_intern_s intern;
+    char buf[8];
+    const char *a = NULL, *b = NULL, *c = NULL;
+
+    kr_intern_init(&intern, 64);
+    EXPECT_UINTEQ(0, kr_intern_count(&intern));
+    EXPECT_TRUE(kr_intern_find(&intern, "host", 4) == NULL);
+
+    a = kr_intern_str(&intern, "host");
+    ASSERT_TRUE(a != NULL);
+    EXPECT_STREQ("host", a);
+
+    /* A different buffer with the same contents gives the same pointer. */
+    kr_strlcpy(buf, "host", sizeof(buf));
+    b = kr_intern_str(&intern, buf);
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a != buf);
+    EXPECT_UINTEQ(1, kr_intern_count(&intern));
+
+    c = kr_intern_str(&intern, "hostname");
+    ASSERT_TRUE(c != NULL);
+    EXPECT_TRUE(a != c);
+    EXPECT_TRUE(kr_intern_find(&intern, "hostname", 8) == c);
+    EXPECT_TRUE(kr_intern_find(&intern, "hostname", 4) == a);
+    EXPECT_UINTEQ(2, kr_intern_count(&intern));
+
+    /* The empty string is a string like any other. */
+    a = kr_intern_str(&intern, "");
+    ASSERT_TRUE(a != NULL);
+    EXPECT_STREQ("", a);
+    EXPECT_TRUE(kr_intern_strn(&intern, "xyz", 0) == a);
+    EXPECT_TRUE(kr_intern_strn(&intern, NULL, 0) == a);
+    EXPECT_UINTEQ(3, kr_intern_count(&intern));
+
+    kr_intern_clear(&intern);
+    EXPECT_UINTEQ(0, kr_intern_count(&intern));
+    EXPECT_TRUE(kr_intern_find(&intern, "host", 4) == NULL);
+    a = kr_intern_str(&intern, "region");
+    ASSERT_TRUE(a != NULL);
+    EXPECT_STREQ("region", a);
+
+    kr_intern_free(&intern);
+}
+
+TEST(intern, kr_intern_strn)
+{
+    static const char nul[] = {'a', '\0', 'b'};
+    struct kr_intern_s intern;
+    char buf[16];
+    const char *ptrs[500];
+    const char *a = NULL, *b = NULL;
+    size_t i = 0;
+    bool ok = true;
+
+    kr_intern_init(&intern, 64);
+
+    /* Strings may hold nulls, and a prefix is a different string. */
+    a = kr_intern_strn(&intern, nul, 3);
+    b = kr_intern_strn(&intern, nul, 1);
+    ASSERT_TRUE(a != NULL && b != NULL);
+    EXPECT_TRUE(a != b);
+    EXPECT_TRUE(memcmp(a, nul, 3) == 0);
+    EXPECT_CHAREQ('\0', a[3]);
+    EXPECT_TRUE(kr_intern_strn(&intern, "a", 1) == b);
+
+    /* Enough strings to grow the map and fill several blocks. */
+    for (i = 0; i < 500; i++)
+    {
+        intern_label(buf, i);
+        ptrs[i] = kr_intern_str(&intern, buf);
+        ok = ok && ptrs[i] != NULL && strcmp(ptrs[i], buf) == 0;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_UINTEQ(502, kr_intern_count(&intern));
+
+    /* Earlier pointers stay valid and are found again. */
+    for (i = 0; i < 500; i++)
+    {
+        intern_label(buf, i);
+        ok = ok && kr_intern_str(&intern, buf) == ptrs[i];
+        ok = ok && kr_intern_find(&intern, buf, strlen(buf)) == ptrs[i];
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_UINTEQ(502, kr_intern_count(&intern));
+    EXPECT_TRUE(kr_intern_strn(&intern, nul, 3) == a);
+
+    kr_intern_free(&intern);
+}
+
+SUITE(intern)
+{
+    SUITE_TEST(intern, kr_intern_str);
+    SUITE_TEST(intern, kr_intern_strn);
+}
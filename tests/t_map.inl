@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krmap.h"
+#include "krrand.h"
+
+/* Puts every key in one of a few long runs, some wrapping past the end of
+ * the table, to exercise probing and shifting. */
+static size_t map_bad_hash(const void *key, size_t keySize)
+{
+    uint32_t k = 0;
+    (void)keySize;
+    memcpy(&k, key, sizeof(k));
+    return (SIZE_MAX - 2) - k % 5 + (KR_CASTS(size_t, k % 3) << (KR_SIZEOF_SIZE_T * 8 - 7));
+}
+
+/* Counts calls, and puts keys in long runs like map_bad_hash. */
+static size_t map_hash_calls = 0;
+
+static size_t map_counted_hash(const void *key, size_t keySize)
+{
+    map_hash_calls++;
+    return map_bad_hash(key, keySize);
+}
+
+static bool map_str_equal(const void *a, const void *b, size_t keySize)
+{
+    const char *sa = NULL, *sb = NULL;
+    (void)keySize;
+    memcpy(&sa, a, sizeof(sa));
+    memcpy(&sb, b, sizeof(sb));
+    return strcmp(sa, sb) == 0;
+}
+
+static size_t map_str_hash(const void *key, size_t keySize)
+{
+    const char *s = NULL;
+    (void)keySize;
+    memcpy(&s, key, sizeof(s));
+    return kr_map_hash_bytes(s, strlen(s));
+}
+
+/* Check a map of uint32_t to uint32_t against a model of present keys. */
+static bool map_check_model(const struct kr_map_s *map, const bool *present, const uint32_t *model, uint32_t n)
+{
+    uint32_t k = 0, count = 0;
+    const uint32_t *v = NULL;
+
+    for (k = 0; k < n; k++)
+    {
+        v = KR_CASTS(const uint32_t *, kr_map_find(map, &k));
+        if (present[k] ? (v == NULL || *v != model[k]) : v != NULL)
+        {
+            return false;
+        }
+        count += present[k] ? 1 : 0;
+    }
+    return count == map->count;
+}
+
+/******************************************************************************/
+
+TEST(map, kr_map_insert)
+{
+    struct kr_map_s map;
+    uint32_t k = 0, *v = NULL;
+    bool inserted = false;
+
+    kr_map_init(&map, sizeof(uint32_t), sizeof(uint32_t), NULL, NULL);
+    EXPECT_TRUE(kr_map_find(&map, &k) == NULL);
+    EXPECT_FALSE(kr_map_remove(&map, &k));
+
+    for (k = 0; k < 5000; k++)
+    {
+        v = KR_CASTS(uint32_t *, kr_map_insert(&map, &k, &inserted));
+        ASSERT_TRUE(v != NULL);
+        EXPECT_TRUE(inserted);
+        *v = k * 3;
+    }
+    EXPECT_UINTEQ(5000, map.count);
+
+    k = 1234;
+    v = KR_CASTS(uint32_t *, kr_map_insert(&map, &k, &inserted));
+    ASSERT_TRUE(v != NULL);
+    EXPECT_FALSE(inserted);
+    EXPECT_UINTEQ(1234 * 3, *v);
+    EXPECT_UINTEQ(5000, map.count);
+
+    for (k = 0; k < 5000; k++)
+    {
+        v = KR_CASTS(uint32_t *, kr_map_find(&map, &k));
+        ASSERT_TRUE(v != NULL);
+        EXPECT_UINTEQ(k * 3, *v);
+    }
+    k = 5000;
+    EXPECT_TRUE(kr_map_find(&map, &k) == NULL);
+
+    kr_map_free(&map);
+    EXPECT_UINTEQ(0, map.count);
+    EXPECT_UINTEQ(0, map.cap);
+}
+
+TEST(map, kr_map_remove)
+{
+    struct kr_map_s map;
+    uint32_t k = 0, *v = NULL;
+
+    kr_map_init(&map, sizeof(uint32_t), sizeof(uint32_t), NULL, NULL);
+    for (k = 0; k < 1000; k++)
+    {
+        v = KR_CASTS(uint32_t *, kr_map_insert(&map, &k, NULL));
+        ASSERT_TRUE(v != NULL);
+        *v = k;
+    }
+
+    for (k = 0; k < 1000; k += 2)
+    {
+        EXPECT_TRUE(kr_map_remove(&map, &k));
+        EXPECT_FALSE(kr_map_remove(&map, &k));
+    }
+    EXPECT_UINTEQ(500, map.count);
+
+    for (k = 0; k < 1000; k++)
+    {
+        v = KR_CASTS(uint32_t *, kr_map_find(&map, &k));
+        if (k % 2 == 0)
+        {
+            EXPECT_TRUE(v == NULL);
+        }
+        else
+        {
+            ASSERT_TRUE(v != NULL);
+            EXPECT_UINTEQ(k, *v);
+        }
+    }
+
+    kr_map_free(&map);
+}
+
+TEST(map, kr_map_model)
+{
+    struct kr_map_s map;
+    struct kr_jsf32_ctx_s ctx;
+    bool present[300];
+    uint32_t model[300];
+    uint32_t i = 0, k = 0, *v = NULL;
+    bool inserted = false, ok = true;
+
+    /* Random operations with a hash that collides constantly. */
+    kr_map_init(&map, sizeof(uint32_t), sizeof(uint32_t), map_bad_hash, NULL);
+    kr_jsf32_srand(&ctx, 1993);
+    memset(present, 0, sizeof(present));
+
+    for (i = 0; i < 10000 && ok; i++)
+    {
+        k = kr_jsf32_rand_uniform(&ctx, 300);
+        if (kr_jsf32_rand_uniform(&ctx, 3) != 0)
+        {
+            v = KR_CASTS(uint32_t *, kr_map_insert(&map, &k, &inserted));
+            ASSERT_TRUE(v != NULL);
+            EXPECT_BOOLEQ(!present[k], inserted);
+            *v = model[k] = i;
+            present[k] = true;
+        }
+        else
+        {
+            EXPECT_BOOLEQ(present[k], kr_map_remove(&map, &k));
+            EXPECT_TRUE(kr_map_find(&map, &k) == NULL);
+            present[k] = false;
+        }
+        if (i % 250 == 0)
+        {
+            ok = map_check_model(&map, present, model, 300);
+        }
+    }
+    EXPECT_TRUE(map_check_model(&map, present, model, 300));
+    EXPECT_TRUE(ok);
+
+    kr_map_clear(&map);
+    EXPECT_UINTEQ(0, map.count);
+    k = 1;
+    EXPECT_TRUE(kr_map_find(&map, &k) == NULL);
+
+    kr_map_free(&map);
+}
+
+TEST(map, kr_map_next)
+{
+    struct kr_map_s map;
+    uint32_t k = 0, seen = 0, sum = 0;
+    size_t slot = 0;
+
+    /* A set, so values are the keys themselves. */
+    kr_map_init(&map, sizeof(uint32_t), 0, NULL, NULL);
+    EXPECT_UINTEQ(map.cap, kr_map_next(&map, 0));
+    for (k = 1; k <= 100; k++)
+    {
+        ASSERT_TRUE(kr_map_insert(&map, &k, NULL) != NULL);
+    }
+    k = 50;
+    EXPECT_UINTEQ(50, *KR_CASTS(uint32_t *, kr_map_find(&map, &k)));
+
+    for (slot = kr_map_next(&map, 0); slot < map.cap; slot = kr_map_next(&map, slot + 1))
+    {
+        memcpy(&k, kr_map_key(&map, slot), sizeof(k));
+        EXPECT_TRUE(kr_map_key(&map, slot) == kr_map_value(&map, slot));
+        sum += k;
+        seen++;
+    }
+    EXPECT_UINTEQ(100, seen);
+    EXPECT_UINTEQ(5050, sum);
+
+    kr_map_free(&map);
+}
+
+TEST(map, kr_map_reserve)
+{
+    struct kr_map_s map;
+    const char *keys[] = {"plugh", "xyzzy", "plover", "frotz"};
+    char buf[8];
+    const char *key = buf;
+    size_t cap = 0, i = 0;
+    int *v = NULL;
+
+    kr_map_init(&map, sizeof(const char *), sizeof(int), map_str_hash, map_str_equal);
+    EXPECT_TRUE(kr_map_reserve(&map, 1000));
+    cap = map.cap;
+    EXPECT_UINTGE(cap - cap / 8, 1000);
+
+    for (i = 0; i < 4; i++)
+    {
+        v = KR_CASTS(int *, kr_map_insert(&map, &keys[i], NULL));
+        ASSERT_TRUE(v != NULL);
+        *v = KR_CASTS(int, i);
+    }
+    EXPECT_UINTEQ(cap, map.cap);
+
+    /* Found by contents, not by pointer. */
+    strcpy(buf, "plover");
+    v = KR_CASTS(int *, kr_map_find(&map, &key));
+    ASSERT_TRUE(v != NULL);
+    EXPECT_INTEQ(2, *v);
+
+    kr_map_free(&map);
+}
+
+TEST(map, kr_map_full)
+{
+    struct kr_map_s map;
+    uint32_t k = 0, missing = 1000;
+    size_t cap = 0;
+
+    /* Fill the first table until it grows.  Until then a slot must stay
+     * empty, or a miss would probe forever. */
+    kr_map_init(&map, sizeof(uint32_t), sizeof(uint32_t), map_bad_hash, NULL);
+    ASSERT_TRUE(kr_map_insert(&map, &k, NULL) != NULL);
+    cap = map.cap;
+    for (k = 1; map.cap == cap; k++)
+    {
+        EXPECT_UINTLT(map.count, map.cap);
+        EXPECT_TRUE(kr_map_find(&map, &missing) == NULL);
+        EXPECT_FALSE(kr_map_remove(&map, &missing));
+        ASSERT_TRUE(kr_map_insert(&map, &k, NULL) != NULL);
+    }
+    EXPECT_UINTGT(map.cap, cap);
+    EXPECT_UINTEQ(k, map.count);
+
+    kr_map_free(&map);
+}
+
+TEST(map, kr_map_hash)
+{
+    struct kr_map_s map;
+    uint32_t k = 0;
+
+    /* Growing and shifting use the stored hashes, so every call hashes
+     * only the key it was given. */
+    kr_map_init(&map, sizeof(uint32_t), sizeof(uint32_t), map_counted_hash, NULL);
+    map_hash_calls = 0;
+    for (k = 0; k < 1000; k++)
+    {
+        ASSERT_TRUE(kr_map_insert(&map, &k, NULL) != NULL);
+    }
+    EXPECT_UINTEQ(1000, map_hash_calls);
+
+    map_hash_calls = 0;
+    for (k = 0; k < 1000; k += 2)
+    {
+        EXPECT_TRUE(kr_map_remove(&map, &k));
+    }
+    EXPECT_UINTEQ(500, map_hash_calls);
+    for (k = 1; k < 1000; k += 2)
+    {
+        EXPECT_TRUE(kr_map_find(&map, &k) != NULL);
+    }
+
+    kr_map_free(&map);
+}
+
+SUITE(map)
+{
+    SUITE_TEST(map, kr_map_insert);
+    SUITE_TEST(map, kr_map_remove);
+    SUITE_TEST(map, kr_map_model);
+    SUITE_TEST(map, kr_map_next);
+    SUITE_TEST(map, kr_map_reserve);
+    SUITE_TEST(map, kr_map_full);
+    SUITE_TEST(map, kr_map_hash);
+}
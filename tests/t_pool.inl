@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krpool.h"
+
+#define POOL_COUNT 100
+
+TEST(pool, kr_pool_init)
+{
+    struct kr_pool_s pool;
+
+    /* A slab with no cells would never satisfy an allocation. */
+    EXPECT_FALSE(kr_pool_init(&pool, 16, 0));
+    EXPECT_TRUE(kr_pool_init(&pool, 16, 1));
+    EXPECT_TRUE(kr_pool_alloc(&pool) != NULL);
+    EXPECT_TRUE(kr_pool_alloc(&pool) != NULL);
+
+    kr_pool_destroy(&pool);
+}
+
+TEST(pool, kr_pool_alloc)
+{
+    struct kr_pool_s pool;
+    unsigned char *ptrs[POOL_COUNT];
+    size_t i = 0, j = 0;
+
+    ASSERT_TRUE(kr_pool_init(&pool, 24, 16));
+    EXPECT_UINTGE(pool.cellSize, 24);
+    EXPECT_UINTEQ(0, pool.cellSize % KR_POOL_ALIGN);
+
+    /* Cells are aligned, and no two cells overlap. */
+    for (i = 0; i < POOL_COUNT; i++)
+    {
+        ptrs[i] = KR_CASTS(unsigned char *, kr_pool_alloc(&pool));
+        EXPECT_TRUE(ptrs[i] != NULL);
+        EXPECT_UINTEQ(0, KR_CASTR(uintptr_t, ptrs[i]) % KR_POOL_ALIGN);
+        memset(ptrs[i], KR_CASTS(int, i), 24);
+    }
+    for (i = 0; i < POOL_COUNT; i++)
+    {
+        for (j = 0; j < 24; j++)
+        {
+            EXPECT_UINTEQ(i, ptrs[i][j]);
+        }
+    }
+
+    /* Freed cells are reused most-recent first. */
+    kr_pool_free(&pool, ptrs[10]);
+    kr_pool_free(&pool, ptrs[20]);
+    kr_pool_free(&pool, NULL);
+    EXPECT_TRUE(kr_pool_alloc(&pool) == ptrs[20]);
+    EXPECT_TRUE(kr_pool_alloc(&pool) == ptrs[10]);
+
+    kr_pool_destroy(&pool);
+}
+
+TEST(pool, kr_pool_freeall)
+{
+    struct kr_pool_s pool;
+    void *first = NULL, *ptr = NULL;
+    size_t i = 0;
+
+    ASSERT_TRUE(kr_pool_init(&pool, 1, 8));
+    EXPECT_UINTGE(pool.cellSize, sizeof(void *));
+
+    first = kr_pool_alloc(&pool);
+    for (i = 1; i < POOL_COUNT; i++)
+    {
+        ptr = kr_pool_alloc(&pool);
+        EXPECT_TRUE(ptr != NULL);
+    }
+
+    /* Every slab is reused in the same order after freeing everything. */
+    kr_pool_freeall(&pool);
+    EXPECT_TRUE(kr_pool_alloc(&pool) == first);
+    for (i = 1; i < POOL_COUNT; i++)
+    {
+        ptr = kr_pool_alloc(&pool);
+        EXPECT_TRUE(ptr != NULL);
+    }
+
+    kr_pool_destroy(&pool);
+}
+
+TEST(pool, kr_pool_cache)
+{
+    static KR_THREAD struct kr_pool_cache_s cache;
+    struct kr_pool_s pool;
+    void *ptrs[POOL_COUNT];
+    size_t i = 0;
+
+    ASSERT_TRUE(kr_pool_init(&pool, 32, 16));
+
+    for (i = 0; i < POOL_COUNT; i++)
+    {
+        ptrs[i] = kr_pool_cache_alloc(&cache, &pool);
+        EXPECT_TRUE(ptrs[i] != NULL);
+    }
+    EXPECT_UINTLT(cache.count, KR_CONFIG_POOL_CACHEBATCH);
+
+    /* Freeing more than two batches sends cells back to the pool. */
+    for (i = 0; i < POOL_COUNT; i++)
+    {
+        kr_pool_cache_free(&cache, &pool, ptrs[i]);
+    }
+    EXPECT_UINTLT(cache.count, KR_CONFIG_POOL_CACHEBATCH * 2);
+    EXPECT_TRUE(pool.free != NULL);
+
+    kr_pool_cache_flush(&cache, &pool);
+    EXPECT_UINTEQ(0, cache.count);
+    EXPECT_TRUE(cache.free == NULL);
+
+    kr_pool_destroy(&pool);
+}
+
+SUITE(pool)
+{
+    SUITE_TEST(pool, kr_pool_init);
+    SUITE_TEST(pool, kr_pool_alloc);
+    SUITE_TEST(pool, kr_pool_freeall);
+    SUITE_TEST(pool, kr_pool_cache);
+}
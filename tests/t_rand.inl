@@ -58,10 +58,239 @@ TEST(rand, jsf64)
 #endif /* !defined(UINT64_MAX) */
 }
 
+TEST(rand, jsf32_fill)
+{
+    struct kr_jsf32_ctx_s ctx, ref;
+    uint32_t buf[37];
+    size_t i = 0;
+
+    kr_jsf32_srand(&ctx, 1993);
+    kr_jsf32_srand(&ref, 1993);
+
+    /* Filling must match calling rand one at a time, across several calls. */
+    kr_jsf32_fill(&ctx, buf, 0);
+    kr_jsf32_fill(&ctx, buf, 3);
+    EXPECT_UINTEQ(UINT32_C(1323812269), buf[0]);
+    EXPECT_UINTEQ(UINT32_C(1220648136), buf[1]);
+    EXPECT_UINTEQ(UINT32_C(3832904144), buf[2]);
+    (void)kr_jsf32_rand(&ref), (void)kr_jsf32_rand(&ref), (void)kr_jsf32_rand(&ref);
+
+    kr_jsf32_fill(&ctx, buf, 37);
+    for (i = 0; i < 37; i++)
+    {
+        EXPECT_UINTEQ(kr_jsf32_rand(&ref), buf[i]);
+    }
+}
+
+TEST(rand, jsf32x8)
+{
+    static const uint32_t seeds[8] = {1993, 1, 2, 3, 0, 42, 0xFFFFFFFF, 1234567};
+    struct kr_jsf32x8_ctx_s ctx;
+    struct kr_jsf32_ctx_s lanes[8];
+    uint32_t buf[8 * 5 + 3];
+    size_t i = 0;
+
+    kr_jsf32x8_srand(&ctx, seeds);
+    for (i = 0; i < 8; i++)
+    {
+        kr_jsf32_srand(&lanes[i], seeds[i]);
+    }
+
+    /* Each lane is an independent jsf32 stream, interleaved in the buffer. */
+    kr_jsf32x8_fill(&ctx, buf, 8 * 5 + 3);
+    EXPECT_UINTEQ(UINT32_C(1323812269), buf[0]);
+    EXPECT_UINTEQ(UINT32_C(1220648136), buf[8]);
+    for (i = 0; i < 8 * 5 + 3; i++)
+    {
+        EXPECT_UINTEQ(kr_jsf32_rand(&lanes[i % 8]), buf[i]);
+    }
+
+    /* The tail step advances every lane. */
+    for (i = 3; i < 8; i++)
+    {
+        (void)kr_jsf32_rand(&lanes[i]);
+    }
+    kr_jsf32x8_rand(&ctx, buf);
+    for (i = 0; i < 8; i++)
+    {
+        EXPECT_UINTEQ(kr_jsf32_rand(&lanes[i]), buf[i]);
+    }
+}
+
+TEST(rand, jsf64_fill)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    static const uint64_t seeds[4] = {1993, 1, 0, 42};
+    struct kr_jsf64_ctx_s ctx, lanes[4];
+    struct kr_jsf64x4_ctx_s ctx4;
+    uint64_t buf[4 * 3 + 1];
+    size_t i = 0;
+
+    kr_jsf64_srand(&ctx, 1993);
+    kr_jsf64_fill(&ctx, buf, 4);
+    EXPECT_UINTEQ(UINT64_C(866240615393628892), buf[0]);
+    EXPECT_UINTEQ(UINT64_C(4516034199495256649), buf[1]);
+    EXPECT_UINTEQ(UINT64_C(10153722626954818142), buf[2]);
+    EXPECT_UINTEQ(UINT64_C(16680399593301785108), buf[3]);
+
+    kr_jsf64x4_srand(&ctx4, seeds);
+    for (i = 0; i < 4; i++)
+    {
+        kr_jsf64_srand(&lanes[i], seeds[i]);
+    }
+    kr_jsf64x4_fill(&ctx4, buf, 4 * 3 + 1);
+    EXPECT_UINTEQ(UINT64_C(866240615393628892), buf[0]);
+    for (i = 0; i < 4 * 3 + 1; i++)
+    {
+        EXPECT_UINTEQ(kr_jsf64_rand(&lanes[i % 4]), buf[i]);
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(rand, rand_uniform)
+{
+    struct kr_jsf8_ctx_s ctx8, copy8;
+    struct kr_jsf16_ctx_s ctx16, copy16;
+    struct kr_jsf32_ctx_s ctx32, copy32;
+    int i = 0;
+
+    kr_jsf8_srand(&ctx8, 201u);
+    kr_jsf16_srand(&ctx16, 1993);
+    kr_jsf32_srand(&ctx32, 1993);
+
+    /* Results must be identical on every platform. */
+    EXPECT_UINTEQ(7, kr_jsf8_rand_uniform(&ctx8, 100));
+    EXPECT_UINTEQ(14, kr_jsf8_rand_uniform(&ctx8, 100));
+    EXPECT_UINTEQ(943, kr_jsf16_rand_uniform(&ctx16, 1000));
+    EXPECT_UINTEQ(704, kr_jsf16_rand_uniform(&ctx16, 1000));
+    EXPECT_UINTEQ(UINT32_C(308224), kr_jsf32_rand_uniform(&ctx32, UINT32_C(1000000)));
+    EXPECT_UINTEQ(UINT32_C(284204), kr_jsf32_rand_uniform(&ctx32, UINT32_C(1000000)));
+
+    /* Trivial bounds do not use up a number. */
+    copy8 = ctx8, copy16 = ctx16, copy32 = ctx32;
+    EXPECT_UINTEQ(0, kr_jsf8_rand_uniform(&ctx8, 0));
+    EXPECT_UINTEQ(0, kr_jsf16_rand_uniform(&ctx16, 1));
+    EXPECT_UINTEQ(0, kr_jsf32_rand_uniform(&ctx32, 1));
+    EXPECT_UINTEQ(kr_jsf8_rand(&copy8), kr_jsf8_rand(&ctx8));
+    EXPECT_UINTEQ(kr_jsf16_rand(&copy16), kr_jsf16_rand(&ctx16));
+    EXPECT_UINTEQ(kr_jsf32_rand(&copy32), kr_jsf32_rand(&ctx32));
+
+    for (i = 0; i < 1000; i++)
+    {
+        EXPECT_UINTGT(3, kr_jsf8_rand_uniform(&ctx8, 3));
+        EXPECT_UINTGT(255, kr_jsf8_rand_uniform(&ctx8, 255));
+        EXPECT_UINTGT(40000, kr_jsf16_rand_uniform(&ctx16, 40000));
+        EXPECT_UINTGT(UINT32_C(3000000000), kr_jsf32_rand_uniform(&ctx32, UINT32_C(3000000000)));
+    }
+}
+
+TEST(rand, rand_uniform64)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    struct kr_jsf64_ctx_s ctx;
+    uint64_t lo = 0;
+    int i = 0;
+
+    EXPECT_UINTEQ(UINT64_C(0xFFFFFFFFFFFFFFFE),
+                  kr_rand_mul64_detail_(UINT64_C(0xFFFFFFFFFFFFFFFF), UINT64_C(0xFFFFFFFFFFFFFFFF), &lo));
+    EXPECT_UINTEQ(1, lo);
+    EXPECT_UINTEQ(UINT64_C(0x0121FA00AD77D742),
+                  kr_rand_mul64_detail_(UINT64_C(0x123456789ABCDEF0), UINT64_C(0x0FEDCBA987654321), &lo));
+    EXPECT_UINTEQ(UINT64_C(0x2236D88FE5618CF0), lo);
+
+    /* The portable fallback gives the same products. */
+    EXPECT_UINTEQ(UINT64_C(0xFFFFFFFFFFFFFFFE),
+                  kr_rand_mul64_split_detail_(UINT64_C(0xFFFFFFFFFFFFFFFF), UINT64_C(0xFFFFFFFFFFFFFFFF), &lo));
+    EXPECT_UINTEQ(1, lo);
+    EXPECT_UINTEQ(UINT64_C(0x0121FA00AD77D742),
+                  kr_rand_mul64_split_detail_(UINT64_C(0x123456789ABCDEF0), UINT64_C(0x0FEDCBA987654321), &lo));
+    EXPECT_UINTEQ(UINT64_C(0x2236D88FE5618CF0), lo);
+
+    kr_jsf64_srand(&ctx, 1993);
+    EXPECT_UINTEQ(UINT64_C(46958997855), kr_jsf64_rand_uniform(&ctx, UINT64_C(1000000000000)));
+    EXPECT_UINTEQ(UINT64_C(244814704505), kr_jsf64_rand_uniform(&ctx, UINT64_C(1000000000000)));
+    EXPECT_UINTEQ(0, kr_jsf64_rand_uniform(&ctx, 1));
+
+    for (i = 0; i < 1000; i++)
+    {
+        EXPECT_UINTGT(UINT64_C(0xC000000000000000), kr_jsf64_rand_uniform(&ctx, UINT64_C(0xC000000000000000)));
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(rand, jsf32_split)
+{
+    struct kr_jsf32_ctx_s parent, copy, child, again;
+    uint32_t first[64];
+    uint32_t i = 0, j = 0;
+
+    kr_jsf32_srand(&parent, 1993);
+    copy = parent;
+
+    /* Children are reproducible and known across platforms. */
+    kr_jsf32_split(&parent, &child, 0);
+    EXPECT_UINTEQ(UINT32_C(2873932000), kr_jsf32_rand(&child));
+    kr_jsf32_split(&parent, &child, 1);
+    EXPECT_UINTEQ(UINT32_C(1098962844), kr_jsf32_rand(&child));
+
+    /* Splitting in any order gives the same children. */
+    kr_jsf32_split(&parent, &child, 7);
+    kr_jsf32_split(&parent, &again, 3);
+    kr_jsf32_split(&parent, &again, 7);
+    EXPECT_UINTEQ(kr_jsf32_rand(&again), kr_jsf32_rand(&child));
+
+    /* The parent is untouched. */
+    EXPECT_UINTEQ(copy.a, parent.a);
+    EXPECT_UINTEQ(copy.d, parent.d);
+
+    /* Different streams start in different places. */
+    for (i = 0; i < 64; i++)
+    {
+        kr_jsf32_split(&parent, &child, i);
+        first[i] = kr_jsf32_rand(&child);
+        for (j = 0; j < i; j++)
+        {
+            EXPECT_UINTNE(first[j], first[i]);
+        }
+    }
+}
+
+TEST(rand, jsf64_split)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    struct kr_jsf64_ctx_s parent, child, again;
+
+    kr_jsf64_srand(&parent, 1993);
+
+    kr_jsf64_split(&parent, &child, 0);
+    EXPECT_UINTEQ(UINT64_C(395546738843042352), kr_jsf64_rand(&child));
+    kr_jsf64_split(&parent, &child, 1);
+    EXPECT_UINTEQ(UINT64_C(17837071911361064644), kr_jsf64_rand(&child));
+
+    /* Children of a child differ from children of the parent. */
+    kr_jsf64_split(&child, &again, 1);
+    kr_jsf64_split(&parent, &child, 1);
+    EXPECT_UINTNE(kr_jsf64_rand(&child), kr_jsf64_rand(&again));
+#endif /* !defined(UINT64_MAX) */
+}
+
 SUITE(rand)
 {
     SUITE_TEST(rand, jsf8);
     SUITE_TEST(rand, jsf16);
     SUITE_TEST(rand, jsf32);
     SUITE_TEST(rand, jsf64);
+    SUITE_TEST(rand, jsf32_fill);
+    SUITE_TEST(rand, jsf32x8);
+    SUITE_TEST(rand, jsf64_fill);
+    SUITE_TEST(rand, rand_uniform);
+    SUITE_TEST(rand, rand_uniform64);
+    SUITE_TEST(rand, jsf32_split);
+    SUITE_TEST(rand, jsf64_split);
 }
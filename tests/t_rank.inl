@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krrand.h"
+#include "krrank.h"
+
+TEST(rank, kr_popcount_array)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    struct kr_jsf64_ctx_s ctx;
+    uint64_t words[100];
+    uint64_t expected = 0;
+    size_t i = 0, n = 0;
+
+    kr_jsf64_srand(&ctx, 1993);
+    for (i = 0; i < 100; i++)
+    {
+        words[i] = kr_jsf64_rand(&ctx);
+    }
+
+    EXPECT_UINTEQ(0, kr_popcount_array(words, 0));
+
+    /* Every length, to cover each vector and tail path. */
+    for (n = 0; n <= 100; n++)
+    {
+        EXPECT_UINTEQ(expected, kr_popcount_array(words, n));
+        if (n < 100)
+        {
+            expected += kr_count_ones64(words[n]);
+        }
+    }
+
+    /* Byte counters must not overflow on all-ones input. */
+    memset(words, 0xFF, sizeof(words));
+    EXPECT_UINTEQ(6400, kr_popcount_array(words, 100));
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(rank, kr_rank)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    static const size_t sizes[6] = {0, 1, 64, 512, 1000, 5000};
+    struct kr_jsf64_ctx_s ctx;
+    struct kr_rank_s rs;
+    uint64_t words[5000 / 64 + 1];
+    uint64_t ones = 0;
+    size_t i = 0, pos = 0, nbits = 0, density = 0;
+
+    kr_jsf64_srand(&ctx, 1993);
+
+    for (density = 0; density < 3; density++)
+    {
+        for (i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+        {
+            /* Dense, half and sparse bit vectors. */
+            words[i] = kr_jsf64_rand(&ctx);
+            words[i] |= density == 0 ? kr_jsf64_rand(&ctx) : 0;
+            words[i] &= density == 2 ? kr_jsf64_rand(&ctx) & kr_jsf64_rand(&ctx) & kr_jsf64_rand(&ctx) : words[i];
+        }
+
+        for (i = 0; i < 6; i++)
+        {
+            nbits = sizes[i];
+            EXPECT_TRUE(kr_rank_init(&rs, words, nbits));
+
+            /* Compare with a naive scan at every position. */
+            ones = 0;
+            for (pos = 0; pos <= nbits; pos++)
+            {
+                EXPECT_UINTEQ(ones, kr_rank1(&rs, pos));
+                EXPECT_UINTEQ(pos - ones, kr_rank0(&rs, pos));
+                if (pos < nbits && ((words[pos / 64] >> (pos % 64)) & 1))
+                {
+                    EXPECT_UINTEQ(pos, kr_select1(&rs, ones));
+                    ones++;
+                }
+            }
+            EXPECT_UINTEQ(ones, rs.ones);
+            EXPECT_UINTEQ(nbits, kr_select1(&rs, ones));
+
+            kr_rank_free(&rs);
+        }
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+SUITE(rank)
+{
+    SUITE_TEST(rank, kr_popcount_array);
+    SUITE_TEST(rank, kr_rank);
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krring.h"
+
+#if (KR_CPLUSPLUS >= 201103)
+#include <thread>
+#define RING_THREADS (1)
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#define RING_THREADS (1)
+#else
+#define RING_THREADS (0)
+#endif
+
+#define RING_THREAD_COUNT (100000)
+
+#if (RING_THREADS)
+/* Lets the other thread run while waiting on it. */
+static void ring_yield(void)
+{
+#if (KR_CPLUSPLUS >= 201103)
+    std::this_thread::yield();
+#else
+    sched_yield();
+#endif
+}
+
+/* Pushes every number below RING_THREAD_COUNT in order, in batches. */
+static void ring_produce(struct kr_ring_s *ring)
+{
+    uint32_t batch[8];
+    uint32_t next = 0, i = 0;
+    size_t n = 0;
+
+    while (next < RING_THREAD_COUNT)
+    {
+        n = next % 8 + 1;
+        if (n > RING_THREAD_COUNT - next)
+        {
+            n = RING_THREAD_COUNT - next;
+        }
+        for (i = 0; i < n; i++)
+        {
+            batch[i] = next + i;
+        }
+        n = kr_ring_push_n(ring, batch, n);
+        next += KR_CASTS(uint32_t, n);
+        if (n == 0)
+        {
+            ring_yield();
+        }
+    }
+}
+
+#if !(KR_CPLUSPLUS >= 201103)
+/* Runs ring_produce as a POSIX thread. */
+static void *ring_produce_posix(void *ring)
+{
+    ring_produce(KR_CASTS(struct kr_ring_s *, ring));
+    return NULL;
+}
+#endif
+#endif /* (RING_THREADS) */
+
+TEST(ring, kr_ring_init)
+{
+    struct kr_ring_s ring;
+
+    EXPECT_FALSE(kr_ring_init(&ring, sizeof(int), 0));
+    EXPECT_TRUE(ring.data == NULL);
+    EXPECT_FALSE(kr_ring_init(&ring, sizeof(int), 12));
+    EXPECT_UINTEQ(0, kr_ring_capacity(&ring));
+
+    ASSERT_TRUE(kr_ring_init(&ring, sizeof(int), 16));
+    EXPECT_UINTEQ(16, kr_ring_capacity(&ring));
+    EXPECT_UINTEQ(0, kr_ring_count(&ring));
+    kr_ring_free(&ring);
+    EXPECT_TRUE(ring.data == NULL);
+
+    /* The counters are a cache line apart. */
+    EXPECT_TRUE(offsetof(struct kr_ring_s, tail) - offsetof(struct kr_ring_s, head) >= KR_RING_CACHELINE);
+}
+
+TEST(ring, kr_ring_push)
+{
+    struct kr_ring_s ring;
+    int i = 0, x = 0;
+    bool ok = true;
+
+    ASSERT_TRUE(kr_ring_init(&ring, sizeof(int), 4));
+    EXPECT_FALSE(kr_ring_pop(&ring, &x));
+
+    for (i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(kr_ring_push(&ring, &i));
+    }
+    EXPECT_FALSE(kr_ring_push(&ring, &i));
+    EXPECT_UINTEQ(4, kr_ring_count(&ring));
+
+    EXPECT_TRUE(kr_ring_pop(&ring, &x));
+    EXPECT_INTEQ(0, x);
+    EXPECT_TRUE(kr_ring_push(&ring, &i));
+    EXPECT_FALSE(kr_ring_push(&ring, &i));
+
+    /* Elements come out in order as the counters wrap many times. */
+    for (i = 5; i < 1000; i++)
+    {
+        ok = ok && kr_ring_pop(&ring, &x) && x == i - 4;
+        ok = ok && kr_ring_push(&ring, &i);
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_UINTEQ(4, kr_ring_count(&ring));
+
+    for (i = 996; i < 1000; i++)
+    {
+        EXPECT_TRUE(kr_ring_pop(&ring, &x));
+        EXPECT_INTEQ(i, x);
+    }
+    EXPECT_FALSE(kr_ring_pop(&ring, &x));
+    EXPECT_UINTEQ(0, kr_ring_count(&ring));
+
+    kr_ring_free(&ring);
+}
+
+TEST(ring, kr_ring_push_n)
+{
+    struct kr_ring_s ring;
+    int in[16], out[16];
+    int i = 0, next = 0, expect = 0;
+    size_t n = 0, round = 0;
+    bool ok = true;
+
+    ASSERT_TRUE(kr_ring_init(&ring, sizeof(int), 8));
+    EXPECT_UINTEQ(0, kr_ring_pop_n(&ring, out, 4));
+    EXPECT_UINTEQ(0, kr_ring_push_n(&ring, in, 0));
+
+    /* A batch bigger than the free space is cut short. */
+    for (i = 0; i < 16; i++)
+    {
+        in[i] = next++;
+    }
+    EXPECT_UINTEQ(8, kr_ring_push_n(&ring, in, 16));
+    EXPECT_UINTEQ(0, kr_ring_push_n(&ring, in + 8, 8));
+    EXPECT_UINTEQ(3, kr_ring_pop_n(&ring, out, 3));
+    EXPECT_INTEQ(2, out[2]);
+    EXPECT_UINTEQ(3, kr_ring_push_n(&ring, in + 8, 8));
+    EXPECT_UINTEQ(8, kr_ring_pop_n(&ring, out, 16));
+    EXPECT_INTEQ(3, out[0]);
+    EXPECT_INTEQ(10, out[7]);
+    next = 11;
+    expect = 11;
+
+    /* Batches of every size, crossing the end of the storage. */
+    for (round = 0; round < 200; round++)
+    {
+        n = round % 9;
+        for (i = 0; i < KR_CASTS(int, n); i++)
+        {
+            in[i] = next + i;
+        }
+        n = kr_ring_push_n(&ring, in, n);
+        next += KR_CASTS(int, n);
+
+        n = kr_ring_pop_n(&ring, out, (round * 7) % 9);
+        for (i = 0; i < KR_CASTS(int, n); i++)
+        {
+            ok = ok && out[i] == expect++;
+        }
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_UINTEQ(KR_CASTS(size_t, next - expect), kr_ring_count(&ring));
+
+    kr_ring_free(&ring);
+}
+
+TEST(ring, kr_ring_threads)
+{
+#if !(RING_THREADS)
+    SKIP();
+#else  /* !(RING_THREADS) */
+    struct kr_ring_s ring;
+    uint32_t out[8];
+    uint32_t expect = 0;
+    size_t i = 0, n = 0, round = 0;
+    bool ok = true;
+#if !(KR_CPLUSPLUS >= 201103)
+    pthread_t producer;
+#endif
+
+    ASSERT_TRUE(kr_ring_init(&ring, sizeof(uint32_t), 16));
+#if (KR_CPLUSPLUS >= 201103)
+    std::thread producer(ring_produce, &ring);
+#else
+    ASSERT_TRUE(pthread_create(&producer, NULL, ring_produce_posix, &ring) == 0);
+#endif
+
+    /* Everything arrives once and in order, popped one at a time and in
+     * batches.  Keep popping after a mismatch so the producer can finish. */
+    for (round = 0; expect < RING_THREAD_COUNT; round++)
+    {
+        if (round % 2 == 0)
+        {
+            n = kr_ring_pop(&ring, out) ? 1 : 0;
+        }
+        else
+        {
+            n = kr_ring_pop_n(&ring, out, 8);
+        }
+        for (i = 0; i < n; i++)
+        {
+            ok = ok && out[i] == expect;
+            expect++;
+        }
+        if (n == 0)
+        {
+            ring_yield();
+        }
+    }
+
+#if (KR_CPLUSPLUS >= 201103)
+    producer.join();
+#else
+    pthread_join(producer, NULL);
+#endif
+    EXPECT_TRUE(ok);
+    EXPECT_UINTEQ(0, kr_ring_count(&ring));
+
+    kr_ring_free(&ring);
+#endif /* !(RING_THREADS) */
+}
+
+SUITE(ring)
+{
+    SUITE_TEST(ring, kr_ring_init);
+    SUITE_TEST(ring, kr_ring_push);
+    SUITE_TEST(ring, kr_ring_push_n);
+    SUITE_TEST(ring, kr_ring_threads);
+}
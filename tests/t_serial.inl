@@ -151,6 +151,513 @@ TEST(serial, kr_store_u64be)
 #endif /* !defined(UINT64_MAX) */
 }
 
+/******************************************************************************/
+
+/* Long enough to cover a few vectors plus a scalar tail. */
+#define SERIAL_ARRAYLEN 37
+
+TEST(serial, kr_load_u16_array)
+{
+    size_t i = 0, n = 0;
+    unsigned char buf[SERIAL_ARRAYLEN * 2];
+    uint16_t le[SERIAL_ARRAYLEN + 1], be[SERIAL_ARRAYLEN + 1];
+
+    for (i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = KR_CASTS(unsigned char, i * 7 + 1);
+    }
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        le[n] = 0x5a;
+        be[n] = 0x5a;
+        kr_load_u16le_array(le, buf, n);
+        kr_load_u16be_array(be, buf, n);
+        for (i = 0; i < n; i++)
+        {
+            EXPECT_UINTEQ(kr_load_u16le(buf + i * 2), le[i]);
+            EXPECT_UINTEQ(kr_load_u16be(buf + i * 2), be[i]);
+        }
+        EXPECT_UINTEQ(0x5a, le[n]);
+        EXPECT_UINTEQ(0x5a, be[n]);
+    }
+}
+
+TEST(serial, kr_store_u16_array)
+{
+    size_t i = 0, n = 0;
+    uint16_t src[SERIAL_ARRAYLEN];
+    unsigned char le[(SERIAL_ARRAYLEN + 1) * 2], be[(SERIAL_ARRAYLEN + 1) * 2];
+
+    for (i = 0; i < SERIAL_ARRAYLEN; i++)
+    {
+        src[i] = KR_CASTS(uint16_t, i * 0x01234567UL + 0x01020304UL);
+    }
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        le[n * 2] = 0x5a;
+        be[n * 2] = 0x5a;
+        kr_store_u16le_array(le, src, n);
+        kr_store_u16be_array(be, src, n);
+        for (i = 0; i < n; i++)
+        {
+            EXPECT_UINTEQ(src[i], kr_load_u16le(le + i * 2));
+            EXPECT_UINTEQ(src[i], kr_load_u16be(be + i * 2));
+        }
+        EXPECT_UINTEQ(0x5a, le[n * 2]);
+        EXPECT_UINTEQ(0x5a, be[n * 2]);
+    }
+}
+
+TEST(serial, kr_bswap16_array)
+{
+    size_t i = 0, n = 0;
+    uint16_t arr[SERIAL_ARRAYLEN + 1];
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        for (i = 0; i <= SERIAL_ARRAYLEN; i++)
+        {
+            arr[i] = KR_CASTS(uint16_t, i * 0x01234567UL + 0x01020304UL);
+        }
+        kr_bswap16_array(arr, n);
+        for (i = 0; i <= SERIAL_ARRAYLEN; i++)
+        {
+            const uint16_t x = KR_CASTS(uint16_t, i * 0x01234567UL + 0x01020304UL);
+            EXPECT_UINTEQ(i < n ? kr_bswap16(x) : x, arr[i]);
+        }
+    }
+}
+
+TEST(serial, kr_load_u32_array)
+{
+    size_t i = 0, n = 0;
+    unsigned char buf[SERIAL_ARRAYLEN * 4];
+    uint32_t le[SERIAL_ARRAYLEN + 1], be[SERIAL_ARRAYLEN + 1];
+
+    for (i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = KR_CASTS(unsigned char, i * 7 + 1);
+    }
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        le[n] = 0x5a;
+        be[n] = 0x5a;
+        kr_load_u32le_array(le, buf, n);
+        kr_load_u32be_array(be, buf, n);
+        for (i = 0; i < n; i++)
+        {
+            EXPECT_UINTEQ(kr_load_u32le(buf + i * 4), le[i]);
+            EXPECT_UINTEQ(kr_load_u32be(buf + i * 4), be[i]);
+        }
+        EXPECT_UINTEQ(0x5a, le[n]);
+        EXPECT_UINTEQ(0x5a, be[n]);
+    }
+}
+
+TEST(serial, kr_store_u32_array)
+{
+    size_t i = 0, n = 0;
+    uint32_t src[SERIAL_ARRAYLEN];
+    unsigned char le[(SERIAL_ARRAYLEN + 1) * 4], be[(SERIAL_ARRAYLEN + 1) * 4];
+
+    for (i = 0; i < SERIAL_ARRAYLEN; i++)
+    {
+        src[i] = KR_CASTS(uint32_t, i * 0x01234567UL + 0x01020304UL);
+    }
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        le[n * 4] = 0x5a;
+        be[n * 4] = 0x5a;
+        kr_store_u32le_array(le, src, n);
+        kr_store_u32be_array(be, src, n);
+        for (i = 0; i < n; i++)
+        {
+            EXPECT_UINTEQ(src[i], kr_load_u32le(le + i * 4));
+            EXPECT_UINTEQ(src[i], kr_load_u32be(be + i * 4));
+        }
+        EXPECT_UINTEQ(0x5a, le[n * 4]);
+        EXPECT_UINTEQ(0x5a, be[n * 4]);
+    }
+}
+
+TEST(serial, kr_bswap32_array)
+{
+    size_t i = 0, n = 0;
+    uint32_t arr[SERIAL_ARRAYLEN + 1];
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        for (i = 0; i <= SERIAL_ARRAYLEN; i++)
+        {
+            arr[i] = KR_CASTS(uint32_t, i * 0x01234567UL + 0x01020304UL);
+        }
+        kr_bswap32_array(arr, n);
+        for (i = 0; i <= SERIAL_ARRAYLEN; i++)
+        {
+            const uint32_t x = KR_CASTS(uint32_t, i * 0x01234567UL + 0x01020304UL);
+            EXPECT_UINTEQ(i < n ? kr_bswap32(x) : x, arr[i]);
+        }
+    }
+}
+
+TEST(serial, kr_load_u64_array)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    size_t i = 0, n = 0;
+    unsigned char buf[SERIAL_ARRAYLEN * 8];
+    uint64_t le[SERIAL_ARRAYLEN + 1], be[SERIAL_ARRAYLEN + 1];
+
+    for (i = 0; i < sizeof(buf); i++)
+    {
+        buf[i] = KR_CASTS(unsigned char, i * 7 + 1);
+    }
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        le[n] = 0x5a;
+        be[n] = 0x5a;
+        kr_load_u64le_array(le, buf, n);
+        kr_load_u64be_array(be, buf, n);
+        for (i = 0; i < n; i++)
+        {
+            EXPECT_UINTEQ(kr_load_u64le(buf + i * 8), le[i]);
+            EXPECT_UINTEQ(kr_load_u64be(buf + i * 8), be[i]);
+        }
+        EXPECT_UINTEQ(0x5a, le[n]);
+        EXPECT_UINTEQ(0x5a, be[n]);
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(serial, kr_store_u64_array)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    size_t i = 0, n = 0;
+    uint64_t src[SERIAL_ARRAYLEN];
+    unsigned char le[(SERIAL_ARRAYLEN + 1) * 8], be[(SERIAL_ARRAYLEN + 1) * 8];
+
+    for (i = 0; i < SERIAL_ARRAYLEN; i++)
+    {
+        src[i] = KR_CASTS(uint64_t, i * 0x0123456789abcdef + 0x0102030405060708);
+    }
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        le[n * 8] = 0x5a;
+        be[n * 8] = 0x5a;
+        kr_store_u64le_array(le, src, n);
+        kr_store_u64be_array(be, src, n);
+        for (i = 0; i < n; i++)
+        {
+            EXPECT_UINTEQ(src[i], kr_load_u64le(le + i * 8));
+            EXPECT_UINTEQ(src[i], kr_load_u64be(be + i * 8));
+        }
+        EXPECT_UINTEQ(0x5a, le[n * 8]);
+        EXPECT_UINTEQ(0x5a, be[n * 8]);
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(serial, kr_bswap64_array)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    size_t i = 0, n = 0;
+    uint64_t arr[SERIAL_ARRAYLEN + 1];
+
+    for (n = 0; n <= SERIAL_ARRAYLEN; n++)
+    {
+        for (i = 0; i <= SERIAL_ARRAYLEN; i++)
+        {
+            arr[i] = KR_CASTS(uint64_t, i * 0x0123456789abcdef + 0x0102030405060708);
+        }
+        kr_bswap64_array(arr, n);
+        for (i = 0; i <= SERIAL_ARRAYLEN; i++)
+        {
+            const uint64_t x = KR_CASTS(uint64_t, i * 0x0123456789abcdef + 0x0102030405060708);
+            EXPECT_UINTEQ(i < n ? kr_bswap64(x) : x, arr[i]);
+        }
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+/******************************************************************************/
+
+TEST(serial, kr_serial_reader)
+{
+    const unsigned char buf[15] = {0x01, 0x88, 0x99, 0x99, 0x88, 0x88, 0x99, 0xaa,
+                                   0xbb, 0xbb, 0xaa, 0x99, 0x88, 0x42, 0x43};
+    struct kr_serial_reader_s r;
+    char bytes[4];
+
+    kr_serial_reader_init(&r, buf, sizeof(buf));
+    EXPECT_UINTEQ(0x01, kr_serial_read_u8(&r));
+    EXPECT_UINTEQ(0x9988, kr_serial_read_u16le(&r));
+    EXPECT_UINTEQ(0x9988, kr_serial_read_u16be(&r));
+    EXPECT_TRUE(kr_serial_reader_need(&r, 8));
+    EXPECT_UINTEQ(0xbbaa9988, kr_serial_read_u32le_unchecked(&r));
+    EXPECT_UINTEQ(0xbbaa9988, kr_serial_read_u32be_unchecked(&r));
+    EXPECT_UINTEQ(13, kr_serial_reader_tell(&r));
+    EXPECT_UINTEQ(2, kr_serial_reader_remaining(&r));
+    EXPECT_FALSE(r.error);
+
+    /* Running off the end latches the error and reads zeroes. */
+    kr_serial_read_bytes(&r, bytes, 4);
+    EXPECT_TRUE(r.error);
+    EXPECT_INTEQ(0, bytes[0]);
+    EXPECT_UINTEQ(0, kr_serial_read_u8(&r));
+    EXPECT_UINTEQ(0, kr_serial_reader_remaining(&r));
+    EXPECT_FALSE(kr_serial_reader_need(&r, 0));
+
+    kr_serial_reader_init(&r, buf, sizeof(buf));
+    kr_serial_read_skip(&r, 13);
+    kr_serial_read_bytes(&r, bytes, 2);
+    EXPECT_FALSE(r.error);
+    EXPECT_INTEQ(0x42, bytes[0]);
+    EXPECT_INTEQ(0x43, bytes[1]);
+
+#if defined(UINT64_MAX)
+    {
+        const unsigned char buf64[8] = {0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+        kr_serial_reader_init(&r, buf64, sizeof(buf64));
+        EXPECT_UINTEQ(0xffeeddccbbaa9988, kr_serial_read_u64le(&r));
+        EXPECT_UINTEQ(0, kr_serial_read_u64be(&r));
+        EXPECT_TRUE(r.error);
+    }
+#endif /* defined(UINT64_MAX) */
+}
+
+TEST(serial, kr_serial_writer)
+{
+    const unsigned char expected[13] = {0x01, 0x88, 0x99, 0x99, 0x88, 0x88, 0x99,
+                                        0xaa, 0xbb, 0xbb, 0xaa, 0x99, 0x88};
+    unsigned char buf[16];
+    struct kr_serial_writer_s w;
+
+    memset(buf, 0, sizeof(buf));
+    kr_serial_writer_init(&w, buf, sizeof(buf));
+    kr_serial_write_u8(&w, 0x01);
+    kr_serial_write_u16le(&w, 0x9988);
+    kr_serial_write_u16be(&w, 0x9988);
+    EXPECT_TRUE(kr_serial_writer_need(&w, 8));
+    kr_serial_write_u32le_unchecked(&w, 0xbbaa9988);
+    kr_serial_write_u32be_unchecked(&w, 0xbbaa9988);
+    EXPECT_FALSE(w.error);
+    EXPECT_UINTEQ(13, kr_serial_writer_tell(&w));
+    EXPECT_UINTEQ(3, kr_serial_writer_remaining(&w));
+    EXPECT_INTEQ(0, memcmp(expected, buf, sizeof(expected)));
+
+    /* Writes that do not fit are dropped and latch the error. */
+    kr_serial_write_u32le(&w, 0xffffffff);
+    EXPECT_TRUE(w.error);
+    EXPECT_UINTEQ(0, buf[13]);
+    kr_serial_write_bytes(&w, "", 0);
+    EXPECT_TRUE(w.error);
+
+#if defined(UINT64_MAX)
+    kr_serial_writer_init(&w, buf, 8);
+    kr_serial_write_u64be(&w, 0xffeeddccbbaa9988);
+    EXPECT_FALSE(w.error);
+    EXPECT_UINTEQ(0xffeeddccbbaa9988, kr_load_u64be(buf));
+    kr_serial_write_u64le(&w, 0xffeeddccbbaa9988);
+    EXPECT_TRUE(w.error);
+#endif /* defined(UINT64_MAX) */
+}
+
+/******************************************************************************/
+
+TEST(serial, kr_zigzag)
+{
+    EXPECT_UINTEQ(0, kr_zigzag_encode32(0));
+    EXPECT_UINTEQ(1, kr_zigzag_encode32(-1));
+    EXPECT_UINTEQ(2, kr_zigzag_encode32(1));
+    EXPECT_UINTEQ(0xFFFFFFFF, kr_zigzag_encode32(INT32_MIN));
+    EXPECT_UINTEQ(0xFFFFFFFE, kr_zigzag_encode32(INT32_MAX));
+    EXPECT_INTEQ(-1, kr_zigzag_decode32(1));
+    EXPECT_INTEQ(INT32_MIN, kr_zigzag_decode32(0xFFFFFFFF));
+    EXPECT_INTEQ(INT32_MAX, kr_zigzag_decode32(0xFFFFFFFE));
+
+#if defined(UINT64_MAX)
+    EXPECT_UINTEQ(3, kr_zigzag_encode64(-2));
+    EXPECT_UINTEQ(UINT64_MAX, kr_zigzag_encode64(INT64_MIN));
+    EXPECT_INTEQ(-2, kr_zigzag_decode64(3));
+    EXPECT_TRUE(kr_zigzag_decode64(UINT64_MAX) == INT64_MIN);
+    EXPECT_TRUE(kr_zigzag_decode64(UINT64_MAX - 1) == INT64_MAX);
+#endif /* defined(UINT64_MAX) */
+}
+
+#if defined(UINT64_MAX)
+
+/* Values at the edges of every encoded length. */
+static uint64_t serial_varint_value(size_t i)
+{
+    const uint64_t one = 1;
+    if (i < 64)
+    {
+        return one << i;
+    }
+    else if (i < 128)
+    {
+        return (one << (i - 64)) - 1;
+    }
+    return UINT64_MAX - (i - 128);
+}
+
+#define SERIAL_VARINTCOUNT 131
+
+#endif /* defined(UINT64_MAX) */
+
+TEST(serial, kr_uleb128)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    static const unsigned char expected[3] = {0xE5, 0x8E, 0x26};
+    unsigned char buf[KR_LEB128_MAXLEN];
+    uint64_t v = 0;
+    size_t i = 0, len = 0;
+
+    EXPECT_UINTEQ(3, kr_store_uleb128(buf, 624485));
+    EXPECT_INTEQ(0, memcmp(expected, buf, 3));
+    EXPECT_UINTEQ(1, kr_store_uleb128(buf, 0));
+    EXPECT_UINTEQ(10, kr_store_uleb128(buf, UINT64_MAX));
+
+    for (i = 0; i < SERIAL_VARINTCOUNT; i++)
+    {
+        len = kr_store_uleb128(buf, serial_varint_value(i));
+        EXPECT_UINTEQ(len, kr_load_uleb128(buf, len, &v));
+        EXPECT_TRUE(v == serial_varint_value(i));
+        EXPECT_UINTEQ(0, kr_load_uleb128(buf, len - 1, &v));
+    }
+
+    /* The tenth byte can only hold bit 63. */
+    memset(buf, 0x80, sizeof(buf));
+    buf[9] = 0x01;
+    EXPECT_UINTEQ(10, kr_load_uleb128(buf, sizeof(buf), &v));
+    EXPECT_TRUE(v == (UINT64_C(1) << 63));
+    buf[9] = 0x02;
+    EXPECT_UINTEQ(0, kr_load_uleb128(buf, sizeof(buf), &v));
+    buf[9] = 0x81;
+    EXPECT_UINTEQ(0, kr_load_uleb128(buf, sizeof(buf), &v));
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(serial, kr_sleb128)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    static const unsigned char expected[3] = {0xC0, 0xBB, 0x78};
+    unsigned char buf[KR_LEB128_MAXLEN];
+    int64_t v = 0, x = 0;
+    size_t i = 0, len = 0;
+
+    EXPECT_UINTEQ(3, kr_store_sleb128(buf, -123456));
+    EXPECT_INTEQ(0, memcmp(expected, buf, 3));
+    EXPECT_UINTEQ(1, kr_store_sleb128(buf, -64));
+    EXPECT_UINTEQ(2, kr_store_sleb128(buf, 64));
+
+    for (i = 0; i < SERIAL_VARINTCOUNT * 2; i++)
+    {
+        x = KR_CASTS(int64_t, serial_varint_value(i / 2));
+        x = (i % 2) ? KR_CASTS(int64_t, 0 - KR_CASTS(uint64_t, x)) : x;
+        len = kr_store_sleb128(buf, x);
+        EXPECT_UINTEQ(len, kr_load_sleb128(buf, len, &v));
+        EXPECT_TRUE(v == x);
+    }
+
+    /* The tenth byte holds bit 63, and the bits above it must match. */
+    memset(buf, 0x80, sizeof(buf));
+    buf[9] = 0x7F;
+    EXPECT_UINTEQ(10, kr_load_sleb128(buf, sizeof(buf), &v));
+    EXPECT_TRUE(v == KR_CASTS(int64_t, 0 - (UINT64_C(1) << 63)));
+    buf[9] = 0x01;
+    EXPECT_UINTEQ(0, kr_load_sleb128(buf, sizeof(buf), &v));
+    buf[9] = 0x40;
+    EXPECT_UINTEQ(0, kr_load_sleb128(buf, sizeof(buf), &v));
+    memset(buf, 0xFF, sizeof(buf));
+    buf[9] = 0x00;
+    EXPECT_UINTEQ(10, kr_load_sleb128(buf, sizeof(buf), &v));
+    EXPECT_TRUE(v == KR_CASTS(int64_t, UINT64_MAX >> 1));
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(serial, kr_pvarint)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    unsigned char buf[KR_PVARINT_MAXLEN];
+    uint64_t v = 0;
+    size_t i = 0, len = 0;
+
+    EXPECT_UINTEQ(1, kr_store_pvarint(buf, 0x7F));
+    EXPECT_UINTEQ(0x7F, buf[0]);
+    EXPECT_UINTEQ(2, kr_store_pvarint(buf, 0x80));
+    EXPECT_UINTEQ(0x80, buf[0]);
+    EXPECT_UINTEQ(0x80, buf[1]);
+    EXPECT_UINTEQ(8, kr_store_pvarint(buf, (UINT64_MAX >> 8)));
+    EXPECT_UINTEQ(0xFE, buf[0]);
+    EXPECT_UINTEQ(9, kr_store_pvarint(buf, (UINT64_MAX >> 7)));
+    EXPECT_UINTEQ(0xFF, buf[0]);
+
+    for (i = 0; i < SERIAL_VARINTCOUNT; i++)
+    {
+        len = kr_store_pvarint(buf, serial_varint_value(i));
+        EXPECT_UINTEQ(len, kr_load_pvarint(buf, len, &v));
+        EXPECT_TRUE(v == serial_varint_value(i));
+        EXPECT_UINTEQ(0, kr_load_pvarint(buf, len - 1, &v));
+    }
+#endif /* !defined(UINT64_MAX) */
+}
+
+TEST(serial, kr_load_varint_array)
+{
+#if !defined(UINT64_MAX)
+    SKIP();
+#else
+    unsigned char leb[SERIAL_VARINTCOUNT * KR_LEB128_MAXLEN];
+    unsigned char pv[SERIAL_VARINTCOUNT * KR_PVARINT_MAXLEN];
+    uint64_t values[SERIAL_VARINTCOUNT + 1];
+    size_t i = 0, lebLen = 0, pvLen = 0, used = 0;
+
+    for (i = 0; i < SERIAL_VARINTCOUNT; i++)
+    {
+        lebLen += kr_store_uleb128(leb + lebLen, serial_varint_value(i));
+        pvLen += kr_store_pvarint(pv + pvLen, serial_varint_value(i));
+    }
+
+    EXPECT_UINTEQ(SERIAL_VARINTCOUNT, kr_load_uleb128_array(values, SERIAL_VARINTCOUNT + 1, leb, lebLen, &used));
+    EXPECT_UINTEQ(lebLen, used);
+    for (i = 0; i < SERIAL_VARINTCOUNT; i++)
+    {
+        EXPECT_TRUE(values[i] == serial_varint_value(i));
+    }
+
+    EXPECT_UINTEQ(SERIAL_VARINTCOUNT, kr_load_pvarint_array(values, SERIAL_VARINTCOUNT + 1, pv, pvLen, &used));
+    EXPECT_UINTEQ(pvLen, used);
+    for (i = 0; i < SERIAL_VARINTCOUNT; i++)
+    {
+        EXPECT_TRUE(values[i] == serial_varint_value(i));
+    }
+
+    /* A truncated stream stops at the last whole value. */
+    EXPECT_UINTEQ(SERIAL_VARINTCOUNT - 1, kr_load_pvarint_array(values, SERIAL_VARINTCOUNT, pv, pvLen - 1, &used));
+    EXPECT_UINTEQ(pvLen - 9, used);
+    EXPECT_UINTEQ(3, kr_load_pvarint_array(values, 3, pv, pvLen, &used));
+    EXPECT_UINTEQ(3, used);
+#endif /* !defined(UINT64_MAX) */
+}
+
 SUITE(serial)
 {
     SUITE_TEST(serial, kr_load_u16le);
@@ -165,4 +672,20 @@ SUITE(serial)
     SUITE_TEST(serial, kr_store_u32be);
     SUITE_TEST(serial, kr_store_u64le);
     SUITE_TEST(serial, kr_store_u64be);
+    SUITE_TEST(serial, kr_load_u16_array);
+    SUITE_TEST(serial, kr_store_u16_array);
+    SUITE_TEST(serial, kr_bswap16_array);
+    SUITE_TEST(serial, kr_load_u32_array);
+    SUITE_TEST(serial, kr_store_u32_array);
+    SUITE_TEST(serial, kr_bswap32_array);
+    SUITE_TEST(serial, kr_load_u64_array);
+    SUITE_TEST(serial, kr_store_u64_array);
+    SUITE_TEST(serial, kr_bswap64_array);
+    SUITE_TEST(serial, kr_serial_reader);
+    SUITE_TEST(serial, kr_serial_writer);
+    SUITE_TEST(serial, kr_zigzag);
+    SUITE_TEST(serial, kr_uleb128);
+    SUITE_TEST(serial, kr_sleb128);
+    SUITE_TEST(serial, kr_pvarint);
+    SUITE_TEST(serial, kr_load_varint_array);
 }
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krsimd.h"
+
+/*
+ * The scalar functions in krstr.h are the reference implementation, so
+ * every test checks the vectorized function against its scalar twin at
+ * every alignment and length that spans a few vectors.
+ */
+
+#define SIMD_MAXSTART 64
+#define SIMD_MAXLEN 136
+
+/******************************************************************************/
+
+TEST(simd, kr_simd_strlen)
+{
+    size_t start, len;
+    char buffer[SIMD_MAXSTART + SIMD_MAXLEN + 1];
+
+    for (start = 0; start < SIMD_MAXSTART; start++)
+    {
+        for (len = 0; len < SIMD_MAXLEN; len++)
+        {
+            memset(buffer, 'x', sizeof(buffer));
+            buffer[start + len] = '\0';
+            EXPECT_UINTEQ(kr_strlen(buffer + start), kr_simd_strlen(buffer + start));
+        }
+    }
+}
+
+TEST(simd, kr_simd_strnlen)
+{
+    size_t start, len;
+    char buffer[SIMD_MAXSTART + SIMD_MAXLEN + 1];
+
+    for (start = 0; start < SIMD_MAXSTART; start++)
+    {
+        for (len = 0; len < SIMD_MAXLEN; len++)
+        {
+            memset(buffer, 'x', sizeof(buffer));
+            buffer[start + len] = '\0';
+            EXPECT_UINTEQ(kr_strnlen(buffer + start, SIMD_MAXLEN), kr_simd_strnlen(buffer + start, SIMD_MAXLEN));
+            EXPECT_UINTEQ(kr_strnlen(buffer + start, len), kr_simd_strnlen(buffer + start, len));
+            EXPECT_UINTEQ(kr_strnlen(buffer + start, len / 2), kr_simd_strnlen(buffer + start, len / 2));
+        }
+    }
+}
+
+/******************************************************************************/
+
+TEST(simd, kr_simd_strspn)
+{
+    static const char *sets[] = {"", "ab", "abcdefghijklmnop", "abcdefghijklmnopq", "\x80\xff"};
+    size_t start, len, set;
+    char buffer[SIMD_MAXSTART + SIMD_MAXLEN + 1];
+
+    for (set = 0; set < sizeof(sets) / sizeof(sets[0]); set++)
+    {
+        for (start = 0; start < SIMD_MAXSTART; start++)
+        {
+            for (len = 0; len < SIMD_MAXLEN; len++)
+            {
+                /* Span of set characters, stopped by 'z' or the terminator. */
+                memset(buffer, sets[set][0] != '\0' ? sets[set][1] : 'a', sizeof(buffer));
+                buffer[start + len] = (len % 2) ? 'z' : '\0';
+                buffer[sizeof(buffer) - 1] = '\0';
+                EXPECT_UINTEQ(kr_strspn(buffer + start, sets[set]), kr_simd_strspn(buffer + start, sets[set]));
+            }
+        }
+    }
+}
+
+TEST(simd, kr_simd_strcspn)
+{
+    static const char *sets[] = {"", "yz", "abcdefghijklmnoz", "abcdefghijklmnopz", "\x80\xff"};
+    size_t start, len, set;
+    char buffer[SIMD_MAXSTART + SIMD_MAXLEN + 1];
+
+    for (set = 0; set < sizeof(sets) / sizeof(sets[0]); set++)
+    {
+        for (start = 0; start < SIMD_MAXSTART; start++)
+        {
+            for (len = 0; len < SIMD_MAXLEN; len++)
+            {
+                /* Span of 'x', stopped by a set character or the terminator. */
+                memset(buffer, 'x', sizeof(buffer));
+                buffer[start + len] = (len % 2) ? 'z' : '\0';
+                buffer[sizeof(buffer) - 1] = '\0';
+                EXPECT_UINTEQ(kr_strcspn(buffer + start, sets[set]), kr_simd_strcspn(buffer + start, sets[set]));
+            }
+        }
+    }
+}
+
+/******************************************************************************/
+
+TEST(simd, kr_simd_memccpy)
+{
+    size_t start, len;
+    char src[SIMD_MAXSTART + SIMD_MAXLEN];
+    char expected[SIMD_MAXLEN], actual[SIMD_MAXLEN];
+    void *expectedRes = NULL, *actualRes = NULL;
+
+    for (start = 0; start < SIMD_MAXSTART; start++)
+    {
+        for (len = 0; len < SIMD_MAXLEN; len++)
+        {
+            memset(src, 'x', sizeof(src));
+            src[start + len / 2] = 'y';
+            memset(expected, 0, sizeof(expected));
+            memset(actual, 0, sizeof(actual));
+
+            expectedRes = kr_memccpy(expected, src + start, 'y', len);
+            actualRes = kr_simd_memccpy(actual, src + start, 'y', len);
+            if (expectedRes == NULL)
+            {
+                EXPECT_TRUE(actualRes == NULL);
+            }
+            else
+            {
+                EXPECT_INTEQ(KR_CASTS(char *, expectedRes) - expected, KR_CASTS(char *, actualRes) - actual);
+            }
+            EXPECT_INTEQ(0, memcmp(expected, actual, sizeof(expected)));
+        }
+    }
+}
+
+/******************************************************************************/
+
+/* Sign of a comparison result, since only the sign is meaningful. */
+static int simd_sign(int x)
+{
+    return (x > 0) - (x < 0);
+}
+
+TEST(simd, kr_simd_strcmp)
+{
+    size_t lstart, rstart, len;
+    char lhs[SIMD_MAXSTART + SIMD_MAXLEN + 1], rhs[SIMD_MAXSTART + SIMD_MAXLEN + 1];
+
+    for (lstart = 0; lstart < SIMD_MAXSTART; lstart += 3)
+    {
+        for (rstart = 0; rstart < SIMD_MAXSTART; rstart += 5)
+        {
+            for (len = 0; len < SIMD_MAXLEN; len++)
+            {
+                /* Identical strings. */
+                memset(lhs, 'x', sizeof(lhs));
+                memset(rhs, 'x', sizeof(rhs));
+                lhs[lstart + len] = '\0';
+                rhs[rstart + len] = '\0';
+                EXPECT_INTEQ(simd_sign(kr_strcmp(lhs + lstart, rhs + rstart)),
+                             simd_sign(kr_simd_strcmp(lhs + lstart, rhs + rstart)));
+
+                /* Different lengths. */
+                rhs[rstart + len] = 'x';
+                rhs[rstart + len + 1] = '\0';
+                EXPECT_INTEQ(simd_sign(kr_strcmp(lhs + lstart, rhs + rstart)),
+                             simd_sign(kr_simd_strcmp(lhs + lstart, rhs + rstart)));
+
+                /* Differing byte, including one with the high bit set. */
+                rhs[rstart + len / 2] = (len % 2) ? 'a' : '\x80';
+                EXPECT_INTEQ(simd_sign(kr_strcmp(lhs + lstart, rhs + rstart)),
+                             simd_sign(kr_simd_strcmp(lhs + lstart, rhs + rstart)));
+            }
+        }
+    }
+}
+
+SUITE(simd)
+{
+    SUITE_TEST(simd, kr_simd_strlen);
+    SUITE_TEST(simd, kr_simd_strnlen);
+    SUITE_TEST(simd, kr_simd_strspn);
+    SUITE_TEST(simd, kr_simd_strcspn);
+    SUITE_TEST(simd, kr_simd_memccpy);
+    SUITE_TEST(simd, kr_simd_strcmp);
+}
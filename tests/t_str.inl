@@ -10,6 +10,56 @@
 
 #include "krstr.h"
 
+TEST(str, kr_strlen)
+{
+    EXPECT_UINTEQ(0, kr_strlen(""));
+    EXPECT_UINTEQ(5, kr_strlen("plugh"));
+}
+
+TEST(str, kr_strnlen)
+{
+    EXPECT_UINTEQ(0, kr_strnlen("", 8));
+    EXPECT_UINTEQ(5, kr_strnlen("plugh", 8));
+    EXPECT_UINTEQ(3, kr_strnlen("plugh", 3));
+    EXPECT_UINTEQ(0, kr_strnlen("plugh", 0));
+}
+
+TEST(str, kr_strlen_swar)
+{
+    size_t start, len;
+    char buffer[96];
+
+    /* Every alignment, and every terminator position inside a word. */
+    for (start = 0; start < 16; start++)
+    {
+        for (len = 0; len < 64; len++)
+        {
+            memset(buffer, 0x80, sizeof(buffer));
+            buffer[start + len] = '\0';
+            EXPECT_UINTEQ(len, kr_strlen_swar(buffer + start));
+        }
+    }
+}
+
+TEST(str, kr_strnlen_swar)
+{
+    size_t start, len;
+    char buffer[96];
+
+    for (start = 0; start < 16; start++)
+    {
+        for (len = 0; len < 64; len++)
+        {
+            memset(buffer, 0x7F, sizeof(buffer));
+            buffer[start + len] = '\0';
+            EXPECT_UINTEQ(len, kr_strnlen_swar(buffer + start, 64));
+            EXPECT_UINTEQ(len, kr_strnlen_swar(buffer + start, len));
+            EXPECT_UINTEQ(len, kr_strnlen_swar(buffer + start, len + 1));
+            EXPECT_UINTEQ(len / 2, kr_strnlen_swar(buffer + start, len / 2));
+        }
+    }
+}
+
 TEST(str, kr_strcmp)
 {
     EXPECT_INTEQ(0, kr_strcmp("abc", "abc"));
@@ -213,6 +263,177 @@ TEST(str, kr_strtok_r)
     }
 }
 
+TEST(str, kr_charset)
+{
+    struct kr_charset_s set = kr_charset_make("abc");
+
+    EXPECT_TRUE(kr_charset_has(&set, 'a'));
+    EXPECT_TRUE(kr_charset_has(&set, 'c'));
+    EXPECT_FALSE(kr_charset_has(&set, 'd'));
+    EXPECT_FALSE(kr_charset_has(&set, '\0'));
+
+    kr_charset_add(&set, '\xff');
+    kr_charset_addstr(&set, "xyz");
+    EXPECT_TRUE(kr_charset_has(&set, '\xff'));
+    EXPECT_TRUE(kr_charset_has(&set, 'y'));
+    EXPECT_FALSE(kr_charset_has(&set, '\x7f'));
+
+    kr_charset_clear(&set);
+    EXPECT_FALSE(kr_charset_has(&set, 'a'));
+    EXPECT_FALSE(kr_charset_has(&set, '\xff'));
+
+#if (KR_CPLUSPLUS >= 201402)
+    {
+        static constexpr struct kr_charset_s cset = kr_charset_make(",;");
+        static_assert(kr_charset_has(&cset, ','), "charset must be constexpr");
+        static_assert(!kr_charset_has(&cset, '.'), "charset must be constexpr");
+    }
+#endif
+}
+
+TEST(str, kr_strspn_set)
+{
+    const struct kr_charset_s set = kr_charset_make("plu");
+    const struct kr_charset_s empty = kr_charset_make("");
+
+    EXPECT_UINTEQ(3, kr_strspn_set("plugh", &set));
+    EXPECT_UINTEQ(5, kr_strspn_set("uuplp", &set));
+    EXPECT_UINTEQ(0, kr_strspn_set("xyzzy", &set));
+    EXPECT_UINTEQ(0, kr_strspn_set("plugh", &empty));
+    EXPECT_UINTEQ(0, kr_strspn_set("", &set));
+}
+
+TEST(str, kr_strcspn_set)
+{
+    const struct kr_charset_s set = kr_charset_make("ghxyz");
+    const struct kr_charset_s empty = kr_charset_make("");
+
+    EXPECT_UINTEQ(3, kr_strcspn_set("plugh", &set));
+    EXPECT_UINTEQ(0, kr_strcspn_set("xyzzy", &set));
+    EXPECT_UINTEQ(5, kr_strcspn_set("plugh", &empty));
+    EXPECT_UINTEQ(0, kr_strcspn_set("", &set));
+}
+
+TEST(str, kr_strtok_set_r)
+{
+    const struct kr_charset_s delim = kr_charset_make(",;\t \r\n");
+    char *r = NULL, *ptr = NULL;
+    char buffer[32];
+
+    kr_strscpy(buffer, "foo, bar;\tbaz,,\r\n", sizeof(buffer));
+
+    r = kr_strtok_set_r(buffer, &delim, &ptr);
+    EXPECT_STREQ(r, "foo");
+
+    r = kr_strtok_set_r(NULL, &delim, &ptr);
+    EXPECT_STREQ(r, "bar");
+
+    r = kr_strtok_set_r(NULL, &delim, &ptr);
+    EXPECT_STREQ(r, "baz");
+
+    r = kr_strtok_set_r(NULL, &delim, &ptr);
+    EXPECT_TRUE(r == NULL);
+}
+
+TEST(str, kr_strview)
+{
+    const struct kr_strview_s view = kr_strview_from("plugh xyzzy");
+    struct kr_strview_s sub = kr_strview_make(NULL, 0);
+
+    EXPECT_UINTEQ(11, view.len);
+
+    sub = kr_strview_sub(view, 6, 3);
+    EXPECT_UINTEQ(3, sub.len);
+    EXPECT_INTEQ(0, memcmp(sub.data, "xyz", 3));
+
+    sub = kr_strview_sub(view, 6, 100);
+    EXPECT_UINTEQ(5, sub.len);
+
+    sub = kr_strview_sub(view, 100, 100);
+    EXPECT_UINTEQ(0, sub.len);
+
+    EXPECT_TRUE(kr_strview_eq(kr_strview_sub(view, 0, 5), kr_strview_from("plugh")));
+    EXPECT_FALSE(kr_strview_eq(kr_strview_sub(view, 0, 4), kr_strview_from("plugh")));
+    EXPECT_INTEQ(0, kr_strview_cmp(kr_strview_sub(view, 0, 5), kr_strview_from("plugh")));
+    EXPECT_INTGT(0, kr_strview_cmp(kr_strview_sub(view, 0, 4), kr_strview_from("plugh")));
+    EXPECT_INTLT(0, kr_strview_cmp(kr_strview_from("plugh"), kr_strview_sub(view, 0, 4)));
+    EXPECT_INTGT(0, kr_strview_cmp(kr_strview_from("abc"), kr_strview_from("abd")));
+    EXPECT_INTLT(0, kr_strview_cmp(kr_strview_from("ab\x80"), kr_strview_from("abc")));
+
+#if (KR_CPLUSPLUS >= 201402)
+    {
+        static constexpr struct kr_strview_s cview = kr_strview_from("plugh");
+        static_assert(cview.len == 5, "view must be constexpr");
+        static_assert(kr_strview_find(cview, kr_strview_from("ug")) == 2, "find must be constexpr");
+    }
+#endif
+}
+
+TEST(str, kr_strview_find)
+{
+    const struct kr_strview_s view = kr_strview_from("plugh xyzzy");
+
+    EXPECT_INTEQ(0, kr_strview_findchr(view, 'p'));
+    EXPECT_INTEQ(7, kr_strview_findchr(view, 'y'));
+    EXPECT_INTGT(0, kr_strview_findchr(view, 'q'));
+    EXPECT_INTGT(0, kr_strview_findchr(kr_strview_sub(view, 0, 5), 'x'));
+
+    EXPECT_INTEQ(0, kr_strview_find(view, kr_strview_from("")));
+    EXPECT_INTEQ(2, kr_strview_find(view, kr_strview_from("ugh")));
+    EXPECT_INTEQ(8, kr_strview_find(view, kr_strview_from("zzy")));
+    EXPECT_INTGT(0, kr_strview_find(view, kr_strview_from("zzyx")));
+    EXPECT_INTGT(0, kr_strview_find(kr_strview_sub(view, 0, 7), kr_strview_from("xy")));
+    EXPECT_INTGT(0, kr_strview_find(kr_strview_from("ab"), kr_strview_from("abc")));
+}
+
+TEST(str, kr_strview_spn)
+{
+    const struct kr_charset_s set = kr_charset_make("plu");
+    const struct kr_strview_s view = kr_strview_from("pluplugh");
+
+    EXPECT_UINTEQ(6, kr_strview_spn(view, &set));
+    EXPECT_UINTEQ(4, kr_strview_spn(kr_strview_sub(view, 0, 4), &set));
+    EXPECT_UINTEQ(0, kr_strview_cspn(view, &set));
+    EXPECT_UINTEQ(2, kr_strview_cspn(kr_strview_sub(view, 6, 100), &set));
+}
+
+TEST(str, kr_strview_tok)
+{
+    const struct kr_charset_s delim = kr_charset_make(", ");
+    const char buffer[] = "foo, bar,,baz, qux";
+    struct kr_strview_s rest = kr_strview_make(buffer, 14);
+    struct kr_strview_s tok = kr_strview_make(NULL, 0);
+
+    EXPECT_TRUE(kr_strview_tok(&rest, &delim, &tok));
+    EXPECT_TRUE(kr_strview_eq(tok, kr_strview_from("foo")));
+
+    EXPECT_TRUE(kr_strview_tok(&rest, &delim, &tok));
+    EXPECT_TRUE(kr_strview_eq(tok, kr_strview_from("bar")));
+
+    EXPECT_TRUE(kr_strview_tok(&rest, &delim, &tok));
+    EXPECT_TRUE(kr_strview_eq(tok, kr_strview_from("baz")));
+
+    EXPECT_FALSE(kr_strview_tok(&rest, &delim, &tok));
+    EXPECT_STREQ("foo, bar,,baz, qux", buffer);
+}
+
+TEST(str, kr_strview_copy)
+{
+    const struct kr_strview_s view = kr_strview_sub(kr_strview_from("plugh xyzzy"), 6, 5);
+    char buffer[8];
+
+    EXPECT_INTEQ(5, kr_strview_copy(buffer, view, sizeof(buffer)));
+    EXPECT_STREQ("xyzzy", buffer);
+
+    EXPECT_INTEQ(5, kr_strview_copy(buffer, view, 6));
+    EXPECT_STREQ("xyzzy", buffer);
+
+    EXPECT_INTGT(0, kr_strview_copy(buffer, view, 5));
+    EXPECT_STREQ("xyzz", buffer);
+
+    EXPECT_INTGT(0, kr_strview_copy(buffer, view, 0));
+}
+
 TEST(str, kr_memccpy)
 {
     char *ptr = NULL;
@@ -232,6 +453,10 @@ TEST(str, kr_memccpy)
 
 SUITE(str)
 {
+    SUITE_TEST(str, kr_strlen);
+    SUITE_TEST(str, kr_strnlen);
+    SUITE_TEST(str, kr_strlen_swar);
+    SUITE_TEST(str, kr_strnlen_swar);
     SUITE_TEST(str, kr_strcmp);
     SUITE_TEST(str, kr_strscpy);
     SUITE_TEST(str, kr_strscat);
@@ -241,5 +466,14 @@ SUITE(str)
     SUITE_TEST(str, kr_strspn);
     SUITE_TEST(str, kr_strcspn);
     SUITE_TEST(str, kr_strtok_r);
+    SUITE_TEST(str, kr_charset);
+    SUITE_TEST(str, kr_strspn_set);
+    SUITE_TEST(str, kr_strcspn_set);
+    SUITE_TEST(str, kr_strtok_set_r);
+    SUITE_TEST(str, kr_strview);
+    SUITE_TEST(str, kr_strview_find);
+    SUITE_TEST(str, kr_strview_spn);
+    SUITE_TEST(str, kr_strview_tok);
+    SUITE_TEST(str, kr_strview_copy);
     SUITE_TEST(str, kr_memccpy);
 }
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krstrbuf.h"
+
+TEST(strbuf, kr_strbuf_append)
+{
+    struct kr_strbuf_s buf;
+
+    kr_strbuf_init(&buf);
+    EXPECT_STREQ("", kr_strbuf_cstr(&buf));
+
+    EXPECT_TRUE(kr_strbuf_append(&buf, "foo"));
+    EXPECT_TRUE(kr_strbuf_appendch(&buf, ','));
+    EXPECT_TRUE(kr_strbuf_appendn(&buf, "barbaz", 3));
+    EXPECT_TRUE(kr_strbuf_appendn(&buf, ",", 10));
+    EXPECT_TRUE(kr_strbuf_appendview(&buf, kr_strview_make("quxquux", 3)));
+    EXPECT_STREQ("foo,bar,qux", kr_strbuf_cstr(&buf));
+    EXPECT_UINTEQ(11, buf.len);
+    EXPECT_TRUE(buf.heap == NULL);
+
+    kr_strbuf_clear(&buf);
+    EXPECT_STREQ("", kr_strbuf_cstr(&buf));
+    EXPECT_UINTEQ(0, buf.len);
+
+    kr_strbuf_free(&buf);
+}
+
+TEST(strbuf, kr_strbuf_grow)
+{
+    struct kr_strbuf_s buf;
+    size_t i = 0, cap = 0;
+    char expected[KR_CONFIG_STRBUFSMALL * 8 + 1];
+
+    kr_strbuf_init(&buf);
+
+    /* Appending one character at a time must spill to the heap intact. */
+    for (i = 0; i < sizeof(expected) - 1; i++)
+    {
+        expected[i] = KR_CASTS(char, 'a' + i % 26);
+        EXPECT_TRUE(kr_strbuf_appendch(&buf, expected[i]));
+    }
+    expected[i] = '\0';
+    EXPECT_STREQ(expected, kr_strbuf_cstr(&buf));
+    EXPECT_TRUE(buf.heap != NULL);
+
+    /* Clearing keeps the heap buffer for reuse. */
+    cap = buf.cap;
+    kr_strbuf_clear(&buf);
+    EXPECT_TRUE(kr_strbuf_append(&buf, expected));
+    EXPECT_UINTEQ(cap, buf.cap);
+    EXPECT_STREQ(expected, kr_strbuf_cstr(&buf));
+
+    kr_strbuf_free(&buf);
+    EXPECT_TRUE(buf.heap == NULL);
+    EXPECT_STREQ("", kr_strbuf_cstr(&buf));
+}
+
+TEST(strbuf, kr_strbuf_self)
+{
+    struct kr_strbuf_s buf;
+    char expected[KR_CONFIG_STRBUFSMALL * 8 + 1];
+    size_t len = 0;
+
+    /* Each append doubles the string, moving it to the heap and then to a
+     * larger heap buffer while reading from it. */
+    kr_strbuf_init(&buf);
+    EXPECT_TRUE(kr_strbuf_append(&buf, "abcd"));
+    strcpy(expected, "abcd");
+    for (len = 4; len * 2 < sizeof(expected); len *= 2)
+    {
+        EXPECT_TRUE(kr_strbuf_append(&buf, kr_strbuf_cstr(&buf)));
+        memcpy(expected + len, expected, len);
+        expected[len * 2] = '\0';
+    }
+    EXPECT_STREQ(expected, kr_strbuf_cstr(&buf));
+
+    /* Only part of itself. */
+    EXPECT_TRUE(kr_strbuf_appendn(&buf, kr_strbuf_cstr(&buf) + 1, 2));
+    EXPECT_TRUE(kr_strbuf_appendview(&buf, kr_strview_make(kr_strbuf_cstr(&buf) + 2, 1)));
+    EXPECT_UINTEQ(len + 3, buf.len);
+    EXPECT_STREQ("bcc", kr_strbuf_cstr(&buf) + len);
+
+    kr_strbuf_free(&buf);
+}
+
+TEST(strbuf, kr_strbuf_reserve)
+{
+    struct kr_strbuf_s buf;
+
+    kr_strbuf_init(&buf);
+    EXPECT_TRUE(kr_strbuf_append(&buf, "foo"));
+
+    EXPECT_TRUE(kr_strbuf_reserve(&buf, 1000));
+    EXPECT_UINTGT(buf.cap, 1000);
+    EXPECT_STREQ("foo", kr_strbuf_cstr(&buf));
+
+    EXPECT_FALSE(kr_strbuf_reserve(&buf, SIZE_MAX));
+    EXPECT_FALSE(kr_strbuf_appendview(&buf, kr_strview_make("", SIZE_MAX)));
+    EXPECT_STREQ("foo", kr_strbuf_cstr(&buf));
+
+    kr_strbuf_free(&buf);
+}
+
+TEST(strbuf, kr_strbuf_detach)
+{
+    struct kr_strbuf_s buf;
+    char *str = NULL;
+    char expected[KR_CONFIG_STRBUFSMALL * 2];
+
+    kr_strbuf_init(&buf);
+
+    /* Small strings are copied out. */
+    EXPECT_TRUE(kr_strbuf_append(&buf, "foo"));
+    str = kr_strbuf_detach(&buf);
+    EXPECT_STREQ("foo", str);
+    EXPECT_STREQ("", kr_strbuf_cstr(&buf));
+    KR_FREE(str);
+
+    /* Heap strings are handed over. */
+    memset(expected, 'x', sizeof(expected) - 1);
+    expected[sizeof(expected) - 1] = '\0';
+    EXPECT_TRUE(kr_strbuf_append(&buf, expected));
+    str = kr_strbuf_detach(&buf);
+    EXPECT_STREQ(expected, str);
+    EXPECT_TRUE(buf.heap == NULL);
+    KR_FREE(str);
+
+    kr_strbuf_free(&buf);
+}
+
+SUITE(strbuf)
+{
+    SUITE_TEST(strbuf, kr_strbuf_append);
+    SUITE_TEST(strbuf, kr_strbuf_grow);
+    SUITE_TEST(strbuf, kr_strbuf_self);
+    SUITE_TEST(strbuf, kr_strbuf_reserve);
+    SUITE_TEST(strbuf, kr_strbuf_detach);
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2024 Lexi Mayfield
+ *
+ * Distributed under the Boost Software License, Version 1.0. (See
+ * accompanying file LICENSE.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "zztest.h"
+
+#include "krvec.h"
+
+/* Check that a vector of int holds exactly the given elements. */
+static bool vec_check(const struct kr_vec_s *vec, const int *expected, size_t len)
+{
+    size_t i = 0;
+
+    if (vec->len != len || vec->cap < len)
+    {
+        return false;
+    }
+    for (i = 0; i < len; i++)
+    {
+        if (KR_VEC_AT(int, vec, i) != expected[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(vec, kr_vec_push)
+{
+    struct kr_vec_s vec;
+    int i = 0, x = 0;
+    size_t caps = 0, cap = 0;
+    bool ok = true;
+
+    kr_vec_init(&vec, sizeof(int));
+    EXPECT_UINTEQ(0, vec.len);
+    EXPECT_FALSE(kr_vec_pop(&vec, &x));
+
+    /* Capacity only ever takes power-of-two steps. */
+    for (i = 0; i < 1000; i++)
+    {
+        int *p = KR_CASTS(int *, kr_vec_push(&vec, &i));
+        ok = ok && p != NULL && *p == i && kr_has_single_bit32(KR_CASTS(uint32_t, vec.cap));
+        if (vec.cap != cap)
+        {
+            cap = vec.cap;
+            caps += 1;
+        }
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_UINTEQ(1000, vec.len);
+    EXPECT_UINTEQ(1024, vec.cap);
+    EXPECT_UINTEQ(11, caps);
+    EXPECT_INTEQ(999, KR_VEC_AT(int, &vec, 999));
+    EXPECT_INTEQ(500, *KR_CASTS(int *, kr_vec_at(&vec, 500)));
+
+    EXPECT_TRUE(kr_vec_pop(&vec, &x));
+    EXPECT_INTEQ(999, x);
+    EXPECT_TRUE(kr_vec_pop(&vec, NULL));
+    EXPECT_UINTEQ(998, vec.len);
+
+    /* A new element can be filled in through the returned pointer. */
+    ASSERT_TRUE(kr_vec_push(&vec, NULL) != NULL);
+    KR_VEC_AT(int, &vec, 998) = -1;
+    EXPECT_INTEQ(-1, KR_VEC_AT(int, &vec, vec.len - 1));
+
+    kr_vec_clear(&vec);
+    EXPECT_UINTEQ(0, vec.len);
+    EXPECT_UINTEQ(1024, vec.cap);
+
+    kr_vec_free(&vec);
+    EXPECT_TRUE(vec.data == NULL);
+    EXPECT_UINTEQ(0, vec.cap);
+}
+
+TEST(vec, kr_vec_reserve)
+{
+    static const int expected[] = {1, 2, 3};
+    struct kr_vec_s vec;
+
+    kr_vec_init(&vec, sizeof(int));
+    EXPECT_TRUE(kr_vec_reserve(&vec, 0));
+    EXPECT_TRUE(vec.data == NULL);
+
+    EXPECT_TRUE(kr_vec_reserve(&vec, 100));
+    EXPECT_UINTEQ(128, vec.cap);
+    EXPECT_TRUE(kr_vec_reserve(&vec, 128));
+    EXPECT_UINTEQ(128, vec.cap);
+
+    /* Impossible sizes fail and leave the vector alone. */
+    EXPECT_FALSE(kr_vec_reserve(&vec, SIZE_MAX));
+    EXPECT_FALSE(kr_vec_reserve(&vec, SIZE_MAX / 2 + 2));
+    EXPECT_UINTEQ(128, vec.cap);
+
+    EXPECT_TRUE(kr_vec_append(&vec, expected, 3));
+    EXPECT_TRUE(kr_vec_shrink(&vec));
+    EXPECT_UINTEQ(3, vec.cap);
+    EXPECT_TRUE(vec_check(&vec, expected, 3));
+
+    /* Growing after a shrink goes back to a power of two. */
+    ASSERT_TRUE(kr_vec_push(&vec, &expected[0]) != NULL);
+    EXPECT_UINTEQ(4, vec.cap);
+
+    kr_vec_clear(&vec);
+    EXPECT_TRUE(kr_vec_shrink(&vec));
+    EXPECT_TRUE(vec.data == NULL);
+    EXPECT_UINTEQ(0, vec.cap);
+
+    kr_vec_free(&vec);
+}
+
+TEST(vec, kr_vec_insert)
+{
+    static const int a[] = {1, 2, 3, 4, 5};
+    static const int b[] = {10, 11};
+    static const int ex1[] = {10, 11, 1, 2, 3, 4, 5};
+    static const int ex2[] = {10, 11, 1, 2, 10, 11, 3, 4, 5};
+    static const int ex3[] = {10, 11, 1, 2, 10, 11, 3, 4, 5, 10, 11};
+    static const int ex4[] = {10, 2, 10, 11, 3, 4, 5, 10, 11};
+    static const int ex5[] = {10, 2, 10, 11, 3};
+    struct kr_vec_s vec;
+
+    kr_vec_init(&vec, sizeof(int));
+    EXPECT_TRUE(kr_vec_append(&vec, a, 5));
+    EXPECT_TRUE(vec_check(&vec, a, 5));
+    EXPECT_TRUE(kr_vec_append(&vec, NULL, 0));
+
+    EXPECT_TRUE(kr_vec_insert(&vec, 0, b, 2));
+    EXPECT_TRUE(vec_check(&vec, ex1, 7));
+    EXPECT_TRUE(kr_vec_insert(&vec, 4, b, 2));
+    EXPECT_TRUE(vec_check(&vec, ex2, 9));
+    EXPECT_TRUE(kr_vec_insert(&vec, 9, b, 2));
+    EXPECT_TRUE(vec_check(&vec, ex3, 11));
+    EXPECT_UINTEQ(16, vec.cap);
+
+    kr_vec_erase(&vec, 1, 2);
+    EXPECT_TRUE(vec_check(&vec, ex4, 9));
+    kr_vec_erase(&vec, 5, 4);
+    EXPECT_TRUE(vec_check(&vec, ex5, 5));
+    kr_vec_erase(&vec, 0, 0);
+    EXPECT_TRUE(vec_check(&vec, ex5, 5));
+    kr_vec_erase(&vec, 0, 5);
+    EXPECT_UINTEQ(0, vec.len);
+
+    /* Elements wider than a word move as a whole. */
+    kr_vec_free(&vec);
+    kr_vec_init(&vec, sizeof(ex1));
+    EXPECT_TRUE(kr_vec_append(&vec, ex1, 1));
+    EXPECT_TRUE(kr_vec_insert(&vec, 0, NULL, 1));
+    EXPECT_TRUE(memcmp(kr_vec_at(&vec, 1), ex1, sizeof(ex1)) == 0);
+
+    kr_vec_free(&vec);
+}
+
+SUITE(vec)
+{
+    SUITE_TEST(vec, kr_vec_push);
+    SUITE_TEST(vec, kr_vec_reserve);
+    SUITE_TEST(vec, kr_vec_insert);
+}
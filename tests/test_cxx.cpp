@@ -8,28 +8,58 @@
 
 #include "zztest.h"
 
+#include "t_arena.inl"
 #include "t_bit.inl"
+#include "t_bitset.inl"
 #include "t_bltin.inl"
+#include "t_cpu.inl"
+#include "t_crc.inl"
 #include "t_ctype.inl"
+#include "t_curve.inl"
+#include "t_dist.inl"
+#include "t_hash.inl"
 #include "t_int.inl"
+#include "t_intern.inl"
 #include "t_lib.inl"
 #include "t_limits.inl"
+#include "t_map.inl"
 #include "t_math.inl"
+#include "t_pool.inl"
 #include "t_rand.inl"
+#include "t_rank.inl"
+#include "t_ring.inl"
 #include "t_serial.inl"
+#include "t_simd.inl"
 #include "t_str.inl"
+#include "t_strbuf.inl"
+#include "t_vec.inl"
 
 int main()
 {
+    ADD_TEST_SUITE(arena);
     ADD_TEST_SUITE(bit);
+    ADD_TEST_SUITE(bitset);
     ADD_TEST_SUITE(bltin);
+    ADD_TEST_SUITE(cpu);
+    ADD_TEST_SUITE(crc);
     ADD_TEST_SUITE(ctype);
+    ADD_TEST_SUITE(curve);
+    ADD_TEST_SUITE(dist);
+    ADD_TEST_SUITE(hash);
     ADD_TEST_SUITE(int);
+    ADD_TEST_SUITE(intern);
     ADD_TEST_SUITE(lib);
     ADD_TEST_SUITE(limits);
+    ADD_TEST_SUITE(map);
     ADD_TEST_SUITE(math);
+    ADD_TEST_SUITE(pool);
     ADD_TEST_SUITE(rand);
+    ADD_TEST_SUITE(rank);
+    ADD_TEST_SUITE(ring);
     ADD_TEST_SUITE(serial);
+    ADD_TEST_SUITE(simd);
     ADD_TEST_SUITE(str);
+    ADD_TEST_SUITE(strbuf);
+    ADD_TEST_SUITE(vec);
     return RUN_TESTS();
 }